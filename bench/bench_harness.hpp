@@ -0,0 +1,200 @@
+#pragma once
+// Minimal self-contained benchmark harness: auto-calibrated batches,
+// repeated samples, mean/median with a 95% confidence interval, and a JSON
+// report for comparing runs across commits. Header-only, no dependencies.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+// Keeps the optimizer from discarding a computed value
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+struct Result {
+    std::string name;
+    long long param;
+    double itemsPerOp;
+    uint64_t iterationsPerSample;
+    int samples;
+    double meanNs;     // Per operation
+    double medianNs;
+    double minNs;
+    double maxNs;
+    double ci95Ns;     // Half-width of the 95% confidence interval of the mean
+};
+
+// A case runs `iterations` operations per call; setup happens outside timing
+struct Case {
+    std::string name;
+    long long param;
+    double itemsPerOp;
+    std::function<void()> setup;
+    std::function<void(uint64_t iterations)> run;
+};
+
+class Runner {
+private:
+    std::vector<Case> cases;
+    std::vector<Result> results;
+    std::string filter;
+    std::string jsonPath;
+    double minSampleMs = 10.0;
+    int sampleCount = 15;
+
+    // Two-sided 95% Student t quantiles for small sample counts
+    static double tQuantile95(int degreesOfFreedom) {
+        static const double table[] = { 0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+                                        2.262, 2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+                                        2.110, 2.101, 2.093, 2.086 };
+        if (degreesOfFreedom <= 0) return 0;
+        if (degreesOfFreedom <= 20) return table[degreesOfFreedom];
+        return 1.96;
+    }
+
+    static double timeBatch(const Case& c, uint64_t iterations) {
+        auto start = std::chrono::steady_clock::now();
+        c.run(iterations);
+        clobberMemory();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    Result measure(const Case& c) {
+        if (c.setup) c.setup();
+
+        // Grow the batch until one sample takes at least minSampleMs
+        uint64_t iterations = 1;
+        for (;;) {
+            double ns = timeBatch(c, iterations);
+            if (ns >= minSampleMs * 1e6 || iterations >= (1ull << 40)) break;
+            double scale = ns > 0 ? (minSampleMs * 1e6 * 1.2) / ns : 10.0;
+            iterations = std::max<uint64_t>(iterations + 1,
+                static_cast<uint64_t>(iterations * std::min(scale, 10.0)));
+        }
+
+        std::vector<double> perOp;
+        for (int i = 0; i < sampleCount; i++) {
+            perOp.push_back(timeBatch(c, iterations) / iterations);
+        }
+
+        Result r;
+        r.name = c.name;
+        r.param = c.param;
+        r.itemsPerOp = c.itemsPerOp;
+        r.iterationsPerSample = iterations;
+        r.samples = sampleCount;
+
+        double sum = 0;
+        for (double v : perOp) sum += v;
+        r.meanNs = sum / perOp.size();
+        double var = 0;
+        for (double v : perOp) var += (v - r.meanNs) * (v - r.meanNs);
+        var /= std::max<size_t>(perOp.size() - 1, 1);
+        r.ci95Ns = tQuantile95(static_cast<int>(perOp.size()) - 1) * std::sqrt(var / perOp.size());
+
+        std::sort(perOp.begin(), perOp.end());
+        r.medianNs = perOp[perOp.size() / 2];
+        r.minNs = perOp.front();
+        r.maxNs = perOp.back();
+        return r;
+    }
+
+    static void printResult(const Result& r) {
+        double itemsPerSec = r.itemsPerOp * 1e9 / r.meanNs;
+        std::printf("%-36s %8lld %14.1f ns/op  +-%5.1f%%  %12.3e items/s  (%llu x %d)\n",
+                    r.name.c_str(), r.param, r.meanNs, 100.0 * r.ci95Ns / r.meanNs, itemsPerSec,
+                    (unsigned long long)r.iterationsPerSample, r.samples);
+    }
+
+    static void writeJsonString(std::FILE* f, const std::string& s) {
+        std::fputc('"', f);
+        for (char ch : s) {
+            if (ch == '"' || ch == '\\') std::fputc('\\', f);
+            std::fputc(ch, f);
+        }
+        std::fputc('"', f);
+    }
+
+    bool writeJson(const char* benchName) const {
+        std::FILE* f = std::fopen(jsonPath.c_str(), "w");
+        if (!f) return false;
+
+        char date[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        std::fprintf(f, "{\n  \"context\": {\"suite\": ");
+        writeJsonString(f, benchName);
+        std::fprintf(f, ", \"date\": \"%s\", \"compiler\": ", date);
+        writeJsonString(f, __VERSION__);
+        std::fprintf(f, ", \"samples\": %d, \"min_sample_ms\": %.1f},\n  \"benchmarks\": [\n",
+                     sampleCount, minSampleMs);
+
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result& r = results[i];
+            std::fprintf(f, "    {\"name\": ");
+            writeJsonString(f, r.name);
+            std::fprintf(f, ", \"param\": %lld, \"iterations\": %llu, \"samples\": %d, "
+                         "\"ns_per_op\": %.3f, \"ns_per_op_ci95\": %.3f, \"median_ns_per_op\": %.3f, "
+                         "\"min_ns_per_op\": %.3f, \"max_ns_per_op\": %.3f, \"items_per_op\": %.1f, "
+                         "\"items_per_second\": %.1f}%s\n",
+                         r.param, (unsigned long long)r.iterationsPerSample, r.samples,
+                         r.meanNs, r.ci95Ns, r.medianNs, r.minNs, r.maxNs, r.itemsPerOp,
+                         r.itemsPerOp * 1e9 / r.meanNs, i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        return std::fclose(f) == 0;
+    }
+
+public:
+    // Options: --filter <substring>, --json <path>, --quick, --samples <n>
+    void parseArgs(int argc, char** argv) {
+        for (int i = 1; i < argc; i++) {
+            if (!std::strcmp(argv[i], "--filter") && i + 1 < argc) filter = argv[++i];
+            else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+            else if (!std::strcmp(argv[i], "--samples") && i + 1 < argc) sampleCount = std::max(2, std::atoi(argv[++i]));
+            else if (!std::strcmp(argv[i], "--quick")) { minSampleMs = 2.0; sampleCount = 5; }
+        }
+    }
+
+    void add(const std::string& name, long long param, double itemsPerOp,
+             std::function<void()> setup, std::function<void(uint64_t)> run) {
+        cases.push_back(Case{name, param, itemsPerOp, std::move(setup), std::move(run)});
+    }
+
+    int runAll(const char* benchName) {
+        std::printf("%-36s %8s %17s  %7s  %18s\n", "benchmark", "param", "time", "ci95", "throughput");
+        for (const Case& c : cases) {
+            if (!filter.empty() && c.name.find(filter) == std::string::npos) continue;
+            results.push_back(measure(c));
+            printResult(results.back());
+            std::fflush(stdout);
+        }
+
+        if (!jsonPath.empty()) {
+            if (!writeJson(benchName)) {
+                std::fprintf(stderr, "Failed to write %s\n", jsonPath.c_str());
+                return 1;
+            }
+            std::printf("Results written to %s\n", jsonPath.c_str());
+        }
+        return 0;
+    }
+};
+
+}
@@ -0,0 +1,140 @@
+#pragma once
+// Late-game GameManager scenarios and the scripted bot shared by the
+// stress and render benchmarks.
+#include "../include/game_manager.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace bench {
+
+const float TICK_DT = 1.0f / 60.0f;
+const int SNAPSHOTS_PER_SCENARIO = 8;
+const int SNAPSHOT_TICK_SPACING = 30;
+
+struct Scenario {
+    const char* name;
+    int wave;
+    int motherships;
+    int aliens;
+    int particles;
+};
+
+const Scenario SCENARIOS[] = {
+    { "wave5", 5, 4, 15, 500 },
+    { "wave20", 20, 12, 300, 5000 },
+    { "wave50", 50, 40, 2000, 50000 },
+};
+
+inline Vec2 randomOnScreen() {
+    return Vec2(rand() % WINDOW_WIDTH, rand() % WINDOW_HEIGHT);
+}
+
+inline void addScenarioParticle(GameManager& game) {
+    float angle = (rand() % 360) * PI / 180.0f;
+    float speed = 50.0f + rand() % 150;
+    float life = 1.0f + (rand() % 200) / 100.0f;
+    game.particles.insert(Particle(randomOnScreen(), Vec2(std::cos(angle) * speed, std::sin(angle) * speed),
+                                   life, Color(1.0f, 0.5f, 0.2f, 1.0f)));
+}
+
+inline void addScenarioAlien(GameManager& game, int wave) {
+    AlienType type = static_cast<AlienType>(rand() % 3);
+    Alien alien(randomOnScreen(), type, wave);
+    alien.spawnAnimation = 1.0f;
+    game.spawnAlien(alien);
+}
+
+inline void buildScenario(GameManager& game, const Scenario& s) {
+    game.reset();
+    game.wave = s.wave;
+    game.waveActive = true;
+
+    game.aliens.reserve(s.aliens * 2);
+    game.particles.reserve(s.particles * 2);
+    game.plasmas.reserve(1024);
+
+    for (int i = 0; i < s.motherships; i++) {
+        float x = (WINDOW_WIDTH / (s.motherships + 1.0f)) * (i + 1);
+        game.motherships.push_back(Mothership(Vec2(x, WINDOW_HEIGHT - 80 - rand() % 40), 1000));
+    }
+    for (int i = 0; i < s.aliens; i++) addScenarioAlien(game, s.wave);
+    for (int i = 0; i < s.particles; i++) addScenarioParticle(game);
+}
+
+// Keeps the entity population at the scenario level
+inline void refillScenario(GameManager& game, const Scenario& s) {
+    while ((int)game.aliens.size() < s.aliens) addScenarioAlien(game, s.wave);
+    while ((int)game.particles.size() < s.particles) addScenarioParticle(game);
+}
+
+// Scripted bot: circle-strafe, aim at the nearest alien, fire whenever
+// possible and reload when dry. Shields are topped up so a run always
+// lasts the full tick count.
+inline void driveBot(GameManager& game, int tick, Vec2& aim) {
+    Spacecraft& ship = game.spacecraft;
+    float t = tick * TICK_DT;
+    ship.velocity = Vec2(std::cos(t), std::sin(t)) * (SPACECRAFT_SPEED * 60.0f);
+
+    float bestDist = 1e30f;
+    for (const auto& alien : game.aliens) {
+        Vec2 diff = alien.position - ship.position;
+        float dist = diff.dot(diff);
+        if (dist < bestDist) {
+            bestDist = dist;
+            aim = alien.position;
+        }
+    }
+
+    if (ship.ammo == 0) ship.reload(game.score);
+    if (ship.shield.getPercentage() < 0.5f) ship.shield = ShieldSystem();
+    game.gameState = GameState::PLAYING;
+}
+
+// The same bot as a remote player: input for the ship it sees in a client's
+// view. start asks for the next wave (or a new game) whenever there is none.
+inline ShipInput botShipInput(const GameManager& view, int player, int tick, bool& start) {
+    const Spacecraft& ship = view.spacecraft;
+    float t = tick * TICK_DT + player * 0.8f;
+    ShipInput input{Vec2(std::cos(t), std::sin(t)) * (SPACECRAFT_SPEED * 60.0f), ship.position + Vec2(100, 0),
+                    true, ship.ammo == 0};
+    float bestDist = 1e30f;
+    for (const auto& alien : view.aliens) {
+        Vec2 diff = alien.position - ship.position;
+        float dist = diff.dot(diff);
+        if (dist < bestDist) {
+            bestDist = dist;
+            input.aimTarget = alien.position;
+        }
+    }
+    start = view.gameState != GameState::PLAYING || !view.waveActive;
+    return input;
+}
+
+// The title screen: no entities, just the menu over the starfield. A fresh
+// game starts out PLAYING, so the state has to be set.
+inline std::vector<GameManager> menuSnapshots() {
+    std::vector<GameManager> games(1);
+    games[0].gameState = GameState::MENU;
+    return games;
+}
+
+// Runs the scenario with the scripted bot and keeps periodic copies of
+// the whole game state, so every run replays identical frames
+inline std::vector<GameManager> recordSnapshots(const Scenario& s) {
+    srand(1337);
+    GameManager game;
+    buildScenario(game, s);
+
+    std::vector<GameManager> snapshots;
+    Vec2 aim(WINDOW_WIDTH / 2.0f, WINDOW_HEIGHT / 2.0f);
+    for (int tick = 0; (int)snapshots.size() < SNAPSHOTS_PER_SCENARIO; tick++) {
+        refillScenario(game, s);
+        driveBot(game, tick, aim);
+        game.update(TICK_DT, aim, true);
+        if (tick % SNAPSHOT_TICK_SPACING == SNAPSHOT_TICK_SPACING - 1) snapshots.push_back(game);
+    }
+    return snapshots;
+}
+
+}
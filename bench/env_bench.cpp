@@ -0,0 +1,125 @@
+// Vectorized environment benchmark: steps a batch of games with random
+// actions and reports environment steps per second, overall and per
+// thread. Also checks that the results don't depend on the thread count.
+// Usage: env_bench [--envs N] [--threads N] [--steps N] [--frame-skip N] [--json results.json]
+#include "../include/logger.hpp"
+#include "../include/vec_env.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+    struct RunResult {
+        int threads;
+        double seconds;
+        double stepsPerSecond;
+        uint64_t episodes;
+        double meanReward;
+        uint64_t checksum;  // Over every observation, reward and done
+    };
+
+    // Wanders, aims anywhere, fires most of the time and reloads when dry
+    void randomActions(Rng& rng, const float* observations, int envCount, float* actions) {
+        for (int i = 0; i < envCount; i++) {
+            float* a = actions + static_cast<size_t>(i) * ENV_ACTION_SIZE;
+            a[ENV_ACTION_MOVE_X] = rng.nextInt(201) / 100.0f - 1.0f;
+            a[ENV_ACTION_MOVE_Y] = rng.nextInt(201) / 100.0f - 1.0f;
+            a[ENV_ACTION_AIM_X] = rng.nextInt(201) / 100.0f - 1.0f;
+            a[ENV_ACTION_AIM_Y] = rng.nextInt(201) / 100.0f - 1.0f;
+            a[ENV_ACTION_FIRE] = rng.nextInt(10) < 8 ? 1.0f : 0.0f;
+            a[ENV_ACTION_RELOAD] = observations[static_cast<size_t>(i) * ENV_OBSERVATION_SIZE + OBS_AMMO] == 0 ? 1.0f : 0.0f;
+        }
+    }
+
+    void mix(uint64_t& hash, const void* data, size_t bytes) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < bytes; i++) hash = (hash ^ p[i]) * 1099511628211ull;
+    }
+
+    RunResult run(int envCount, int threads, int steps, const EnvConfig& config, bool hashOutputs) {
+        VecEnv env(envCount, threads, config);
+        std::vector<float> observations(static_cast<size_t>(envCount) * ENV_OBSERVATION_SIZE);
+        std::vector<float> actions(static_cast<size_t>(envCount) * ENV_ACTION_SIZE);
+        std::vector<float> rewards(envCount);
+        std::vector<uint8_t> dones(envCount);
+
+        Rng policy(7);
+        env.reset(42, observations.data());
+
+        RunResult r;
+        r.threads = env.getThreadCount();
+        r.episodes = 0;
+        r.checksum = 1469598103934665603ull;
+        double rewardSum = 0, seconds = 0;
+        for (int step = 0; step < steps; step++) {
+            randomActions(policy, observations.data(), envCount, actions.data());
+            auto start = std::chrono::steady_clock::now();
+            env.step(actions.data(), observations.data(), rewards.data(), dones.data());
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            for (int i = 0; i < envCount; i++) {
+                rewardSum += rewards[i];
+                if (dones[i]) r.episodes++;
+            }
+            if (hashOutputs) {
+                mix(r.checksum, observations.data(), observations.size() * sizeof(float));
+                mix(r.checksum, rewards.data(), rewards.size() * sizeof(float));
+                mix(r.checksum, dones.data(), dones.size());
+            }
+        }
+        r.seconds = seconds;
+        r.stepsPerSecond = static_cast<double>(envCount) * steps / seconds;
+        r.meanReward = rewardSum / (static_cast<double>(envCount) * steps);
+        return r;
+    }
+}
+
+int main(int argc, char** argv) {
+    int envCount = 1024;
+    int threads = 0;
+    int steps = 1000;
+    EnvConfig config;
+    const char* jsonPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--envs") && i + 1 < argc) envCount = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--steps") && i + 1 < argc) steps = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--frame-skip") && i + 1 < argc) config.frameSkip = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+    }
+    getLogger().setMinLevel(LogLevel::WARN);
+
+    // Same seeds on one thread and on several: every output must match
+    int checkSteps = std::min(steps, 200);
+    RunResult single = run(envCount, 1, checkSteps, config, true);
+    RunResult multi = run(envCount, std::max(threads, 4), checkSteps, config, true);
+    bool deterministic = single.checksum == multi.checksum;
+
+    RunResult r = run(envCount, threads, steps, config, false);
+    double ticksPerStep = config.frameSkip;
+    std::printf("VecEnv: %d envs, %d threads, %d steps, frame skip %d, observation %d floats\n",
+                envCount, r.threads, steps, config.frameSkip, ENV_OBSERVATION_SIZE);
+    std::printf("  %.0f env steps/s (%.0f per thread), %.0f game ticks/s, %.2f us per env step per thread\n",
+                r.stepsPerSecond, r.stepsPerSecond / r.threads, r.stepsPerSecond * ticksPerStep,
+                r.threads * 1e6 / r.stepsPerSecond);
+    std::printf("  %llu episodes finished, mean reward per step %.4f\n", (unsigned long long)r.episodes, r.meanReward);
+    std::printf("  1 vs %d threads: %s\n", multi.threads, deterministic ? "identical outputs" : "OUTPUTS DIFFER");
+
+    if (jsonPath) {
+        std::FILE* f = std::fopen(jsonPath, "w");
+        if (!f) {
+            std::fprintf(stderr, "Failed to write %s\n", jsonPath);
+            return 1;
+        }
+        std::fprintf(f, "{\n  \"suite\": \"env_bench\",\n  \"envs\": %d,\n  \"threads\": %d,\n  \"steps\": %d,\n"
+                     "  \"frame_skip\": %d,\n  \"steps_per_second\": %.0f,\n  \"steps_per_second_per_thread\": %.0f,\n"
+                     "  \"episodes\": %llu,\n  \"deterministic\": %s\n}\n",
+                     envCount, r.threads, steps, config.frameSkip, r.stepsPerSecond, r.stepsPerSecond / r.threads,
+                     (unsigned long long)r.episodes, deterministic ? "true" : "false");
+        std::fclose(f);
+    }
+    return deterministic ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+// Match density benchmark: a MatchHost full of co-op matches, each played
+// by bot clients over localhost, ticked on a simulated 60 Hz clock. The
+// host's per-match CPU accounting gives the cost of a match tick; process
+// CPU time around each host tick adds the epoll and thread pool overhead.
+// Together they give how many matches one core keeps at 60 Hz.
+// Usage: match_bench [--scenario name] [--matches N] [--players N] [--threads N] [--seconds S]
+//                    [--json results.json]
+#include "bench_scenarios.hpp"
+#include "../include/logger.hpp"
+#include "../include/match_host.hpp"
+#include "../include/net_client.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    using namespace bench;
+
+    const uint64_t TICK_NS = 1000000000ull / 60;
+    const double TICK_BUDGET_US = 1e6 / 60.0;
+    const int WARMUP_TICKS = 30;
+    const int DENSE_ALIENS = 1000;  // Scenarios this busy only run when asked for by name
+
+    struct ScenarioResult {
+        std::string name;
+        int matches;
+        int players;
+        int threads;
+        int ticks;
+        double matchUs;           // Accounted CPU per match tick
+        double peakMatchUs;       // Slowest single match tick
+        double hostUs;            // Process CPU per host tick, every thread
+        double hostPerMatchUs;
+        double matchesPerCore;
+        uint64_t undecodable;
+        bool allJoined;
+    };
+
+    uint64_t processCpuNs() {
+        timespec now;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+        return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + now.tv_nsec;
+    }
+
+    ScenarioResult runScenario(Scenario s, int matchCount, int players, int threads, int ticks) {
+        // The server doesn't replicate or spawn particles
+        s.particles = 0;
+        srand(1337);
+        MatchHostConfig config;
+        config.basePort = 0;
+        MatchHost host(matchCount, threads, config);
+        ScenarioResult r = ScenarioResult();
+        if (!host.start()) return r;
+        for (int i = 0; i < matchCount; i++) buildScenario(host.getGame(i), s);
+
+        uint64_t nowNs = TICK_NS;
+        std::vector<std::unique_ptr<NetClient>> clients;
+        for (int i = 0; i < matchCount; i++) {
+            for (int p = 0; p < players; p++) {
+                clients.emplace_back(new NetClient(LinkConditions(), i * MAX_PLAYERS + p + 1));
+                clients.back()->connect(NetAddress(NET_LOCALHOST, host.getPort(i)), nowNs);
+            }
+        }
+
+        r.name = s.name;
+        r.matches = matchCount;
+        r.players = players;
+        r.threads = host.getThreadCount();
+        r.ticks = ticks;
+        uint64_t hostCpuNs = 0;
+
+        for (int tick = -WARMUP_TICKS; tick < ticks; tick++) {
+            if (tick == 0) host.resetStats();
+            nowNs += TICK_NS;
+            for (std::unique_ptr<NetClient>& client : clients) {
+                client->receive(nowNs);
+                bool start = false;
+                ShipInput input = botShipInput(client->getGame(), client->getPlayer(), tick, start);
+                client->sendInput(input, start, nowNs);
+            }
+            // Keeps every fight at the scenario's size for the whole run
+            for (int i = 0; i < matchCount; i++) {
+                GameManager& game = host.getGame(i);
+                refillScenario(game, s);
+                for (int player = 0; player < game.getShipCount(); player++) {
+                    Spacecraft& ship = game.getShip(player);
+                    if (ship.isAlive() && ship.shield.getPercentage() < 0.5f) ship.shield = ShieldSystem();
+                }
+                game.gameState = GameState::PLAYING;
+            }
+
+            uint64_t start = processCpuNs();
+            host.tick(nowNs);
+            if (tick >= 0) hostCpuNs += processCpuNs() - start;
+        }
+
+        uint64_t matchNs = 0, matchTicks = 0, peakNs = 0;
+        for (int i = 0; i < matchCount; i++) {
+            const MatchStats& stats = host.getMatchStats(i);
+            matchNs += stats.cpuNs;
+            matchTicks += stats.ticks;
+            peakNs = std::max(peakNs, stats.peakTickNs);
+        }
+        r.matchUs = matchTicks ? matchNs / 1000.0 / matchTicks : 0;
+        r.peakMatchUs = peakNs / 1000.0;
+        r.hostUs = hostCpuNs / 1000.0 / ticks;
+        r.hostPerMatchUs = r.hostUs / matchCount;
+        r.matchesPerCore = r.hostPerMatchUs > 0 ? TICK_BUDGET_US / r.hostPerMatchUs : 0;
+        r.allJoined = host.getPlayerCount() == matchCount * players;
+        for (const std::unique_ptr<NetClient>& client : clients) {
+            r.undecodable += client->getStats().undecodable;
+            if (!client->getNewestState()) r.allJoined = false;
+        }
+        return r;
+    }
+
+    bool writeJson(const char* path, const std::vector<ScenarioResult>& results) {
+        std::FILE* f = std::fopen(path, "w");
+        if (!f) return false;
+        std::fprintf(f, "{\n  \"suite\": \"match_bench\",\n  \"tick_hz\": 60,\n  \"scenarios\": [\n");
+        for (size_t i = 0; i < results.size(); i++) {
+            const ScenarioResult& r = results[i];
+            std::fprintf(f, "    {\"name\": \"%s\", \"matches\": %d, \"players\": %d, \"threads\": %d, \"ticks\": %d, "
+                         "\"match_us\": %.2f, \"peak_match_us\": %.2f, \"host_us\": %.1f, "
+                         "\"host_per_match_us\": %.2f, \"matches_per_core\": %.1f, \"undecodable\": %llu, "
+                         "\"all_joined\": %s}%s\n",
+                         r.name.c_str(), r.matches, r.players, r.threads, r.ticks, r.matchUs, r.peakMatchUs,
+                         r.hostUs, r.hostPerMatchUs, r.matchesPerCore,
+                         static_cast<unsigned long long>(r.undecodable), r.allJoined ? "true" : "false",
+                         i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        return std::fclose(f) == 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    int matchCount = 200;
+    int players = 2;
+    int threads = 0;
+    float seconds = 3.0f;
+    const char* only = nullptr;
+    const char* jsonPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--matches") && i + 1 < argc) matchCount = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--players") && i + 1 < argc) players = std::max(1, std::min(std::atoi(argv[++i]), MAX_PLAYERS));
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = std::max(0.1f, static_cast<float>(std::atof(argv[++i])));
+        else if (!std::strcmp(argv[i], "--scenario") && i + 1 < argc) only = argv[++i];
+        else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+    }
+    getLogger().setMinLevel(LogLevel::WARN);
+    int ticks = static_cast<int>(seconds * 60.0f);
+
+    std::vector<ScenarioResult> results;
+    bool ok = true;
+    std::printf("Match density: %d matches of %d player%s, %.1f s at 60 Hz per scenario\n", matchCount, players,
+                players == 1 ? "" : "s", seconds);
+    std::printf("%-8s %8s %9s %11s %10s %14s %14s  check\n", "scenario", "threads", "match us", "peak us",
+                "host us", "host/match us", "matches/core");
+    for (const Scenario& s : SCENARIOS) {
+        if (only ? std::strcmp(only, s.name) != 0 : s.aliens > DENSE_ALIENS) continue;
+        ScenarioResult r = runScenario(s, matchCount, players, threads, ticks);
+        if (r.name.empty()) {
+            std::fprintf(stderr, "Failed to open %d UDP sockets\n", matchCount);
+            return 1;
+        }
+        bool passed = r.allJoined && r.undecodable == 0;
+        std::printf("%-8s %8d %9.2f %11.2f %10.1f %14.2f %14.1f  %s\n", r.name.c_str(), r.threads, r.matchUs,
+                    r.peakMatchUs, r.hostUs, r.hostPerMatchUs, r.matchesPerCore,
+                    passed ? "ok" : "FAILED (players missing or undecodable snapshots)");
+        ok = ok && passed;
+        results.push_back(r);
+    }
+
+    if (jsonPath && !writeJson(jsonPath, results)) {
+        std::fprintf(stderr, "Failed to write %s\n", jsonPath);
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+// Microbenchmarks for the simulation hot paths, swept over entity counts.
+// Usage: micro_bench [--filter name] [--json results.json] [--quick]
+#include "bench_harness.hpp"
+#include "../include/collision.hpp"
+#include "../include/game_manager.hpp"
+#include "../include/logger.hpp"
+#include <cstdlib>
+#include <memory>
+
+namespace {
+    Vec2 randomPosition() {
+        return Vec2(rand() % WINDOW_WIDTH, rand() % WINDOW_HEIGHT);
+    }
+
+    void addCollisionBenchmarks(bench::Runner& runner) {
+        for (int pairs : {64, 1024, 16384}) {
+            auto positions = std::make_shared<std::vector<Vec2>>();
+            runner.add("detectCollision", pairs, pairs,
+                [=]() {
+                    positions->clear();
+                    for (int i = 0; i < pairs * 2; i++) positions->push_back(randomPosition());
+                },
+                [=](uint64_t iterations) {
+                    const std::vector<Vec2>& p = *positions;
+                    for (uint64_t it = 0; it < iterations; it++) {
+                        int hits = 0;
+                        for (int i = 0; i < pairs; i++) {
+                            hits += detectCollision(p[2 * i], PLASMA_RADIUS, p[2 * i + 1], ALIEN_RADIUS).hasCollision;
+                        }
+                        bench::doNotOptimize(hits);
+                    }
+                });
+        }
+    }
+
+    void addAlienBenchmarks(bench::Runner& runner) {
+        for (int count : {100, 1000, 10000}) {
+            auto aliens = std::make_shared<std::vector<Alien>>();
+            runner.add("Alien::update", count, count,
+                [=]() {
+                    aliens->clear();
+                    for (int i = 0; i < count; i++) {
+                        aliens->push_back(Alien(randomPosition(), static_cast<AlienType>(i % 3), 1));
+                    }
+                },
+                [=](uint64_t iterations) {
+                    Vec2 player(WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2);
+                    for (uint64_t it = 0; it < iterations; it++) {
+                        for (auto& alien : *aliens) alien.update(1.0f / 60.0f, player);
+                        bench::clobberMemory();
+                    }
+                });
+        }
+
+        for (int count : {100, 1000, 10000}) {
+            auto aliens = std::make_shared<std::vector<Alien>>();
+            int segments = 0;
+            for (int i = 0; i < count; i++) segments += ((i % 3) == 2 ? 6 : 4) * TENTACLE_SEGMENTS;
+            runner.add("Tentacle::getSegmentPosition", count, segments,
+                [=]() {
+                    aliens->clear();
+                    for (int i = 0; i < count; i++) {
+                        Alien alien(randomPosition(), static_cast<AlienType>(i % 3), 1);
+                        alien.animationTime = (rand() % 1000) / 100.0f;
+                        aliens->push_back(alien);
+                    }
+                },
+                [=](uint64_t iterations) {
+                    for (uint64_t it = 0; it < iterations; it++) {
+                        float sum = 0;
+                        for (const auto& alien : *aliens) {
+                            for (const auto& tentacle : alien.getTentacles()) {
+                                for (int s = 0; s < tentacle.getSegmentCount(); s++) {
+                                    Vec2 p = tentacle.getSegmentPosition(s, alien.animationTime + it * 0.016f);
+                                    sum += p.x + p.y;
+                                }
+                            }
+                        }
+                        bench::doNotOptimize(sum);
+                    }
+                });
+        }
+    }
+
+    void addParticleBenchmarks(bench::Runner& runner) {
+        for (int count : {1000, 10000, 100000}) {
+            auto particles = std::make_shared<std::vector<Particle>>();
+            runner.add("Particle::update", count, count,
+                [=]() {
+                    particles->clear();
+                    for (int i = 0; i < count; i++) {
+                        particles->push_back(Particle(randomPosition(), Vec2(rand() % 200 - 100, rand() % 200 - 100),
+                                                      1e9f, Color(1, 1, 1, 1)));
+                    }
+                },
+                [=](uint64_t iterations) {
+                    for (uint64_t it = 0; it < iterations; it++) {
+                        for (auto& particle : *particles) particle.update(1.0f / 60.0f);
+                        bench::clobberMemory();
+                    }
+                });
+        }
+    }
+
+    void addShieldBenchmarks(bench::Runner& runner) {
+        auto shield = std::make_shared<ShieldSystem>();
+        runner.add("ShieldSystem::absorbDamage", 1, 1,
+            [=]() { *shield = ShieldSystem(); },
+            [=](uint64_t iterations) {
+                float bleed = 0;
+                for (uint64_t it = 0; it < iterations; it++) {
+                    // Regenerate now and then so both the absorb and bleed-through paths run
+                    if ((it & 127) == 0) *shield = ShieldSystem();
+                    bleed += shield->absorbDamage(1.5f);
+                }
+                bench::doNotOptimize(bleed);
+            });
+    }
+
+    // Full plasma x alien and ship x alien scan with nothing colliding, which
+    // is the common case and keeps the state unchanged between iterations
+    void addCheckCollisionsBenchmarks(bench::Runner& runner) {
+        for (int count : {100, 1000, 4000}) {
+            int plasmaCount = 64;
+            auto game = std::make_shared<GameManager>();
+            runner.add("GameManager::checkCollisions", count, (double)count * (plasmaCount + 1),
+                [=]() {
+                    game->reset();
+                    game->spacecraft.position = Vec2(WINDOW_WIDTH / 2, 40);
+                    for (int i = 0; i < count; i++) {
+                        Alien alien(Vec2(rand() % WINDOW_WIDTH, 400 + rand() % 400), AlienType::SCOUT, 1);
+                        alien.spawnAnimation = 1.0f;
+                        game->spawnAlien(alien);
+                    }
+                    for (int i = 0; i < plasmaCount; i++) {
+                        game->plasmas.insert(Plasma(Vec2(rand() % WINDOW_WIDTH, 150 + rand() % 100), Vec2(0, 0)));
+                    }
+                },
+                [=](uint64_t iterations) {
+                    for (uint64_t it = 0; it < iterations; it++) {
+                        game->checkCollisions();
+                        bench::clobberMemory();
+                    }
+                });
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    srand(1234);
+    getLogger().setMinLevel(LogLevel::WARN);
+
+    bench::Runner runner;
+    runner.parseArgs(argc, argv);
+    addCollisionBenchmarks(runner);
+    addAlienBenchmarks(runner);
+    addParticleBenchmarks(runner);
+    addShieldBenchmarks(runner);
+    addCheckCollisionsBenchmarks(runner);
+    return runner.runAll("micro_bench");
+}
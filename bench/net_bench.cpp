@@ -0,0 +1,255 @@
+// Co-op netcode benchmark: a dedicated NetServer and a full house of
+// NetClients on localhost, driven by a simulated clock through a link with
+// latency, jitter and loss. Reports bandwidth per client, delta snapshot
+// size against a full one and packets per snapshot, server tick cost split
+// into networking and simulation, client prediction error, and packets the
+// sockets refused. Every state a client decodes is
+// checked against what the server sent.
+// Usage: net_bench [--scenario name] [--players N] [--seconds S] [--latency ms] [--jitter ms]
+//                  [--loss percent] [--json results.json]
+#include "bench_scenarios.hpp"
+#include "../include/logger.hpp"
+#include "../include/net_client.hpp"
+#include "../include/net_server.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    using namespace bench;
+
+    const uint64_t TICK_NS = 1000000000ull / 60;
+    const int WARMUP_TICKS = 60;     // Joining and the first full snapshots stay out of the numbers
+    const int UDP_OVERHEAD = 28;     // IPv4 and UDP headers per packet
+
+    struct ScenarioResult {
+        std::string name;
+        int players;
+        int ticks;
+        size_t entities;
+        double downKbps;             // Per client
+        double upKbps;
+        double deltaBytes;           // Average snapshot payload
+        double packetsPerSnapshot;
+        double fullBytes;            // The same states without a baseline
+        double fullShare;            // Snapshots that went out without one
+        double receiveUs;            // Server, per tick
+        double updateUs;
+        double sendUs;
+        double predictionError;      // Average over clients, pixels
+        float maxPredictionError;
+        uint64_t inputsMissed;
+        uint64_t undecodable;
+        uint64_t incomplete;         // Split snapshots with a part lost
+        uint64_t sendFailures;       // Server and clients
+        uint64_t statesChecked;
+        uint64_t mismatches;
+    };
+
+    double elapsedUs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    ScenarioResult runScenario(const Scenario& s, int players, int ticks, const LinkConditions& link) {
+        srand(1337);
+        GameManager game;
+        game.logEvents = false;
+        buildScenario(game, s);
+
+        NetServerConfig config;
+        config.hostPlayer = false;
+        config.link = link;
+        NetServer server(game, config);
+        std::vector<std::unique_ptr<NetClient>> clients;
+        if (!server.start(0)) return ScenarioResult();
+
+        uint64_t nowNs = TICK_NS;
+        for (int i = 0; i < players; i++) {
+            clients.emplace_back(new NetClient(link, 100 + i));
+            clients.back()->connect(NetAddress(NET_LOCALHOST, server.getPort()), nowNs);
+        }
+
+        ScenarioResult r = ScenarioResult();
+        r.name = s.name;
+        r.players = players;
+        r.ticks = ticks;
+        NetServerStats startStats;
+        std::vector<NetClientStats> startClientStats(players);
+        std::vector<uint32_t> checkedTicks(players, 0);
+        NetWriter full;
+        size_t entities = 0;
+
+        for (int tick = -WARMUP_TICKS; tick < ticks; tick++) {
+            if (tick == 0) {
+                startStats = server.getStats();
+                for (int i = 0; i < players; i++) startClientStats[i] = clients[i]->getStats();
+            }
+            bool measuring = tick >= 0;
+            nowNs += TICK_NS;
+
+            for (int i = 0; i < players; i++) {
+                NetClient& client = *clients[i];
+                client.receive(nowNs);
+                const NetState* state = client.getNewestState();
+                if (measuring && state && state->tick != checkedTicks[i]) {
+                    checkedTicks[i] = state->tick;
+                    if (const NetState* sent = server.getHistory(state->tick)) {
+                        r.statesChecked++;
+                        if (*sent != *state) r.mismatches++;
+                    }
+                }
+                bool start = false;
+                ShipInput input = botShipInput(client.getGame(), client.getPlayer(), tick, start);
+                client.sendInput(input, start, nowNs);
+            }
+
+            // Keeps the fight going at the scenario's size for the whole run
+            refillScenario(game, s);
+            for (int player = 0; player < game.getShipCount(); player++) {
+                Spacecraft& ship = game.getShip(player);
+                if (ship.isAlive() && ship.shield.getPercentage() < 0.5f) ship.shield = ShieldSystem();
+            }
+            game.gameState = GameState::PLAYING;
+
+            auto start = std::chrono::steady_clock::now();
+            server.receive(nowNs);
+            server.applyInputs();
+            double receiveUs = elapsedUs(start);
+            start = std::chrono::steady_clock::now();
+            game.update(NET_TICK_SECONDS, server.getPlayerZeroInput().aimTarget, server.getPlayerZeroInput().shooting);
+            double updateUs = elapsedUs(start);
+            start = std::chrono::steady_clock::now();
+            server.sendSnapshots(nowNs);
+            double sendUs = elapsedUs(start);
+
+            if (!measuring) continue;
+            r.receiveUs += receiveUs;
+            r.updateUs += updateUs;
+            r.sendUs += sendUs;
+            const NetState* sent = server.getHistory(server.getTick());
+            if (sent) {
+                full.clear();
+                encodeNetState(*sent, nullptr, full);
+                r.fullBytes += full.getSize();
+                for (int section = 0; section < NET_SECTION_COUNT; section++) entities += sent->sections[section].size();
+            }
+        }
+
+        double seconds = ticks * NET_TICK_SECONDS;
+        const NetServerStats& stats = server.getStats();
+        uint64_t snapshots = stats.snapshots - startStats.snapshots;
+        uint64_t snapshotBytes = stats.snapshotBytes - startStats.snapshotBytes;
+        uint64_t snapshotPackets = stats.snapshotPackets - startStats.snapshotPackets;
+        r.entities = entities / std::max(1, ticks);
+        r.downKbps = (snapshotBytes + snapshotPackets * UDP_OVERHEAD) * 8.0 / 1000.0 / seconds / players;
+        r.deltaBytes = snapshots ? static_cast<double>(snapshotBytes) / snapshots : 0;
+        r.packetsPerSnapshot = snapshots ? static_cast<double>(snapshotPackets) / snapshots : 0;
+        r.fullBytes /= std::max(1, ticks);
+        r.fullShare = snapshots ? static_cast<double>(stats.fullSnapshots - startStats.fullSnapshots) / snapshots : 0;
+        r.receiveUs /= ticks;
+        r.updateUs /= ticks;
+        r.sendUs /= ticks;
+        r.inputsMissed = stats.inputsMissed - startStats.inputsMissed;
+        r.sendFailures = stats.sendFailures - startStats.sendFailures;
+
+        uint64_t upBytes = 0, samples = 0;
+        double errorSum = 0;
+        for (int i = 0; i < players; i++) {
+            const NetClientStats& c = clients[i]->getStats();
+            upBytes += (c.inputBytes - startClientStats[i].inputBytes) +
+                       (c.inputPackets - startClientStats[i].inputPackets) * UDP_OVERHEAD;
+            samples += c.predictionSamples - startClientStats[i].predictionSamples;
+            errorSum += c.predictionErrorSum - startClientStats[i].predictionErrorSum;
+            r.maxPredictionError = std::max(r.maxPredictionError, c.maxPredictionError);
+            r.undecodable += c.undecodable - startClientStats[i].undecodable;
+            r.incomplete += c.incompleteSnapshots - startClientStats[i].incompleteSnapshots;
+            r.sendFailures += c.sendFailures - startClientStats[i].sendFailures;
+        }
+        r.upKbps = upBytes * 8.0 / 1000.0 / seconds / players;
+        r.predictionError = samples ? errorSum / samples : 0;
+        return r;
+    }
+
+    bool writeJson(const char* path, const std::vector<ScenarioResult>& results, const LinkConditions& link) {
+        std::FILE* f = std::fopen(path, "w");
+        if (!f) return false;
+        std::fprintf(f, "{\n  \"suite\": \"net_bench\",\n  \"latency_ms\": %.1f,\n  \"jitter_ms\": %.1f,\n"
+                     "  \"loss_percent\": %.1f,\n  \"scenarios\": [\n", link.latencyMs, link.jitterMs, link.lossPercent);
+        for (size_t i = 0; i < results.size(); i++) {
+            const ScenarioResult& r = results[i];
+            std::fprintf(f, "    {\"name\": \"%s\", \"players\": %d, \"ticks\": %d, \"entities\": %zu, "
+                         "\"down_kbps_per_client\": %.1f, \"up_kbps_per_client\": %.1f, \"delta_bytes\": %.1f, "
+                         "\"packets_per_snapshot\": %.2f, \"full_bytes\": %.1f, \"full_share\": %.4f, \"server_receive_us\": %.2f, "
+                         "\"server_update_us\": %.2f, \"server_send_us\": %.2f, \"prediction_error_px\": %.3f, "
+                         "\"max_prediction_error_px\": %.3f, \"inputs_missed\": %llu, \"undecodable\": %llu, "
+                         "\"incomplete\": %llu, \"send_failures\": %llu, \"states_checked\": %llu, \"mismatches\": %llu}%s\n",
+                         r.name.c_str(), r.players, r.ticks, r.entities, r.downKbps, r.upKbps, r.deltaBytes,
+                         r.packetsPerSnapshot, r.fullBytes, r.fullShare, r.receiveUs, r.updateUs, r.sendUs, r.predictionError,
+                         r.maxPredictionError, static_cast<unsigned long long>(r.inputsMissed),
+                         static_cast<unsigned long long>(r.undecodable),
+                         static_cast<unsigned long long>(r.incomplete),
+                         static_cast<unsigned long long>(r.sendFailures),
+                         static_cast<unsigned long long>(r.statesChecked),
+                         static_cast<unsigned long long>(r.mismatches), i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        return std::fclose(f) == 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    int players = MAX_PLAYERS;
+    float seconds = 10.0f;
+    LinkConditions link;
+    link.latencyMs = 50.0f;
+    link.jitterMs = 10.0f;
+    link.lossPercent = 5.0f;
+    const char* only = nullptr;
+    const char* jsonPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--players") && i + 1 < argc) players = std::max(1, std::min(std::atoi(argv[++i]), MAX_PLAYERS));
+        else if (!std::strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = std::max(0.1f, static_cast<float>(std::atof(argv[++i])));
+        else if (!std::strcmp(argv[i], "--latency") && i + 1 < argc) link.latencyMs = static_cast<float>(std::atof(argv[++i]));
+        else if (!std::strcmp(argv[i], "--jitter") && i + 1 < argc) link.jitterMs = static_cast<float>(std::atof(argv[++i]));
+        else if (!std::strcmp(argv[i], "--loss") && i + 1 < argc) link.lossPercent = static_cast<float>(std::atof(argv[++i]));
+        else if (!std::strcmp(argv[i], "--scenario") && i + 1 < argc) only = argv[++i];
+        else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+    }
+    getLogger().setMinLevel(LogLevel::WARN);
+    int ticks = static_cast<int>(seconds * 60.0f);
+
+    std::vector<ScenarioResult> results;
+    bool ok = true;
+    std::printf("Co-op netcode: %d player%s, %.0f ms latency, %.0f ms jitter, %.1f%% loss, %.1f s per scenario\n",
+                players, players == 1 ? "" : "s", link.latencyMs, link.jitterMs, link.lossPercent, seconds);
+    std::printf("%-8s %8s %10s %8s %9s %5s %9s %6s %9s %9s %9s %9s %9s  states\n", "scenario", "entities",
+                "down kbps", "up kbps", "delta B", "pkts", "full B", "full%", "recv us", "update us", "send us",
+                "pred px", "max px");
+    for (const Scenario& s : SCENARIOS) {
+        if (only && std::strcmp(only, s.name)) continue;
+        ScenarioResult r = runScenario(s, players, ticks, link);
+        if (r.name.empty()) {
+            std::fprintf(stderr, "Failed to open a UDP socket\n");
+            return 1;
+        }
+        std::printf("%-8s %8zu %10.1f %8.1f %9.1f %5.2f %9.1f %5.1f%% %9.2f %9.2f %9.2f %9.3f %9.3f  "
+                    "%llu checked, %llu mismatched, %llu incomplete, %llu send failures\n",
+                    r.name.c_str(), r.entities, r.downKbps, r.upKbps, r.deltaBytes, r.packetsPerSnapshot, r.fullBytes,
+                    r.fullShare * 100.0, r.receiveUs, r.updateUs, r.sendUs, r.predictionError, r.maxPredictionError,
+                    static_cast<unsigned long long>(r.statesChecked), static_cast<unsigned long long>(r.mismatches),
+                    static_cast<unsigned long long>(r.incomplete), static_cast<unsigned long long>(r.sendFailures));
+        ok = ok && r.mismatches == 0 && r.statesChecked > 0;
+        results.push_back(r);
+    }
+
+    if (jsonPath && !writeJson(jsonPath, results, link)) {
+        std::fprintf(stderr, "Failed to write %s\n", jsonPath);
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+// Observation encoder benchmark: encodes per second for the late-game
+// scenarios, against a full scan of the aliens with a partial sort. Checks
+// that both pick the same aliens in the same order and that encoding
+// doesn't touch the heap.
+// Usage: observation_bench [--scenario name] [--json results.json]
+#include "bench_harness.hpp"
+#include "bench_scenarios.hpp"
+#include "../include/alloc_stats.hpp"
+#include "../include/logger.hpp"
+#include "../include/observation_encoder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    using namespace bench;
+
+    const double MIN_RUN_SECONDS = 0.3;
+
+    struct ScenarioResult {
+        std::string name;
+        size_t aliens;
+        double gridNs;
+        double scanNs;
+        uint64_t allocations;
+        bool matches;
+    };
+
+    // Reference: sort every alien by (distance, index), keep the first K
+    int scanNearest(const GameManager& game, std::vector<std::pair<float, uint32_t>>& ranked, uint32_t* nearest) {
+        ranked.clear();
+        uint32_t index = 0;
+        for (const Alien& alien : game.aliens) {
+            Vec2 diff = alien.position - game.spacecraft.position;
+            if (alien.active) ranked.push_back(std::make_pair(diff.dot(diff), index));
+            index++;
+        }
+        int count = std::min<int>(OBS_NEAREST_ALIENS, static_cast<int>(ranked.size()));
+        std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end());
+        for (int i = 0; i < count; i++) nearest[i] = ranked[i].second;
+        return count;
+    }
+
+    template <typename Fn>
+    double nsPerCall(Fn fn) {
+        uint64_t calls = 0;
+        auto start = std::chrono::steady_clock::now();
+        double seconds = 0;
+        while (seconds < MIN_RUN_SECONDS) {
+            for (int i = 0; i < 1000; i++) fn();
+            calls += 1000;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        return seconds * 1e9 / calls;
+    }
+
+    ScenarioResult runScenario(const Scenario& s) {
+        std::vector<GameManager> games = recordSnapshots(s);
+        ObservationEncoder encoder;
+        float observation[OBSERVATION_SIZE];
+
+        ScenarioResult r;
+        r.name = s.name;
+        r.aliens = games.back().aliens.size();
+        r.matches = true;
+
+        // Same aliens, same order: compare positions against the scan's picks
+        std::vector<std::pair<float, uint32_t>> ranked;
+        for (const GameManager& game : games) {
+            encoder.encode(game, observation);
+            uint32_t nearest[OBS_NEAREST_ALIENS];
+            int count = scanNearest(game, ranked, nearest);
+            std::vector<const Alien*> byIndex;
+            for (const Alien& alien : game.aliens) byIndex.push_back(&alien);
+            for (int i = 0; i < OBS_NEAREST_ALIENS; i++) {
+                const float* features = observation + OBS_ALIENS_OFFSET + i * OBS_ALIEN_FEATURES;
+                float expectedDx = 0;
+                if (i < count) expectedDx = (byIndex[nearest[i]]->position.x - game.spacecraft.position.x) / WINDOW_WIDTH;
+                if (features[OBS_ALIEN_DX] != expectedDx) r.matches = false;
+            }
+        }
+
+        size_t next = 0;
+        AllocCounters before = getAllocCounters();
+        r.gridNs = nsPerCall([&] {
+            encoder.encode(games[next++ % games.size()], observation);
+            doNotOptimize(observation[0]);
+        });
+        r.allocations = getAllocCounters().allocations - before.allocations;
+
+        ranked.reserve(s.aliens * 2);
+        r.scanNs = nsPerCall([&] {
+            uint32_t nearest[OBS_NEAREST_ALIENS];
+            doNotOptimize(scanNearest(games[next++ % games.size()], ranked, nearest));
+        });
+        return r;
+    }
+
+    bool writeJson(const char* path, const std::vector<ScenarioResult>& results) {
+        std::FILE* f = std::fopen(path, "w");
+        if (!f) return false;
+        std::fprintf(f, "{\n  \"suite\": \"observation_bench\",\n  \"observation_floats\": %d,\n  \"scenarios\": [\n",
+                     OBSERVATION_SIZE);
+        for (size_t i = 0; i < results.size(); i++) {
+            const ScenarioResult& r = results[i];
+            std::fprintf(f, "    {\"name\": \"%s\", \"aliens\": %zu, \"encode_ns\": %.1f, \"encodes_per_second\": %.0f, "
+                         "\"scan_nearest_ns\": %.1f, \"allocations\": %llu, \"matches_scan\": %s}%s\n",
+                         r.name.c_str(), r.aliens, r.gridNs, 1e9 / r.gridNs, r.scanNs,
+                         (unsigned long long)r.allocations, r.matches ? "true" : "false",
+                         i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        return std::fclose(f) == 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* only = nullptr;
+    const char* jsonPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--scenario") && i + 1 < argc) only = argv[++i];
+        else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+    }
+    getLogger().setMinLevel(LogLevel::WARN);
+
+    std::vector<ScenarioResult> results;
+    bool allMatch = true;
+    std::printf("Observation: %d floats, %d nearest aliens, %d motherships\n", OBSERVATION_SIZE,
+                OBS_NEAREST_ALIENS, OBS_NEAREST_MOTHERSHIPS);
+    std::printf("%-8s %7s %12s %14s %16s %7s  %s\n", "scenario", "aliens", "encode ns", "encodes/s",
+                "scan nearest ns", "allocs", "check");
+    for (const Scenario& s : SCENARIOS) {
+        if (only && std::strcmp(only, s.name)) continue;
+        ScenarioResult r = runScenario(s);
+        std::printf("%-8s %7zu %12.1f %14.0f %16.1f %7llu  %s\n", r.name.c_str(), r.aliens, r.gridNs,
+                    1e9 / r.gridNs, r.scanNs, (unsigned long long)r.allocations,
+                    r.matches ? "matches scan" : "MISMATCH");
+        allMatch = allMatch && r.matches && r.allocations == 0;
+        results.push_back(r);
+    }
+
+    if (jsonPath && !writeJson(jsonPath, results)) {
+        std::fprintf(stderr, "Failed to write %s\n", jsonPath);
+        return 1;
+    }
+    return allMatch ? 0 : 1;
+}
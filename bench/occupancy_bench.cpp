@@ -0,0 +1,216 @@
+// Occupancy grid benchmark: grids per second for one thread on the
+// late-game scenarios, checked pixel for pixel against a plain per-pixel
+// reference, then VecEnv::render() over a batch of environments with one
+// thread and with every thread (which must produce the same bytes).
+// Usage: occupancy_bench [--scenario name] [--envs N] [--threads N] [--json results.json]
+#include "bench_harness.hpp"
+#include "bench_scenarios.hpp"
+#include "../include/alloc_stats.hpp"
+#include "../include/logger.hpp"
+#include "../include/occupancy_grid.hpp"
+#include "../include/vec_env.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+    using namespace bench;
+
+    const double MIN_RUN_SECONDS = 0.3;
+    const int WARMUP_STEPS = 600;  // Lets the batch reach a few waves before rendering
+
+    struct ScenarioResult {
+        std::string name;
+        size_t aliens;
+        double ns;
+        uint64_t allocations;
+        bool matches;
+    };
+
+    struct BatchResult {
+        int threads;
+        double imagesPerSecond;
+        uint64_t checksum;
+    };
+
+    // Reference: every pixel of the entity's box tested on its own
+    void referenceStamp(uint8_t* out, int width, int height, Vec2 position, float radius, int channel, uint8_t value) {
+        float scaleX = static_cast<float>(width) / WINDOW_WIDTH, scaleY = static_cast<float>(height) / WINDOW_HEIGHT;
+        float cx = position.x * scaleX, cy = (WINDOW_HEIGHT - position.y) * scaleY;
+        float rx = std::max(radius * scaleX, OCC_MIN_RADIUS), ry = std::max(radius * scaleY, OCC_MIN_RADIUS);
+        float inverseRx = 1.0f / rx, inverseRy = 1.0f / ry;
+        for (int y = 0; y < height; y++) {
+            float dy = (y + 0.5f - cy) * inverseRy;
+            if (dy * dy > 1.0f) continue;
+            for (int x = 0; x < width; x++) {
+                float dx = (x + 0.5f - cx) * inverseRx;
+                if (dx * dx + dy * dy > 1.0f) continue;
+                uint8_t& pixel = out[(y * width + x) * OCC_CHANNELS + channel];
+                pixel = std::max(pixel, value);
+            }
+        }
+    }
+
+    void referenceRasterize(const GameManager& game, int width, int height, std::vector<uint8_t>& out) {
+        const uint8_t alienValues[] = {OCC_SCOUT_VALUE, OCC_HUNTER_VALUE, OCC_BRUTE_VALUE};
+        out.assign(static_cast<size_t>(width) * height * OCC_CHANNELS, 0);
+        referenceStamp(out.data(), width, height, game.spacecraft.position, SPACECRAFT_RADIUS, OCC_SHIP, OCC_SOLID_VALUE);
+        for (const Spacecraft& wingman : game.wingmen) {
+            if (wingman.isAlive()) referenceStamp(out.data(), width, height, wingman.position, SPACECRAFT_RADIUS, OCC_SHIP, OCC_SOLID_VALUE);
+        }
+        for (const Alien& alien : game.aliens) {
+            if (!alien.active) continue;
+            referenceStamp(out.data(), width, height, alien.position, alien.getSize(), OCC_ALIENS,
+                           alienValues[static_cast<int>(alien.type)]);
+        }
+        for (const Plasma& plasma : game.plasmas) {
+            if (plasma.active) referenceStamp(out.data(), width, height, plasma.position, PLASMA_RADIUS, OCC_PLASMA, OCC_SOLID_VALUE);
+        }
+        for (const Mothership& m : game.motherships) {
+            if (m.active) referenceStamp(out.data(), width, height, m.position, m.size, OCC_MOTHERSHIPS, OCC_SOLID_VALUE);
+        }
+    }
+
+    ScenarioResult runScenario(const Scenario& s) {
+        std::vector<GameManager> games = recordSnapshots(s);
+        ScenarioResult r;
+        r.name = s.name;
+        r.aliens = games.back().aliens.size();
+        r.matches = true;
+
+        // Odd sizes too, for the row tail
+        const int sizes[][2] = {{OCC_DEFAULT_SIZE, OCC_DEFAULT_SIZE}, {63, 42}, {3, 2}};
+        for (const auto& size : sizes) {
+            OccupancyRasterizer rasterizer(size[0], size[1]);
+            std::vector<uint8_t> image(rasterizer.getByteCount()), expected;
+            for (const GameManager& game : games) {
+                rasterizer.rasterize(game, image.data());
+                referenceRasterize(game, size[0], size[1], expected);
+                if (image != expected) r.matches = false;
+            }
+        }
+
+        OccupancyRasterizer rasterizer;
+        std::vector<uint8_t> image(rasterizer.getByteCount());
+        size_t next = 0;
+        uint64_t calls = 0;
+        AllocCounters before = getAllocCounters();
+        auto start = std::chrono::steady_clock::now();
+        double seconds = 0;
+        while (seconds < MIN_RUN_SECONDS) {
+            for (int i = 0; i < 100; i++) {
+                rasterizer.rasterize(games[next++ % games.size()], image.data());
+                doNotOptimize(image[0]);
+            }
+            calls += 100;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        r.allocations = getAllocCounters().allocations - before.allocations;
+        r.ns = seconds * 1e9 / calls;
+        return r;
+    }
+
+    BatchResult runBatch(int envCount, int threadCount) {
+        VecEnv env(envCount, threadCount);
+        std::vector<float> observations(static_cast<size_t>(envCount) * ENV_OBSERVATION_SIZE);
+        std::vector<float> actions(static_cast<size_t>(envCount) * ENV_ACTION_SIZE, 0.0f);
+        std::vector<float> rewards(envCount);
+        std::vector<uint8_t> dones(envCount);
+        std::vector<uint8_t> images(envCount * env.getImageBytes());
+
+        // Still ship firing to the right: the aliens pile up around it
+        env.reset(42, observations.data());
+        for (int i = 0; i < envCount; i++) {
+            actions[static_cast<size_t>(i) * ENV_ACTION_SIZE + ENV_ACTION_AIM_X] = 1.0f;
+            actions[static_cast<size_t>(i) * ENV_ACTION_SIZE + ENV_ACTION_FIRE] = 1.0f;
+        }
+        for (int step = 0; step < WARMUP_STEPS; step++) {
+            env.step(actions.data(), observations.data(), rewards.data(), dones.data());
+        }
+
+        BatchResult r;
+        r.threads = env.getThreadCount();
+        uint64_t renders = 0;
+        auto start = std::chrono::steady_clock::now();
+        double seconds = 0;
+        while (seconds < MIN_RUN_SECONDS) {
+            env.render(images.data());
+            renders++;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        r.imagesPerSecond = renders * envCount / seconds;
+
+        r.checksum = 14695981039346656037ull;
+        for (uint8_t byte : images) r.checksum = (r.checksum ^ byte) * 1099511628211ull;
+        return r;
+    }
+
+    bool writeJson(const char* path, const std::vector<ScenarioResult>& results, int envCount,
+                   const BatchResult& single, const BatchResult& parallel) {
+        std::FILE* f = std::fopen(path, "w");
+        if (!f) return false;
+        std::fprintf(f, "{\n  \"suite\": \"occupancy_bench\",\n  \"width\": %d,\n  \"height\": %d,\n  \"channels\": %d,\n"
+                     "  \"scenarios\": [\n", OCC_DEFAULT_SIZE, OCC_DEFAULT_SIZE, OCC_CHANNELS);
+        for (size_t i = 0; i < results.size(); i++) {
+            const ScenarioResult& r = results[i];
+            std::fprintf(f, "    {\"name\": \"%s\", \"aliens\": %zu, \"rasterize_ns\": %.1f, \"grids_per_second\": %.0f, "
+                         "\"allocations\": %llu, \"matches_reference\": %s}%s\n",
+                         r.name.c_str(), r.aliens, r.ns, 1e9 / r.ns, (unsigned long long)r.allocations,
+                         r.matches ? "true" : "false", i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ],\n  \"batch\": {\"envs\": %d, \"threads\": %d, \"images_per_second\": %.0f, "
+                     "\"images_per_second_per_thread\": %.0f, \"single_thread_images_per_second\": %.0f, "
+                     "\"matches_single_thread\": %s}\n}\n",
+                     envCount, parallel.threads, parallel.imagesPerSecond, parallel.imagesPerSecond / parallel.threads,
+                     single.imagesPerSecond, single.checksum == parallel.checksum ? "true" : "false");
+        return std::fclose(f) == 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* only = nullptr;
+    const char* jsonPath = nullptr;
+    int envCount = 256;
+    int threadCount = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--scenario") && i + 1 < argc) only = argv[++i];
+        else if (!std::strcmp(argv[i], "--envs") && i + 1 < argc) envCount = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threadCount = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+    }
+    getLogger().setMinLevel(LogLevel::WARN);
+
+    std::vector<ScenarioResult> results;
+    bool ok = true;
+    std::printf("Occupancy grid: %dx%dx%d bytes\n", OCC_DEFAULT_SIZE, OCC_DEFAULT_SIZE, OCC_CHANNELS);
+    std::printf("%-8s %7s %12s %12s %7s  %s\n", "scenario", "aliens", "rasterize ns", "grids/s", "allocs", "check");
+    for (const Scenario& s : SCENARIOS) {
+        if (only && std::strcmp(only, s.name)) continue;
+        ScenarioResult r = runScenario(s);
+        std::printf("%-8s %7zu %12.1f %12.0f %7llu  %s\n", r.name.c_str(), r.aliens, r.ns, 1e9 / r.ns,
+                    (unsigned long long)r.allocations, r.matches ? "matches reference" : "MISMATCH");
+        ok = ok && r.matches && r.allocations == 0;
+        results.push_back(r);
+    }
+
+    BatchResult single = runBatch(envCount, 1);
+    BatchResult parallel = runBatch(envCount, threadCount);
+    bool same = single.checksum == parallel.checksum;
+    std::printf("\nVecEnv::render, %d environments\n", envCount);
+    std::printf("  1 thread:   %12.0f images/s\n", single.imagesPerSecond);
+    std::printf("  %d thread%s: %12.0f images/s (%.0f per thread)  %s\n", parallel.threads,
+                parallel.threads == 1 ? " " : "s", parallel.imagesPerSecond,
+                parallel.imagesPerSecond / parallel.threads, same ? "matches 1 thread" : "MISMATCH");
+    ok = ok && same;
+
+    if (jsonPath && !writeJson(jsonPath, results, envCount, single, parallel)) {
+        std::fprintf(stderr, "Failed to write %s\n", jsonPath);
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+// Offscreen render benchmark. Creates a GL 3.3 core context through EGL
+// without any window (surfaceless on Mesa, a 1x1 pbuffer elsewhere), renders
+// into an FBO and replays recorded game-state snapshots through the same
+// draw sequence as the game loop. Runs on CI machines with only a software
+// rasterizer (llvmpipe); reports CPU submission time, draw calls, uploaded
+// bytes and full frame time (submission + glFinish) per scenario.
+// Usage: render_bench [--frames N] [--scenario name] [--json results.json]
+#include "bench_scenarios.hpp"
+#include "../include/renderer.hpp"
+#include "../include/gl_device.hpp"
+#include "../include/logger.hpp"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+    using namespace bench;
+
+    struct OffscreenContext {
+        EGLDisplay display = EGL_NO_DISPLAY;
+        EGLContext context = EGL_NO_CONTEXT;
+        EGLSurface surface = EGL_NO_SURFACE;
+        GLuint framebuffer = 0;
+        GLuint colorBuffer = 0;
+    };
+
+    EGLDisplay openDisplay() {
+        // Prefer the surfaceless platform: no X server or GPU device required
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay) {
+            EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr)) return display;
+        }
+        EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr)) return display;
+        return EGL_NO_DISPLAY;
+    }
+
+    bool createContext(OffscreenContext& ctx) {
+        ctx.display = openDisplay();
+        if (ctx.display == EGL_NO_DISPLAY) {
+            std::fprintf(stderr, "Failed to initialize an EGL display\n");
+            return false;
+        }
+        if (!eglBindAPI(EGL_OPENGL_API)) {
+            std::fprintf(stderr, "EGL implementation does not support desktop OpenGL\n");
+            return false;
+        }
+
+        const EGLint configAttribs[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+            EGL_NONE
+        };
+        EGLConfig config;
+        EGLint configCount = 0;
+        if (!eglChooseConfig(ctx.display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+            std::fprintf(stderr, "No suitable EGL config\n");
+            return false;
+        }
+
+        const EGLint contextAttribs[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 3,
+            EGL_CONTEXT_MINOR_VERSION, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        ctx.context = eglCreateContext(ctx.display, config, EGL_NO_CONTEXT, contextAttribs);
+        if (ctx.context == EGL_NO_CONTEXT) {
+            std::fprintf(stderr, "Failed to create a GL 3.3 core context\n");
+            return false;
+        }
+
+        // Surfaceless contexts need EGL_KHR_surfaceless_context; otherwise
+        // bind a tiny pbuffer and render into the FBO anyway
+        if (!eglMakeCurrent(ctx.display, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx.context)) {
+            const EGLint pbufferAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+            ctx.surface = eglCreatePbufferSurface(ctx.display, config, pbufferAttribs);
+            if (ctx.surface == EGL_NO_SURFACE ||
+                !eglMakeCurrent(ctx.display, ctx.surface, ctx.surface, ctx.context)) {
+                std::fprintf(stderr, "Failed to make the EGL context current\n");
+                return false;
+            }
+        }
+
+        glewExperimental = GL_TRUE;
+        GLenum glewStatus = glewInit();
+        // GLEW built for GLX reports a missing X display even though every
+        // entry point resolved fine through the current EGL context
+        if (glewStatus != GLEW_OK && glewStatus != GLEW_ERROR_NO_GLX_DISPLAY) {
+            std::fprintf(stderr, "Failed to initialize GLEW: %s\n", glewGetErrorString(glewStatus));
+            return false;
+        }
+        glGetError();  // glewInit can leave GL_INVALID_ENUM behind on core profiles
+
+        glGenFramebuffers(1, &ctx.framebuffer);
+        glGenRenderbuffers(1, &ctx.colorBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, ctx.colorBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WINDOW_WIDTH, WINDOW_HEIGHT);
+        glBindFramebuffer(GL_FRAMEBUFFER, ctx.framebuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, ctx.colorBuffer);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::fprintf(stderr, "Offscreen framebuffer is incomplete\n");
+            return false;
+        }
+        glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+        return true;
+    }
+
+    void destroyContext(OffscreenContext& ctx) {
+        if (ctx.context != EGL_NO_CONTEXT) {
+            glDeleteRenderbuffers(1, &ctx.colorBuffer);
+            glDeleteFramebuffers(1, &ctx.framebuffer);
+            eglMakeCurrent(ctx.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            eglDestroyContext(ctx.display, ctx.context);
+        }
+        if (ctx.surface != EGL_NO_SURFACE) eglDestroySurface(ctx.display, ctx.surface);
+        if (ctx.display != EGL_NO_DISPLAY) eglTerminate(ctx.display);
+    }
+
+    void renderSnapshot(Renderer& renderer, const GameManager& game) {
+        renderer.beginFrame();
+        renderer.drawGame(game);
+        renderer.endFrame();
+    }
+
+    struct SceneResult {
+        std::string name;
+        int frames;
+        double submitMeanMs, submitP99Ms;
+        double frameMeanMs, frameP99Ms;
+        double gpuMeanMs;
+        double drawCalls;
+        double bytesUploaded;
+    };
+
+    double percentile(std::vector<double> values, double p) {
+        std::sort(values.begin(), values.end());
+        size_t index = std::min(values.size() - 1, static_cast<size_t>(p * (values.size() - 1) + 0.5));
+        return values[index];
+    }
+
+    double mean(const std::vector<double>& values) {
+        double sum = 0;
+        for (double v : values) sum += v;
+        return values.empty() ? 0 : sum / values.size();
+    }
+
+    SceneResult runScene(Renderer& renderer, const Scenario& s, int frames) {
+        std::vector<GameManager> snapshots = recordSnapshots(s);
+
+        // Warm up driver caches and the timer query ring
+        for (const GameManager& snapshot : snapshots) renderSnapshot(renderer, snapshot);
+        glFinish();
+
+        std::vector<double> submitMs, frameMs;
+        double gpuMs = 0, drawCalls = 0, bytes = 0;
+        submitMs.reserve(frames);
+        frameMs.reserve(frames);
+
+        for (int frame = 0; frame < frames; frame++) {
+            const GameManager& snapshot = snapshots[frame % snapshots.size()];
+
+            auto start = std::chrono::steady_clock::now();
+            renderSnapshot(renderer, snapshot);
+            auto submitted = std::chrono::steady_clock::now();
+            glFinish();
+            auto finished = std::chrono::steady_clock::now();
+
+            submitMs.push_back(std::chrono::duration<double, std::milli>(submitted - start).count());
+            frameMs.push_back(std::chrono::duration<double, std::milli>(finished - start).count());
+            gpuMs += renderer.getGpuFrameTimeMs();
+            drawCalls += renderer.getFrameStats().drawCalls;
+            bytes += renderer.getFrameStats().bytesUploaded;
+        }
+
+        SceneResult r;
+        r.name = s.name;
+        r.frames = frames;
+        r.submitMeanMs = mean(submitMs);
+        r.submitP99Ms = percentile(submitMs, 0.99);
+        r.frameMeanMs = mean(frameMs);
+        r.frameP99Ms = percentile(frameMs, 0.99);
+        r.gpuMeanMs = gpuMs / frames;
+        r.drawCalls = drawCalls / frames;
+        r.bytesUploaded = bytes / frames;
+        return r;
+    }
+
+    bool writeJson(const char* path, const std::vector<SceneResult>& results, const char* glRenderer) {
+        std::FILE* f = std::fopen(path, "w");
+        if (!f) return false;
+        std::fprintf(f, "{\n  \"context\": {\"suite\": \"render_bench\", \"renderer\": \"");
+        for (const char* c = glRenderer; *c; c++) {
+            if (*c == '"' || *c == '\\') std::fputc('\\', f);
+            std::fputc(*c, f);
+        }
+        std::fprintf(f, "\", \"width\": %d, \"height\": %d},\n  \"scenes\": [\n", WINDOW_WIDTH, WINDOW_HEIGHT);
+        for (size_t i = 0; i < results.size(); i++) {
+            const SceneResult& r = results[i];
+            std::fprintf(f, "    {\"name\": \"%s\", \"frames\": %d, \"submit_mean_ms\": %.4f, \"submit_p99_ms\": %.4f, "
+                         "\"frame_mean_ms\": %.4f, \"frame_p99_ms\": %.4f, \"gpu_mean_ms\": %.4f, "
+                         "\"draw_calls\": %.1f, \"bytes_uploaded\": %.0f}%s\n",
+                         r.name.c_str(), r.frames, r.submitMeanMs, r.submitP99Ms, r.frameMeanMs, r.frameP99Ms,
+                         r.gpuMeanMs, r.drawCalls, r.bytesUploaded, i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        return std::fclose(f) == 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    int frames = 120;
+    const char* only = nullptr;
+    const char* jsonPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--frames") && i + 1 < argc) frames = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--scenario") && i + 1 < argc) only = argv[++i];
+        else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+    }
+
+    getLogger().setMinLevel(LogLevel::WARN);
+
+    OffscreenContext ctx;
+    if (!createContext(ctx)) {
+        destroyContext(ctx);
+        return 1;
+    }
+
+    int exitCode = 0;
+    {
+        GlDevice device;
+        Renderer renderer(device);
+        if (!renderer.initialize()) {
+            std::fprintf(stderr, "Failed to initialize renderer\n");
+            exitCode = 1;
+        } else {
+            device.finishShaderBuilds();  // Frames before the first build finishes draw nothing
+            const char* glRenderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+            std::printf("GL renderer: %s, %dx%d offscreen\n", glRenderer ? glRenderer : "unknown",
+                        WINDOW_WIDTH, WINDOW_HEIGHT);
+            std::printf("%-8s %6s %10s %10s %10s %10s %9s %8s %12s\n", "scene", "frames", "submit ms",
+                        "submit p99", "frame ms", "frame p99", "gpu ms", "draws", "bytes/frame");
+
+            std::vector<SceneResult> results;
+            for (const Scenario& s : SCENARIOS) {
+                if (only && std::strcmp(only, s.name) != 0) continue;
+                results.push_back(runScene(renderer, s, frames));
+                const SceneResult& r = results.back();
+                std::printf("%-8s %6d %10.3f %10.3f %10.3f %10.3f %9.3f %8.0f %12.0f\n",
+                            r.name.c_str(), r.frames, r.submitMeanMs, r.submitP99Ms, r.frameMeanMs,
+                            r.frameP99Ms, r.gpuMeanMs, r.drawCalls, r.bytesUploaded);
+                std::fflush(stdout);
+            }
+
+            if (jsonPath) {
+                if (writeJson(jsonPath, results, glRenderer ? glRenderer : "unknown")) {
+                    std::printf("Results written to %s\n", jsonPath);
+                } else {
+                    std::fprintf(stderr, "Failed to write %s\n", jsonPath);
+                    exitCode = 1;
+                }
+            }
+        }
+        renderer.cleanup();
+    }
+
+    getLogger().flush();
+    destroyContext(ctx);
+    return exitCode;
+}
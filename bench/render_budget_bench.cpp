@@ -0,0 +1,207 @@
+// Render traffic budgets without a GPU: renders recorded game-state
+// snapshots through a RecordingDevice and checks draw calls, state changes
+// and uploaded bytes per frame against per-scene budgets. Also reports the
+// recording cost and a hash of each scene's first frame for golden checks.
+// Usage: render_budget_bench [--scenario name] [--json results.json]
+//                            [--dump scene commands.jsonl]
+// Exits with status 1 when a scene exceeds its budget.
+#include "bench_scenarios.hpp"
+#include "../include/recording_device.hpp"
+#include "../include/renderer.hpp"
+#include "../include/logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+    using namespace bench;
+
+    const int RECORD_ROUNDS = 20;  // Timed passes over the snapshots
+
+    // Worst frame allowed per scene. Tighten these as batching improves.
+    struct RenderBudget {
+        const char* scene;
+        int maxDrawCalls;
+        int maxStateChanges;
+        size_t maxBytesUploaded;
+    };
+
+    const RenderBudget BUDGETS[] = {
+        { "menu", 140, 140, 48 * 1024 },
+        { "wave5", 2600, 1700, 800 * 1024 },
+        { "wave20", 30000, 21000, 9 * 1024 * 1024 },
+        { "wave50", 215000, 155000, 64 * 1024 * 1024 },
+    };
+
+    struct SceneResult {
+        std::string name;
+        RecordingStats worst;
+        double meanDrawCalls;
+        double meanBytes;
+        double recordUsPerFrame;
+        uint64_t firstFrameHash;
+        bool withinBudget;
+    };
+
+    const RenderBudget* findBudget(const char* scene) {
+        for (const RenderBudget& b : BUDGETS) {
+            if (!std::strcmp(b.scene, scene)) return &b;
+        }
+        return nullptr;
+    }
+
+    void recordFrame(Renderer& renderer, const GameManager& game) {
+        renderer.beginFrame();
+        renderer.drawGame(game);
+        renderer.endFrame();
+    }
+
+    SceneResult runScene(const char* name, const std::vector<GameManager>& snapshots,
+                         const char* dumpScene, const char* dumpPath) {
+        RecordingDevice device;
+        Renderer renderer(device);
+        renderer.initialize();
+
+        SceneResult r;
+        r.name = name;
+        r.meanDrawCalls = 0;
+        r.meanBytes = 0;
+
+        for (size_t i = 0; i < snapshots.size(); i++) {
+            recordFrame(renderer, snapshots[i]);
+            const RecordingStats& stats = device.getStats();
+            r.worst.drawCalls = std::max(r.worst.drawCalls, stats.drawCalls);
+            r.worst.verticesDrawn = std::max(r.worst.verticesDrawn, stats.verticesDrawn);
+            r.worst.uploads = std::max(r.worst.uploads, stats.uploads);
+            r.worst.bytesUploaded = std::max(r.worst.bytesUploaded, stats.bytesUploaded);
+            r.worst.stateChanges = std::max(r.worst.stateChanges, stats.stateChanges);
+            r.worst.redundantStateSets = std::max(r.worst.redundantStateSets, stats.redundantStateSets);
+            for (int pass = 0; pass < RENDER_PASS_COUNT; pass++) {
+                r.worst.passDrawCalls[pass] = std::max(r.worst.passDrawCalls[pass], stats.passDrawCalls[pass]);
+                r.worst.passBytesUploaded[pass] = std::max(r.worst.passBytesUploaded[pass],
+                                                           stats.passBytesUploaded[pass]);
+            }
+            r.meanDrawCalls += stats.drawCalls;
+            r.meanBytes += stats.bytesUploaded;
+
+            if (i == 0) {
+                r.firstFrameHash = device.getFrameHash();
+                if (dumpScene && !std::strcmp(dumpScene, name)) {
+                    std::FILE* f = std::fopen(dumpPath, "w");
+                    if (f) {
+                        device.writeLog(f);
+                        std::fclose(f);
+                        std::printf("Command log for %s written to %s\n", name, dumpPath);
+                    } else {
+                        std::fprintf(stderr, "Failed to write %s\n", dumpPath);
+                    }
+                }
+            }
+        }
+        r.meanDrawCalls /= snapshots.size();
+        r.meanBytes /= snapshots.size();
+
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < RECORD_ROUNDS; round++) {
+            for (const GameManager& snapshot : snapshots) recordFrame(renderer, snapshot);
+        }
+        auto end = std::chrono::steady_clock::now();
+        r.recordUsPerFrame = std::chrono::duration<double, std::micro>(end - start).count() /
+                             (RECORD_ROUNDS * snapshots.size());
+
+        renderer.cleanup();
+
+        const RenderBudget* budget = findBudget(name);
+        r.withinBudget = !budget || (r.worst.drawCalls <= budget->maxDrawCalls &&
+                                     r.worst.stateChanges <= budget->maxStateChanges &&
+                                     r.worst.bytesUploaded <= budget->maxBytesUploaded);
+        if (!r.withinBudget) {
+            std::fprintf(stderr, "%s over budget: %d/%d draws, %d/%d state changes, %zu/%zu bytes\n", name,
+                         r.worst.drawCalls, budget->maxDrawCalls, r.worst.stateChanges,
+                         budget->maxStateChanges, r.worst.bytesUploaded, budget->maxBytesUploaded);
+        }
+        return r;
+    }
+
+    bool writeJson(const char* path, const std::vector<SceneResult>& results) {
+        std::FILE* f = std::fopen(path, "w");
+        if (!f) return false;
+        std::fprintf(f, "{\n  \"context\": {\"suite\": \"render_budget_bench\"},\n  \"scenes\": [\n");
+        for (size_t i = 0; i < results.size(); i++) {
+            const SceneResult& r = results[i];
+            std::fprintf(f, "    {\"name\": \"%s\", \"max_draw_calls\": %d, \"max_state_changes\": %d, "
+                         "\"max_redundant_state_sets\": %d, \"max_bytes_uploaded\": %zu, "
+                         "\"mean_draw_calls\": %.1f, \"mean_bytes_uploaded\": %.0f, \"record_us_per_frame\": %.2f, "
+                         "\"first_frame_hash\": \"%016llx\", \"within_budget\": %s, \"pass_draw_calls\": {",
+                         r.name.c_str(), r.worst.drawCalls, r.worst.stateChanges, r.worst.redundantStateSets,
+                         r.worst.bytesUploaded, r.meanDrawCalls, r.meanBytes, r.recordUsPerFrame,
+                         (unsigned long long)r.firstFrameHash, r.withinBudget ? "true" : "false");
+            for (int pass = 0; pass < RENDER_PASS_COUNT; pass++) {
+                std::fprintf(f, "%s\"%s\": %d", pass ? ", " : "", getRenderPassName(static_cast<RenderPass>(pass)),
+                             r.worst.passDrawCalls[pass]);
+            }
+            std::fprintf(f, "}}%s\n", i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        return std::fclose(f) == 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* only = nullptr;
+    const char* jsonPath = nullptr;
+    const char* dumpScene = nullptr;
+    const char* dumpPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--scenario") && i + 1 < argc) only = argv[++i];
+        else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--dump") && i + 2 < argc) {
+            dumpScene = argv[++i];
+            dumpPath = argv[++i];
+        }
+    }
+
+    getLogger().setMinLevel(LogLevel::WARN);
+
+    std::printf("%-8s %9s %9s %9s %9s %12s %12s %10s  %-16s %s\n", "scene", "draws", "mean", "state",
+                "redundant", "bytes", "mean bytes", "record us", "frame hash", "budget");
+
+    std::vector<SceneResult> results;
+    auto report = [&](const SceneResult& r) {
+        std::printf("%-8s %9d %9.0f %9d %9d %12zu %12.0f %10.1f  %016llx %s\n", r.name.c_str(),
+                    r.worst.drawCalls, r.meanDrawCalls, r.worst.stateChanges, r.worst.redundantStateSets,
+                    r.worst.bytesUploaded, r.meanBytes, r.recordUsPerFrame,
+                    (unsigned long long)r.firstFrameHash, r.withinBudget ? "ok" : "OVER");
+        std::fflush(stdout);
+    };
+
+    if (!only || !std::strcmp(only, "menu")) {
+        results.push_back(runScene("menu", menuSnapshots(), dumpScene, dumpPath));
+        report(results.back());
+    }
+    for (const Scenario& s : SCENARIOS) {
+        if (only && std::strcmp(only, s.name) != 0) continue;
+        results.push_back(runScene(s.name, recordSnapshots(s), dumpScene, dumpPath));
+        report(results.back());
+    }
+
+    int exitCode = 0;
+    for (const SceneResult& r : results) {
+        if (!r.withinBudget) exitCode = 1;
+    }
+
+    if (jsonPath) {
+        if (writeJson(jsonPath, results)) {
+            std::printf("Results written to %s\n", jsonPath);
+        } else {
+            std::fprintf(stderr, "Failed to write %s\n", jsonPath);
+            exitCode = 1;
+        }
+    }
+
+    getLogger().flush();
+    return exitCode;
+}
@@ -0,0 +1,159 @@
+// Rewind buffer benchmark: records bot play for the late-game scenarios and
+// reports stored bytes per tick, compression, how many ticks the budget
+// holds, and record/restore times. Restores are checked against full
+// snapshots taken while recording.
+// Usage: rewind_bench [--ticks N] [--budget MB] [--scenario name] [--json results.json]
+#include "bench_scenarios.hpp"
+#include "../include/logger.hpp"
+#include "../include/rewind_buffer.hpp"
+#include "../include/snapshot.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+    using namespace bench;
+
+    const int RESTORE_DISTANCES[] = { 0, 1, 15, 29, 60, 300 };
+    const int RESTORE_DISTANCE_COUNT = sizeof(RESTORE_DISTANCES) / sizeof(RESTORE_DISTANCES[0]);
+    const int RESTORE_REPEATS = 20;
+
+    struct ScenarioResult {
+        std::string name;
+        int ticks;
+        size_t rawBytesPerTick;
+        double storedBytesPerTick;
+        double compression;
+        int ticksHeld;
+        double recordUs;
+        double restoreUs[RESTORE_DISTANCE_COUNT];  // Negative when the tick wasn't held
+        bool restoresMatch;
+    };
+
+    double elapsedUs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    ScenarioResult runScenario(const Scenario& s, int ticks, size_t budgetBytes) {
+        srand(1337);
+        GameManager game;
+        buildScenario(game, s);
+
+        RewindBuffer rewind(budgetBytes, std::max(ticks, REWIND_DEFAULT_MAX_TICKS));
+        std::vector<std::vector<uint8_t>> expected(RESTORE_DISTANCE_COUNT);
+        Vec2 aim(WINDOW_WIDTH / 2.0f, WINDOW_HEIGHT / 2.0f);
+        double recordUs = 0;
+        size_t rawBytes = 0;
+
+        for (int tick = 0; tick < ticks; tick++) {
+            refillScenario(game, s);
+            driveBot(game, tick, aim);
+            game.update(TICK_DT, aim, true);
+
+            auto start = std::chrono::steady_clock::now();
+            rewind.record(game);
+            recordUs += elapsedUs(start);
+            rawBytes += getSnapshotSize(game);
+
+            for (int i = 0; i < RESTORE_DISTANCE_COUNT; i++) {
+                if (tick == ticks - 1 - RESTORE_DISTANCES[i]) encodeSnapshot(game, expected[i]);
+            }
+        }
+
+        ScenarioResult r;
+        r.name = s.name;
+        r.ticks = ticks;
+        r.rawBytesPerTick = rawBytes / ticks;
+        r.compression = rewind.getCompressionRatio();
+        r.storedBytesPerTick = r.rawBytesPerTick / r.compression;
+        r.ticksHeld = rewind.getTickCount();
+        r.recordUs = recordUs / ticks;
+        r.restoresMatch = true;
+
+        GameManager restored;
+        std::vector<uint8_t> encoded;
+        for (int i = 0; i < RESTORE_DISTANCE_COUNT; i++) {
+            int distance = RESTORE_DISTANCES[i];
+            r.restoreUs[i] = -1;
+            if (distance >= r.ticksHeld) continue;
+
+            double best = 1e30;
+            for (int repeat = 0; repeat < RESTORE_REPEATS; repeat++) {
+                auto start = std::chrono::steady_clock::now();
+                rewind.restore(distance, restored);
+                best = std::min(best, elapsedUs(start));
+            }
+            r.restoreUs[i] = best;
+
+            encodeSnapshot(restored, encoded);
+            if (encoded != expected[i]) r.restoresMatch = false;
+        }
+        return r;
+    }
+
+    bool writeJson(const char* path, const std::vector<ScenarioResult>& results, size_t budgetBytes) {
+        std::FILE* f = std::fopen(path, "w");
+        if (!f) return false;
+        std::fprintf(f, "{\n  \"suite\": \"rewind_bench\",\n  \"budget_bytes\": %zu,\n  \"scenarios\": [\n", budgetBytes);
+        for (size_t i = 0; i < results.size(); i++) {
+            const ScenarioResult& r = results[i];
+            std::fprintf(f, "    {\"name\": \"%s\", \"ticks\": %d, \"raw_bytes_per_tick\": %zu, "
+                         "\"stored_bytes_per_tick\": %.1f, \"compression\": %.2f, \"ticks_held\": %d, "
+                         "\"record_us\": %.2f, \"restores_match\": %s, \"restore_us\": {",
+                         r.name.c_str(), r.ticks, r.rawBytesPerTick, r.storedBytesPerTick, r.compression,
+                         r.ticksHeld, r.recordUs, r.restoresMatch ? "true" : "false");
+            bool first = true;
+            for (int d = 0; d < RESTORE_DISTANCE_COUNT; d++) {
+                if (r.restoreUs[d] < 0) continue;
+                std::fprintf(f, "%s\"%d\": %.2f", first ? "" : ", ", RESTORE_DISTANCES[d], r.restoreUs[d]);
+                first = false;
+            }
+            std::fprintf(f, "}}%s\n", i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        return std::fclose(f) == 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    int ticks = 600;
+    size_t budgetMb = REWIND_DEFAULT_BUDGET_MB;
+    const char* only = nullptr;
+    const char* jsonPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--ticks") && i + 1 < argc) ticks = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--budget") && i + 1 < argc) budgetMb = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--scenario") && i + 1 < argc) only = argv[++i];
+        else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+    }
+    getLogger().setMinLevel(LogLevel::WARN);
+    size_t budgetBytes = budgetMb * 1024 * 1024;
+
+    std::vector<ScenarioResult> results;
+    bool allMatch = true;
+    std::printf("Rewind buffer: %zu MB budget, keyframe every %d ticks\n", budgetMb, REWIND_KEYFRAME_INTERVAL);
+    std::printf("%-8s %10s %12s %8s %7s %10s  restore us at ticks back\n", "scenario", "raw KB", "stored KB",
+                "ratio", "held", "record us");
+    for (const Scenario& s : SCENARIOS) {
+        if (only && std::strcmp(only, s.name)) continue;
+        ScenarioResult r = runScenario(s, ticks, budgetBytes);
+        std::printf("%-8s %10.1f %12.1f %7.1fx %7d %10.1f ", r.name.c_str(), r.rawBytesPerTick / 1024.0,
+                    r.storedBytesPerTick / 1024.0, r.compression, r.ticksHeld, r.recordUs);
+        for (int d = 0; d < RESTORE_DISTANCE_COUNT; d++) {
+            if (r.restoreUs[d] >= 0) std::printf(" %d:%.1f", RESTORE_DISTANCES[d], r.restoreUs[d]);
+        }
+        std::printf("  %s\n", r.restoresMatch ? "match" : "MISMATCH");
+        allMatch = allMatch && r.restoresMatch;
+        results.push_back(r);
+    }
+
+    if (jsonPath && !writeJson(jsonPath, results, budgetBytes)) {
+        std::fprintf(stderr, "Failed to write %s\n", jsonPath);
+        return 1;
+    }
+    return allMatch ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+// Snapshot benchmark: encode, save, load (mmap) and restore times for the
+// late-game scenarios, plus two correctness checks: re-encoding a restored
+// game reproduces the same bytes, and a restored copy stays identical to the
+// original over the next ticks of bot play.
+// Usage: snapshot_bench [--ticks N] [--scenario name] [--json results.json]
+#include "bench_scenarios.hpp"
+#include "../include/logger.hpp"
+#include "../include/snapshot.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+    using namespace bench;
+
+    const int REPEATS = 20;
+
+    struct ScenarioResult {
+        std::string name;
+        size_t bytes;
+        double encodeMs, saveMs, loadMs, restoreMs;
+        bool roundTrip;
+        bool deterministic;
+        int replayTicks;
+    };
+
+    template <typename Fn>
+    double bestOf(Fn fn) {
+        double best = 1e30;
+        for (int i = 0; i < REPEATS; i++) {
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        return best;
+    }
+
+    double megabytesPerSecond(size_t bytes, double ms) {
+        return bytes / (1024.0 * 1024.0) / (ms / 1000.0);
+    }
+
+    ScenarioResult runScenario(const Scenario& s, int ticks, const char* path) {
+        GameManager game = recordSnapshots(s).back();
+
+        ScenarioResult r;
+        r.name = s.name;
+        std::vector<uint8_t> encoded;
+        r.encodeMs = bestOf([&] { encodeSnapshot(game, encoded); });
+        r.bytes = encoded.size();
+        r.saveMs = bestOf([&] { saveSnapshot(game, path); });
+
+        SnapshotView view;
+        r.loadMs = bestOf([&] { view.openFile(path); });
+
+        GameManager copy;
+        r.restoreMs = bestOf([&] { view.restore(copy); });
+
+        std::vector<uint8_t> reencoded;
+        encodeSnapshot(copy, reencoded);
+        r.roundTrip = reencoded == encoded;
+
+        // Both games see the same bot input; any state the snapshot misses shows up as divergence
+        r.deterministic = true;
+        r.replayTicks = ticks;
+        Vec2 aimOriginal(WINDOW_WIDTH / 2.0f, WINDOW_HEIGHT / 2.0f), aimCopy = aimOriginal;
+        for (int tick = 0; tick < ticks; tick++) {
+            driveBot(game, tick, aimOriginal);
+            game.update(TICK_DT, aimOriginal, true);
+            driveBot(copy, tick, aimCopy);
+            copy.update(TICK_DT, aimCopy, true);
+
+            encodeSnapshot(game, encoded);
+            encodeSnapshot(copy, reencoded);
+            if (encoded != reencoded) {
+                r.deterministic = false;
+                r.replayTicks = tick + 1;
+                break;
+            }
+        }
+        return r;
+    }
+
+    bool writeJson(const char* path, const std::vector<ScenarioResult>& results) {
+        std::FILE* f = std::fopen(path, "w");
+        if (!f) return false;
+        std::fprintf(f, "{\n  \"suite\": \"snapshot_bench\",\n  \"scenarios\": [\n");
+        for (size_t i = 0; i < results.size(); i++) {
+            const ScenarioResult& r = results[i];
+            std::fprintf(f, "    {\"name\": \"%s\", \"bytes\": %zu, \"encode_ms\": %.4f, \"save_ms\": %.4f, "
+                         "\"load_ms\": %.4f, \"restore_ms\": %.4f, \"round_trip\": %s, \"deterministic\": %s, "
+                         "\"replay_ticks\": %d}%s\n",
+                         r.name.c_str(), r.bytes, r.encodeMs, r.saveMs, r.loadMs, r.restoreMs,
+                         r.roundTrip ? "true" : "false", r.deterministic ? "true" : "false", r.replayTicks,
+                         i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        return std::fclose(f) == 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    int ticks = 300;
+    const char* only = nullptr;
+    const char* jsonPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--ticks") && i + 1 < argc) ticks = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--scenario") && i + 1 < argc) only = argv[++i];
+        else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+    }
+    getLogger().setMinLevel(LogLevel::WARN);
+
+    char path[64];
+    std::snprintf(path, sizeof(path), "/tmp/xenostrike_snapshot_bench_%d.bin", (int)getpid());
+
+    std::vector<ScenarioResult> results;
+    bool allPassed = true;
+    std::printf("%-8s %10s %12s %12s %12s %12s  %s\n", "scenario", "KB", "encode ms", "save ms",
+                "load ms", "restore ms", "checks");
+    for (const Scenario& s : SCENARIOS) {
+        if (only && std::strcmp(only, s.name)) continue;
+        ScenarioResult r = runScenario(s, ticks, path);
+        std::printf("%-8s %10.1f %12.4f %12.4f %12.4f %12.4f  round trip %s, replay %s (%d ticks)\n",
+                    r.name.c_str(), r.bytes / 1024.0, r.encodeMs, r.saveMs, r.loadMs, r.restoreMs,
+                    r.roundTrip ? "ok" : "MISMATCH", r.deterministic ? "ok" : "DIVERGED", r.replayTicks);
+        std::printf("%-8s %10s %9.0f MB/s %7.0f MB/s %17s %7.0f MB/s\n", "", "",
+                    megabytesPerSecond(r.bytes, r.encodeMs), megabytesPerSecond(r.bytes, r.saveMs), "",
+                    megabytesPerSecond(r.bytes, r.restoreMs));
+        allPassed = allPassed && r.roundTrip && r.deterministic;
+        results.push_back(r);
+    }
+    std::remove(path);
+
+    if (jsonPath && !writeJson(jsonPath, results)) {
+        std::fprintf(stderr, "Failed to write %s\n", jsonPath);
+        return 1;
+    }
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+// Software rasterizer benchmark: renders recorded game-state snapshots at
+// 1200x800 through SoftwareDevice, single-threaded and with every hardware
+// thread, and reports frame time and how much faster than realtime (60 Hz)
+// capture runs. Also checks that replaying a RecordingDevice log produces a
+// bit-identical image, and prints image hashes for golden comparisons.
+// With --capture, the multithreaded runs are also streamed to a Y4M file
+// through FrameCapture.
+// Usage: software_render_bench [--frames N] [--scenario name] [--threads N]
+//                              [--ppm dir] [--capture video.y4m] [--json results.json]
+#include "bench_scenarios.hpp"
+#include "../include/frame_capture.hpp"
+#include "../include/recording_device.hpp"
+#include "../include/renderer.hpp"
+#include "../include/software_device.hpp"
+#include "../include/logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+    using namespace bench;
+
+    const double REALTIME_FRAME_MS = 1000.0 / 60.0;
+
+    struct SceneResult {
+        std::string name;
+        int threads;
+        double frameMs;    // Renderer + binning + rasterization
+        double rasterMs;   // endFrame() only
+        double captureMs;  // readPixels + hand-off to the capture writer
+        uint64_t imageHash;
+        bool replayMatches;
+    };
+
+    void renderFrame(Renderer& renderer, const GameManager& game) {
+        renderer.beginFrame();
+        renderer.drawGame(game);
+        renderer.endFrame();
+    }
+
+    SceneResult runScene(const char* name, const std::vector<GameManager>& snapshots, int threads,
+                         int frames, const char* ppmDir, FrameCapture* capture) {
+        SoftwareDevice device(WINDOW_WIDTH, WINDOW_HEIGHT, threads);
+        Renderer renderer(device);
+        renderer.initialize();
+
+        SceneResult r;
+        r.name = name;
+        r.threads = device.getThreadCount();
+
+        // First snapshot: golden hash, replay check and optional image
+        renderFrame(renderer, snapshots[0]);
+        r.imageHash = device.getImageHash();
+
+        RecordingDevice recorder;
+        Renderer recordingRenderer(recorder);
+        renderFrame(recordingRenderer, snapshots[0]);
+        SoftwareDevice replayDevice(WINDOW_WIDTH, WINDOW_HEIGHT, threads);
+        recorder.replay(replayDevice);
+        r.replayMatches = replayDevice.getImageHash() == r.imageHash;
+
+        if (ppmDir) {
+            std::string path = std::string(ppmDir) + "/" + name + ".ppm";
+            if (!device.writePpm(path.c_str())) std::fprintf(stderr, "Failed to write %s\n", path.c_str());
+        }
+
+        double totalMs = 0, rasterMs = 0, captureMs = 0;
+        for (int frame = 0; frame < frames; frame++) {
+            auto start = std::chrono::steady_clock::now();
+            renderFrame(renderer, snapshots[frame % snapshots.size()]);
+            auto end = std::chrono::steady_clock::now();
+            totalMs += std::chrono::duration<double, std::milli>(end - start).count();
+            rasterMs += device.getLastFrameMs();
+
+            if (capture) {
+                if (uint8_t* pixels = capture->acquireFrame()) {
+                    device.readPixels(pixels);
+                    capture->submitFrame(pixels);
+                }
+                captureMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - end).count();
+            }
+        }
+        r.frameMs = totalMs / frames;
+        r.rasterMs = rasterMs / frames;
+        r.captureMs = captureMs / frames;
+        return r;
+    }
+
+    bool writeJson(const char* path, const std::vector<SceneResult>& results) {
+        std::FILE* f = std::fopen(path, "w");
+        if (!f) return false;
+        std::fprintf(f, "{\n  \"context\": {\"suite\": \"software_render_bench\", \"width\": %d, \"height\": %d},\n"
+                     "  \"scenes\": [\n", WINDOW_WIDTH, WINDOW_HEIGHT);
+        for (size_t i = 0; i < results.size(); i++) {
+            const SceneResult& r = results[i];
+            std::fprintf(f, "    {\"name\": \"%s\", \"threads\": %d, \"frame_ms\": %.3f, \"raster_ms\": %.3f, "
+                         "\"capture_ms\": %.3f, \"realtime_factor\": %.2f, \"image_hash\": \"%016llx\", \"replay_matches\": %s}%s\n",
+                         r.name.c_str(), r.threads, r.frameMs, r.rasterMs, r.captureMs, REALTIME_FRAME_MS / r.frameMs,
+                         (unsigned long long)r.imageHash, r.replayMatches ? "true" : "false",
+                         i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        return std::fclose(f) == 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    int frames = 30;
+    int threads = 0;
+    const char* only = nullptr;
+    const char* ppmDir = nullptr;
+    const char* jsonPath = nullptr;
+    const char* capturePath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--frames") && i + 1 < argc) frames = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--scenario") && i + 1 < argc) only = argv[++i];
+        else if (!std::strcmp(argv[i], "--ppm") && i + 1 < argc) ppmDir = argv[++i];
+        else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--capture") && i + 1 < argc) capturePath = argv[++i];
+    }
+
+    getLogger().setMinLevel(LogLevel::WARN);
+
+    FrameCapture capture;
+    if (capturePath && !capture.start(capturePath, WINDOW_WIDTH, WINDOW_HEIGHT, CaptureFormat::Y4M)) {
+        std::fprintf(stderr, "Failed to open %s\n", capturePath);
+        return 1;
+    }
+
+    std::printf("%-8s %7s %10s %10s %9s  %-16s %s\n", "scene", "threads", "frame ms", "raster ms",
+                "x realtime", "image hash", "replay");
+
+    std::vector<SceneResult> results;
+    int exitCode = 0;
+    auto run = [&](const char* name, const std::vector<GameManager>& snapshots) {
+        // Single-threaded baseline, then the full pool (or --threads)
+        int counts[2] = { 1, threads };
+        for (int count : counts) {
+            bool pooled = count != 1;
+            results.push_back(runScene(name, snapshots, count, frames, pooled ? ppmDir : nullptr,
+                                       pooled && capture.isActive() ? &capture : nullptr));
+            const SceneResult& r = results.back();
+            std::printf("%-8s %7d %10.3f %10.3f %9.1fx  %016llx %s\n", r.name.c_str(), r.threads, r.frameMs,
+                        r.rasterMs, REALTIME_FRAME_MS / r.frameMs, (unsigned long long)r.imageHash,
+                        r.replayMatches ? "match" : "MISMATCH");
+            std::fflush(stdout);
+            if (!r.replayMatches) exitCode = 1;
+        }
+        if (results[results.size() - 2].imageHash != results.back().imageHash) {
+            std::fprintf(stderr, "%s: image differs between thread counts\n", name);
+            exitCode = 1;
+        }
+    };
+
+    if (!only || !std::strcmp(only, "menu")) run("menu", menuSnapshots());
+    for (const Scenario& s : SCENARIOS) {
+        if (only && std::strcmp(only, s.name) != 0) continue;
+        run(s.name, recordSnapshots(s));
+    }
+
+    if (capture.isActive()) {
+        capture.stop();
+        std::printf("Captured %llu frames (%llu dropped, %.1f MB) to %s\n",
+                    (unsigned long long)capture.getFramesWritten(), (unsigned long long)capture.getFramesDropped(),
+                    capture.getBytesWritten() / (1024.0 * 1024.0), capturePath);
+        for (const SceneResult& r : results) {
+            if (r.captureMs > 0) {
+                std::printf("%-8s capture %.3f ms/frame on the render thread\n", r.name.c_str(), r.captureMs);
+            }
+        }
+    }
+
+    if (jsonPath) {
+        if (writeJson(jsonPath, results)) {
+            std::printf("Results written to %s\n", jsonPath);
+        } else {
+            std::fprintf(stderr, "Failed to write %s\n", jsonPath);
+            exitCode = 1;
+        }
+    }
+
+    getLogger().flush();
+    return exitCode;
+}
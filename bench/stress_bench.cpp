@@ -0,0 +1,124 @@
+// End-to-end stress benchmark: builds late-game GameManager scenarios
+// directly and runs a fixed number of ticks with a scripted bot, reporting
+// tick-time percentiles and heap allocations per tick.
+// Usage: stress_bench [--ticks N] [--scenario name] [--json results.json]
+#include "bench_scenarios.hpp"
+#include "../include/alloc_stats.hpp"
+#include "../include/frame_arena.hpp"
+#include "../include/logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+    using namespace bench;
+
+    struct ScenarioResult {
+        std::string name;
+        int ticks;
+        double meanUs, p50Us, p99Us, maxUs;
+        double allocsPerTick;
+        uint64_t maxAllocsInTick;
+        size_t finalAliens, finalParticles, finalPlasmas;
+    };
+
+    double percentile(std::vector<double> values, double p) {
+        std::sort(values.begin(), values.end());
+        size_t index = std::min(values.size() - 1, static_cast<size_t>(p * (values.size() - 1) + 0.5));
+        return values[index];
+    }
+
+    ScenarioResult runScenario(const Scenario& s, int ticks) {
+        srand(1337);
+        GameManager game;
+        buildScenario(game, s);
+
+        std::vector<double> tickUs;
+        tickUs.reserve(ticks);
+        uint64_t totalAllocs = 0, maxAllocs = 0;
+        Vec2 aim(WINDOW_WIDTH / 2, WINDOW_HEIGHT);
+
+        for (int tick = 0; tick < ticks; tick++) {
+            // Population refill and bot input are not timed
+            refillScenario(game, s);
+            driveBot(game, tick, aim);
+
+            getFrameArena().reset();
+            AllocCounters before = getAllocCounters();
+            auto start = std::chrono::steady_clock::now();
+            game.update(TICK_DT, aim, true);
+            auto end = std::chrono::steady_clock::now();
+            AllocCounters after = getAllocCounters();
+
+            tickUs.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+            uint64_t allocs = after.allocations - before.allocations;
+            totalAllocs += allocs;
+            maxAllocs = std::max(maxAllocs, allocs);
+        }
+
+        ScenarioResult r;
+        r.name = s.name;
+        r.ticks = ticks;
+        double sum = 0;
+        for (double v : tickUs) sum += v;
+        r.meanUs = sum / ticks;
+        r.p50Us = percentile(tickUs, 0.50);
+        r.p99Us = percentile(tickUs, 0.99);
+        r.maxUs = percentile(tickUs, 1.0);
+        r.allocsPerTick = (double)totalAllocs / ticks;
+        r.maxAllocsInTick = maxAllocs;
+        r.finalAliens = game.aliens.size();
+        r.finalParticles = game.particles.size();
+        r.finalPlasmas = game.plasmas.size();
+        return r;
+    }
+
+    bool writeJson(const char* path, const std::vector<ScenarioResult>& results) {
+        std::FILE* f = std::fopen(path, "w");
+        if (!f) return false;
+        std::fprintf(f, "{\n  \"suite\": \"stress_bench\",\n  \"scenarios\": [\n");
+        for (size_t i = 0; i < results.size(); i++) {
+            const ScenarioResult& r = results[i];
+            std::fprintf(f, "    {\"name\": \"%s\", \"ticks\": %d, \"mean_us\": %.2f, \"p50_us\": %.2f, "
+                         "\"p99_us\": %.2f, \"max_us\": %.2f, \"allocs_per_tick\": %.3f, \"max_allocs_in_tick\": %llu}%s\n",
+                         r.name.c_str(), r.ticks, r.meanUs, r.p50Us, r.p99Us, r.maxUs, r.allocsPerTick,
+                         (unsigned long long)r.maxAllocsInTick, i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        return std::fclose(f) == 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    int ticks = 1000;
+    const char* only = nullptr;
+    const char* jsonPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--ticks") && i + 1 < argc) ticks = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--scenario") && i + 1 < argc) only = argv[++i];
+        else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+    }
+    getLogger().setMinLevel(LogLevel::WARN);
+
+    std::vector<ScenarioResult> results;
+    std::printf("%-8s %6s %10s %10s %10s %10s %12s %10s  %s\n", "scenario", "ticks", "mean us",
+                "p50 us", "p99 us", "max us", "allocs/tick", "max alloc", "final aliens/particles/plasmas");
+    for (const Scenario& s : SCENARIOS) {
+        if (only && std::strcmp(only, s.name)) continue;
+        ScenarioResult r = runScenario(s, ticks);
+        std::printf("%-8s %6d %10.1f %10.1f %10.1f %10.1f %12.3f %10llu  %zu/%zu/%zu\n", r.name.c_str(), r.ticks,
+                    r.meanUs, r.p50Us, r.p99Us, r.maxUs, r.allocsPerTick, (unsigned long long)r.maxAllocsInTick,
+                    r.finalAliens, r.finalParticles, r.finalPlasmas);
+        results.push_back(r);
+    }
+
+    if (jsonPath && !writeJson(jsonPath, results)) {
+        std::fprintf(stderr, "Failed to write %s\n", jsonPath);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+// Tentacle evaluation benchmark: baked lookup table vs. direct sin/cos
+// for every segment of every tentacle of 10k aliens.
+#include "../include/alien.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+    const int ALIEN_COUNT = 10000;
+    const int FRAMES = 200;
+
+    // The original per-segment formula, kept here as the accuracy reference
+    Vec2 referenceSegmentPosition(const Tentacle& tentacle, int segment, float animTime) {
+        int segments = tentacle.getSegmentCount();
+        float t = (float)segment / segments;
+        float angle = tentacle.getBaseAngle() + std::sin(animTime * 3.0f + tentacle.phase + t * PI) * 0.3f;
+        float segLength = tentacle.getLength() / segments;
+        return Vec2(std::cos(angle) * segLength * (segment + 1),
+                    std::sin(angle) * segLength * (segment + 1));
+    }
+
+    template <typename Eval>
+    double runFrames(const std::vector<Alien>& aliens, Eval eval, float& checksum) {
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < FRAMES; frame++) {
+            float frameTime = frame / 60.0f;
+            for (const auto& alien : aliens) {
+                for (const auto& tentacle : alien.getTentacles()) {
+                    for (int i = 0; i < tentacle.getSegmentCount(); i++) {
+                        Vec2 p = eval(tentacle, i, alien.animationTime + frameTime);
+                        checksum += p.x + p.y;
+                    }
+                }
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+}
+
+int main() {
+    srand(42);
+    std::vector<Alien> aliens;
+    aliens.reserve(ALIEN_COUNT);
+    int segmentCount = 0;
+    for (int i = 0; i < ALIEN_COUNT; i++) {
+        AlienType type = static_cast<AlienType>(i % 3);
+        Alien alien(Vec2(rand() % WINDOW_WIDTH, rand() % WINDOW_HEIGHT), type, 1);
+        alien.animationTime = (rand() % 10000) / 100.0f;
+        for (const auto& tentacle : alien.getTentacles()) segmentCount += tentacle.getSegmentCount();
+        aliens.push_back(alien);
+    }
+
+    float maxError = 0;
+    for (const auto& alien : aliens) {
+        for (const auto& tentacle : alien.getTentacles()) {
+            for (int i = 0; i < tentacle.getSegmentCount(); i++) {
+                Vec2 diff = tentacle.getSegmentPosition(i, alien.animationTime) -
+                    referenceSegmentPosition(tentacle, i, alien.animationTime);
+                maxError = std::max(maxError, diff.length());
+            }
+        }
+    }
+
+    float checksum = 0;
+    double directMs = runFrames(aliens, referenceSegmentPosition, checksum);
+    double tableMs = runFrames(aliens, [](const Tentacle& t, int seg, float time) {
+        return t.getSegmentPosition(seg, time);
+    }, checksum);
+
+    double evals = (double)segmentCount * FRAMES;
+    printf("Tentacle evaluation: %d aliens, %d segments/frame, %d frames\n",
+           ALIEN_COUNT, segmentCount, FRAMES);
+    printf("  direct sin/cos : %8.3f ms/frame  %6.2f ns/segment\n",
+           directMs / FRAMES, directMs * 1e6 / evals);
+    printf("  baked table    : %8.3f ms/frame  %6.2f ns/segment\n",
+           tableMs / FRAMES, tableMs * 1e6 / evals);
+    printf("  speedup %.2fx, max position error %.5f px (checksum %.1f)\n",
+           directMs / tableMs, maxError, checksum);
+    return 0;
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include "vec2.hpp"
+#include "constants.hpp"
+
+// AI level-of-detail tiers. Aliens near the spacecraft steer every tick,
+// distant or off-screen ones steer less often and coast in between.
+enum class AiLodTier { NEAR, MID, FAR };
+
+AiLodTier classifyAiLod(Vec2 alienPos, Vec2 playerPos);
+int getAiLodInterval(AiLodTier tier);
+
+// Staggers steering across ticks so a large wave doesn't re-steer all at once
+bool shouldSteerThisTick(AiLodTier tier, unsigned int tick, unsigned int slot);
@@ -2,7 +2,8 @@
 #include "vec2.hpp"
 #include "tentacle.hpp"
 #include "constants.hpp"
-#include <vector>
+#include <cstdint>
+#include <type_traits>
 
 enum class AlienType { SCOUT, HUNTER, BRUTE };
 
@@ -16,11 +17,18 @@ public:
     bool active;
     float spawnAnimation;
     float animationTime; 
-    std::vector<Tentacle> tentacles;
+    float pendingSteerTime;  // Time coasted since the last steering update
+    uint32_t steerSlot;      // Fixed at spawn; staggers AI LOD steering updates
 
     Alien(Vec2 pos, AlienType t = AlienType::SCOUT, int wave = 1);
 
-    void update(float deltaTime, Vec2 playerPos);
+    void update(float deltaTime, Vec2 playerPos, bool steerThisTick = true);
+    void steer(Vec2 playerPos);
+    void integrate(float deltaTime);
     void takeDamage(float damage);
     float getSize() const;
+    const TentacleSet& getTentacles() const;
 };
+
+// Spawning and compacting aliens must never touch the heap
+static_assert(std::is_trivially_copyable<Alien>::value, "Alien must stay trivially copyable");
@@ -0,0 +1,73 @@
+#pragma once
+#include "alien.hpp"
+#include "slot_map.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+const float ALIEN_GRID_CELL_SIZE = 100.0f;
+const float ALIEN_GRID_MARGIN = 100.0f;  // Beyond the screen, where aliens spawn
+
+// Uniform grid of the aliens for nearest-neighbour queries, kept current by
+// GameManager as aliens spawn, move and die instead of being rebuilt per
+// query. Aliens are filed by slot map slot, so swap-removing an alien never
+// disturbs the others, and each cell is an intrusive linked list: a move
+// that stays in its cell is one compare, crossing into another is O(1), and
+// nothing allocates once the per-slot entries cover the highest slot.
+// Aliens off the grid are clamped into the border cells.
+//
+// Code that edits GameManager::aliens other than through GameManager (state
+// restores, client views) must call GameManager::rebuildAlienGrid().
+class AlienGrid {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+private:
+    struct Entry {
+        uint32_t cell;  // NONE while the slot holds no alien
+        uint32_t generation;
+        uint32_t prev, next;
+    };
+
+    int width, height;
+    std::vector<uint32_t> cellHead;
+    std::vector<Entry> entries;  // Per slot
+    size_t count;
+
+    void link(uint32_t slot, uint32_t cell);
+    void unlink(uint32_t slot);
+
+public:
+    AlienGrid();
+
+    void clear();
+    void rebuild(const SlotMap<Alien>& aliens);
+    void insert(EntityHandle handle, Vec2 position);
+    void remove(EntityHandle handle);
+
+    // Called for every alien every tick, so the common case stays inline
+    void move(EntityHandle handle, Vec2 position) {
+        uint32_t cell = static_cast<uint32_t>(getCell(position));
+        if (entries[handle.index].cell == cell) return;
+        unlink(handle.index);
+        link(handle.index, cell);
+    }
+
+    // Truncation only differs from floor below zero, where the clamp wins anyway
+    int getColumn(float x) const {
+        return std::max(0, std::min(static_cast<int>((x + ALIEN_GRID_MARGIN) * (1.0f / ALIEN_GRID_CELL_SIZE)), width - 1));
+    }
+    int getRow(float y) const {
+        return std::max(0, std::min(static_cast<int>((y + ALIEN_GRID_MARGIN) * (1.0f / ALIEN_GRID_CELL_SIZE)), height - 1));
+    }
+    int getCell(Vec2 position) const { return getRow(position.y) * width + getColumn(position.x); }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    size_t size() const { return count; }
+
+    // Walks a cell: for (uint32_t s = getFirst(cell); s != NONE; s = getNext(s))
+    uint32_t getFirst(int cell) const { return cellHead[cell]; }
+    uint32_t getNext(uint32_t slot) const { return entries[slot].next; }
+    EntityHandle getHandle(uint32_t slot) const { return EntityHandle(slot, entries[slot].generation); }
+};
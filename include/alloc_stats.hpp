@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+
+// Global heap allocation counters. Counting is only compiled in when
+// XS_TRACK_ALLOCATIONS is defined (it replaces global operator new/delete);
+// otherwise the counters stay at zero.
+struct AllocCounters {
+    uint64_t allocations;
+    uint64_t bytes;
+};
+
+bool isAllocTrackingEnabled();
+AllocCounters getAllocCounters();
+
+// Per-frame view: beginFrame() marks the start, getFrameAllocations()
+// returns what was allocated since then on any thread.
+class FrameAllocTracker {
+private:
+    AllocCounters frameStart;
+    uint64_t framesWithAllocations;
+    uint64_t peakFrameAllocations;
+
+public:
+    FrameAllocTracker();
+
+    void beginFrame();
+    AllocCounters endFrame();
+
+    uint64_t getFramesWithAllocations() const { return framesWithAllocations; }
+    uint64_t getPeakFrameAllocations() const { return peakFrameAllocations; }
+    void resetStats();
+};
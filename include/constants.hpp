@@ -10,9 +10,19 @@ const float ALIEN_RADIUS = 20.0f;
 const float PLASMA_RADIUS = 6.0f;
 const float SHOOT_COOLDOWN = 0.25f;
 const int ALIENS_PER_WAVE = 5;
+const int MAX_PLAYERS = 8;             // Spacecraft plus co-op wingmen
+const float WINGMAN_SPACING = 60.0f;    // Between starting positions
 const int CIRCLE_SEGMENTS = 30;
+const int TENTACLE_SEGMENTS = 4;
+const int MAX_TENTACLES = 6;
 const float PI = 3.14159f;
 
+// AI level-of-detail (see ai_lod.hpp)
+const float AI_LOD_NEAR_RADIUS = 300.0f;
+const float AI_LOD_MID_RADIUS = 600.0f;
+const int AI_LOD_MID_INTERVAL = 2;
+const int AI_LOD_FAR_INTERVAL = 4;
+
 enum class GameState {
     MENU,
     PLAYING,
@@ -0,0 +1,11 @@
+#pragma once
+
+// GLSL sources compiled into the binary by the build (see SHADER_FILES in the
+// Makefile), so the game runs from any working directory.
+struct EmbeddedShader {
+    const char* path;    // Source file path relative to the repository root
+    const char* source;
+};
+
+// nullptr if no shader with that path was embedded
+const char* findEmbeddedShader(const char* path);
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+
+const size_t FRAME_ARENA_SIZE = 1 << 20;  // 1 MB per thread
+
+// Bump allocator for data that only lives for one frame. Everything is
+// released at once by reset() at the start of the next frame; requests that
+// don't fit fall back to the heap and are counted as overflows.
+class FrameArena {
+private:
+    std::unique_ptr<unsigned char[]> buffer;
+    size_t capacity;
+    size_t offset;
+    size_t highWaterMark;
+    size_t overflowCount;
+
+public:
+    explicit FrameArena(size_t capacity = FRAME_ARENA_SIZE);
+
+    void* allocate(size_t bytes, size_t alignment);
+    void deallocate(void* ptr);
+    void reset();
+
+    bool owns(const void* ptr) const;
+    size_t getUsed() const { return offset; }
+    size_t getCapacity() const { return capacity; }
+    size_t getHighWaterMark() const { return highWaterMark; }
+    size_t getOverflowCount() const { return overflowCount; }
+};
+
+// Arena for the calling thread; whoever drives the frame loop resets it
+FrameArena& getFrameArena();
+
+// STL allocator adapter, e.g. std::vector<int, ArenaAllocator<int>>
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    FrameArena* arena;
+
+    ArenaAllocator(FrameArena& arena = getFrameArena()) : arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* ptr, size_t) { arena->deallocate(ptr); }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
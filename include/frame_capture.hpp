@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+const int FRAME_CAPTURE_POOL_FRAMES = 4;  // Bounds capture memory to 4 RGBA frames
+const int FRAME_CAPTURE_FPS = 60;
+
+enum class CaptureFormat { Y4M, RAW_RGBA };
+
+// Streams frames to disk on a writer thread. The producer acquires a pooled
+// RGBA8 buffer (top row first), fills it and submits it; the writer converts
+// to I420 for Y4M or writes the bytes as-is for raw RGBA. When every buffer
+// is still queued the frame is dropped and counted, the producer never waits.
+class FrameCapture {
+private:
+    int width, height;
+    size_t frameBytes;
+    CaptureFormat format;
+    std::FILE* output;
+
+    std::vector<uint8_t> storage;      // FRAME_CAPTURE_POOL_FRAMES frames
+    std::vector<uint8_t> planes;       // I420 scratch, writer thread only
+    std::vector<int> freeSlots;
+    int queue[FRAME_CAPTURE_POOL_FRAMES];
+    int queueHead, queueCount;
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping;
+
+    std::atomic<uint64_t> framesWritten;
+    std::atomic<uint64_t> framesDropped;
+    std::atomic<uint64_t> bytesWritten;
+    bool writeFailed;  // Writer thread only
+
+    void writerLoop();
+    bool writeFrame(const uint8_t* rgba);
+    void convertToI420(const uint8_t* rgba);
+
+public:
+    FrameCapture();
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    bool start(const char* path, int width, int height, CaptureFormat format, int fps = FRAME_CAPTURE_FPS);
+    // Writes every queued frame, then closes the file
+    void stop();
+    bool isActive() const { return output != nullptr; }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    // width * height * 4 bytes, or nullptr (frame dropped) when the pool is empty
+    uint8_t* acquireFrame();
+    void submitFrame(uint8_t* frame);
+    // For producers that skip a frame before acquiring a buffer
+    void noteDroppedFrame();
+
+    uint64_t getFramesWritten() const { return framesWritten.load(std::memory_order_relaxed); }
+    uint64_t getFramesDropped() const { return framesDropped.load(std::memory_order_relaxed); }
+    uint64_t getBytesWritten() const { return bytesWritten.load(std::memory_order_relaxed); }
+};
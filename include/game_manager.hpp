@@ -5,14 +5,29 @@
 #include "particle.hpp"
 #include "constants.hpp"
 #include "mothership.hpp"
+#include "slot_map.hpp"
+#include "alien_grid.hpp"
+#include "rng.hpp"
 #include <vector>
 
+// One tick of input for a co-op wingman; the spacecraft itself still takes
+// update()'s arguments and has its velocity set directly
+struct ShipInput {
+    Vec2 velocity;
+    Vec2 aimTarget;
+    bool shooting;
+    bool reload;
+};
+
 class GameManager {
 public:
-    Spacecraft spacecraft;
-    std::vector<Plasma> plasmas;
-    std::vector<Alien> aliens;
-    std::vector<Particle> particles;
+    Spacecraft spacecraft;              // Player 0
+    std::vector<Spacecraft> wingmen;    // Co-op players 1 and up, see addWingman()
+    std::vector<ShipInput> wingmanInputs;  // One per wingman, applied by update()
+    SlotMap<Plasma> plasmas;
+    SlotMap<Alien> aliens;
+    AlienGrid alienGrid;                // Aliens by position, kept current by update()
+    SlotMap<Particle> particles;
     std::vector<Mothership> motherships; 
     int wave;
     int score;
@@ -20,6 +35,11 @@ public:
     bool waveActive;
     GameState gameState;
     float stateTimer;
+    unsigned int tickCount;
+    uint32_t aliensSpawned;  // Hands out each alien's steerSlot
+    Rng rng;  // All gameplay randomness, so a saved state replays exactly
+    bool logEvents;     // Wave and game over messages; off for batch simulation
+    bool spawnEffects;  // Cosmetic particles; off when nothing is rendered
 
     GameManager();
 
@@ -27,11 +47,32 @@ public:
     void startWave();
     void update(float deltaTime, Vec2 mousePos, bool shooting);
     void checkCollisions();
+    // Inserts an alien with the next steering stagger slot
+    EntityHandle spawnAlien(Alien alien);
+    // Refiles every alien after aliens was edited directly
+    void rebuildAlienGrid() { alienGrid.rebuild(aliens); }
+
+    // Adds a co-op ship beside the spacecraft; returns its player index, or
+    // -1 when MAX_PLAYERS are already in
+    int addWingman();
+    // Puts a player's ship back at its starting position, good as new
+    void respawnShip(int player);
+    int getShipCount() const { return 1 + static_cast<int>(wingmen.size()); }
+    Spacecraft& getShip(int player) { return player == 0 ? spacecraft : wingmen[player - 1]; }
+    const Spacecraft& getShip(int player) const { return player == 0 ? spacecraft : wingmen[player - 1]; }
+    bool isAnyShipAlive() const;
 
 private:
+    Vec2 getStartPosition(int player) const;
+    Vec2 getTargetPosition(Vec2 from) const;
+    void fireFrom(Spacecraft& ship);
+    void collideShip(Spacecraft& ship);
+    bool isOutOfAmmo() const;
+    void updateAliens(float deltaTime);
     Vec2 getSpawnPosition();
     void createAlienExplosion(Vec2 pos, Color baseColor);
     void createPlasmaFlash(Vec2 pos);
     void createShieldImpact(Vec2 pos);
-    void createDeathExplosion();
+    void createDeathExplosion(Vec2 pos);
+    void logGameOver(const char* reason);
 };
\ No newline at end of file
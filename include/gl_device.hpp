@@ -0,0 +1,44 @@
+#pragma once
+#include "graphics_device.hpp"
+#include "gpu_timer.hpp"
+#include "shader_manager.hpp"
+#include <GL/glew.h>
+
+// OpenGL 3.3 backend: one shader program, one streaming VBO, per-pass GPU
+// timer queries. Needs a current context before initialize(). The program
+// builds in the background; draws are skipped until it is ready.
+class GlDevice : public GraphicsDevice {
+private:
+    ShaderManager shaders;
+    int simpleProgram;
+    uint32_t programGeneration;
+    GLuint shaderProgram;  // Current build of simpleProgram
+    GLuint VAO, VBO;
+    GLint colorLocation;
+    GLint transformLocation;
+
+    GpuTimer gpuTimer;
+
+    void bindProgram();
+
+public:
+    GlDevice();
+
+    bool initialize() override;
+    void cleanup() override;
+
+    void beginFrame(Color clearColor) override;
+    void endFrame() override;
+    void beginPass(RenderPass pass) override { gpuTimer.beginPass(pass); }
+
+    void uploadVertices(const float* data, size_t floatCount) override;
+    void setColor(Color color) override;
+    void setTransform(const float* matrix) override;
+    void draw(PrimitiveType primitive, int firstVertex, int vertexCount) override;
+
+    // Blocks until pending shader builds are done, e.g. before benchmarking
+    void finishShaderBuilds();
+
+    float getGpuFrameTimeMs() const override { return gpuTimer.getFrameTimeMs(); }
+    const GpuTimer& getGpuTimer() const { return gpuTimer; }
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include "frame_capture.hpp"
+#include <GL/glew.h>
+
+// Asynchronous framebuffer readback for FrameCapture. Each frame's pixels
+// are copied into one of a ring of pixel buffer objects with a fence; a
+// buffer is mapped only once its fence has signalled, normally on the next
+// frame, so neither glReadPixels nor the swap waits on the GPU. If the ring
+// is still busy the frame is dropped rather than stalling.
+class GlFrameReader {
+private:
+    static const int PBO_COUNT = 3;
+
+    GLuint pbos[PBO_COUNT];
+    GLsync fences[PBO_COUNT];
+    int width, height;
+    int head;     // Oldest pending readback
+    int pending;
+
+    void collect(FrameCapture& capture, bool wait);
+
+public:
+    GlFrameReader();
+
+    // Sized to the framebuffer (not the window, on high-DPI displays)
+    bool initialize(int width, int height);
+    void cleanup();
+
+    // After rendering, before the swap: hands finished frames to the
+    // capture and queues a readback of the current one
+    void readFrame(FrameCapture& capture);
+    // Blocks until every pending readback reached the capture
+    void flush(FrameCapture& capture);
+};
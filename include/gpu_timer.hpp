@@ -0,0 +1,45 @@
+#pragma once
+#include "graphics_device.hpp"
+#include <GL/glew.h>
+
+const int GPU_TIMER_SUMMARY_FRAMES = 600;  // Log averaged pass times this often
+
+// Per-pass GL_TIME_ELAPSED queries, one set per frame in flight. Results are
+// only read once the GPU reports them available, a few frames later, so the
+// CPU never waits. The pass times always describe one whole frame: a frame
+// with any result still pending or any pass skipped is dropped, and passes a
+// frame didn't draw count as zero. Without timer query support every call is
+// a no-op.
+class GpuTimer {
+private:
+    static const int FRAMES_IN_FLIGHT = 3;
+
+    GLuint queries[FRAMES_IN_FLIGHT][RENDER_PASS_COUNT];
+    bool issued[FRAMES_IN_FLIGHT][RENDER_PASS_COUNT];
+    bool slotComplete[FRAMES_IN_FLIGHT];  // No pass skipped while recording the slot's frame
+    int frameSlot;
+    int activePass;
+    bool supported;
+
+    float passMs[RENDER_PASS_COUNT];
+    double summaryMs[RENDER_PASS_COUNT];
+    int summaryFrames;
+
+    void collectSlot(int slot);
+    void logSummary();
+
+public:
+    GpuTimer();
+
+    bool initialize();
+    void cleanup();
+
+    void beginFrame();
+    void beginPass(RenderPass pass);
+    void endPass();
+    void endFrame();
+
+    bool isSupported() const { return supported; }
+    float getPassTimeMs(RenderPass pass) const { return passMs[static_cast<int>(pass)]; }
+    float getFrameTimeMs() const;
+};
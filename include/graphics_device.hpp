@@ -0,0 +1,49 @@
+#pragma once
+#include "color.hpp"
+#include <cstddef>
+
+// Logical render passes, used for GPU timing and per-pass accounting
+enum class RenderPass { STARFIELD, PARTICLES, ALIENS, MOTHERSHIPS, PLASMAS, SPACECRAFT, UI, COUNT };
+
+const int RENDER_PASS_COUNT = static_cast<int>(RenderPass::COUNT);
+
+inline const char* getRenderPassName(RenderPass pass) {
+    switch (pass) {
+    case RenderPass::STARFIELD: return "starfield";
+    case RenderPass::PARTICLES: return "particles";
+    case RenderPass::ALIENS: return "aliens";
+    case RenderPass::MOTHERSHIPS: return "motherships";
+    case RenderPass::PLASMAS: return "plasmas";
+    case RenderPass::SPACECRAFT: return "spacecraft";
+    case RenderPass::UI: return "ui";
+    case RenderPass::COUNT: break;
+    }
+    return "?";
+}
+
+enum class PrimitiveType { LINES, TRIANGLES, TRIANGLE_FAN };
+
+// The handful of operations the Renderer needs from a graphics API. Vertices
+// are tightly packed xyz floats in NDC; one flat-color shader is bound for
+// the whole frame. Implementations: GlDevice (real OpenGL) and
+// RecordingDevice (command log for budgets and replay, no GPU).
+class GraphicsDevice {
+public:
+    virtual ~GraphicsDevice() {}
+
+    virtual bool initialize() = 0;
+    virtual void cleanup() = 0;
+
+    virtual void beginFrame(Color clearColor) = 0;
+    virtual void endFrame() = 0;
+    // Starting a pass ends the previous one
+    virtual void beginPass(RenderPass pass) = 0;
+
+    virtual void uploadVertices(const float* data, size_t floatCount) = 0;
+    virtual void setColor(Color color) = 0;
+    virtual void setTransform(const float* matrix) = 0;  // Column-major 4x4
+    virtual void draw(PrimitiveType primitive, int firstVertex, int vertexCount) = 0;
+
+    // Summed GPU pass times of a recent frame, 0 when not measured
+    virtual float getGpuFrameTimeMs() const { return 0; }
+};
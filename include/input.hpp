@@ -0,0 +1,114 @@
+#pragma once
+#include "vec2.hpp"
+#include <cstdint>
+
+const int INPUT_QUEUE_CAPACITY = 256;          // Events between two samples
+const int FRAME_PACING_HISTORY = 30;           // Frames of work time used for the prediction
+const float FRAME_PACING_MARGIN_MS = 2.0f;     // Slack left before the predicted vsync
+const float FRAME_PACING_MAX_DELAY_MS = 12.0f;
+const int INPUT_LATENCY_HISTORY = 120;         // Frames of latency kept for reading back
+
+enum class InputAction : uint8_t { MOVE_UP, MOVE_DOWN, MOVE_LEFT, MOVE_RIGHT, FIRE, START, RELOAD, REWIND, COUNT };
+const int INPUT_ACTION_COUNT = static_cast<int>(InputAction::COUNT);
+
+struct InputEvent {
+    uint64_t timestampNs;  // When the event reached the application
+    bool isCursor;
+    InputAction action;
+    bool pressed;
+    Vec2 cursor;           // Game coordinates (y up)
+};
+
+// Everything one simulation step needs to know about input
+struct InputFrame {
+    Vec2 mousePosition;
+    bool held[INPUT_ACTION_COUNT];
+    int presses[INPUT_ACTION_COUNT];  // Press edges since the previous sample, so quick taps aren't lost
+    int eventCount;
+    int droppedEvents;                // Lost to a full queue since the previous sample
+    uint64_t oldestEventNs;           // 0 if no event arrived
+    uint64_t sampleNs;
+
+    bool isHeld(InputAction action) const { return held[static_cast<int>(action)]; }
+    int getPresses(InputAction action) const { return presses[static_cast<int>(action)]; }
+};
+
+uint64_t inputNowNs();
+
+// Window-system callbacks push timestamped events; the game loop calls
+// sample() right before the simulation step, which applies them in order.
+// Window-system independent: the caller maps keys to actions. Callbacks and
+// sample() must run on the same thread (GLFW delivers them inside
+// glfwPollEvents). A full queue drops the event and counts it in the next
+// sample.
+class InputSystem {
+private:
+    InputEvent events[INPUT_QUEUE_CAPACITY];
+    int eventCount;
+    uint64_t droppedEvents;
+
+    Vec2 mousePosition;
+    bool held[INPUT_ACTION_COUNT];
+
+    void push(const InputEvent& event);
+
+public:
+    InputSystem();
+
+    void pushAction(InputAction action, bool pressed);
+    void pushCursor(Vec2 position);
+
+    InputFrame sample();
+};
+
+// One presented frame's input latency
+struct InputLatencySample {
+    float eventToPresentMs;   // Oldest event the frame applied to its present; 0 if it had none
+    float sampleToPresentMs;
+    float pacingDelayMs;
+    int events;
+    int droppedEvents;
+};
+
+// Optional vsync frame pacing. Sleeps after the previous present so input
+// is sampled as late as the recent work time allows, shrinking the time
+// between sampling and the frame reaching the screen. Also measures every
+// frame's latency, from the timestamp of the oldest event the frame applied
+// (and from the sample) to the return of the swap, keeping the last
+// INPUT_LATENCY_HISTORY frames. GLFW does not expose OS event timestamps, so
+// true motion-to-photon adds OS delivery and scanout on top.
+class FramePacer {
+private:
+    float refreshMs;
+    float workMs[FRAME_PACING_HISTORY];
+    int workHead;
+    uint64_t lastPresentNs;
+    uint64_t lastSampleNs;
+    uint64_t lastOldestEventNs;
+
+    float lastDelayMs;
+    int lastEvents;
+    int lastDroppedEvents;
+    InputLatencySample latency[INPUT_LATENCY_HISTORY];
+    int latencyHead;
+
+    float predictWorkMs() const;
+
+public:
+    bool enabled;
+
+    FramePacer();
+
+    void setRefreshRate(int hz);
+    void toggle();
+
+    // Before polling input: sleeps (when enabled) until the latest safe sample time
+    void waitForSampleTime();
+    void markSampled(const InputFrame& frame);
+    // Right before the swap, and after it returns
+    void markSubmitted(uint64_t submitNs);
+    void markPresented(uint64_t presentNs);
+
+    // age 0 is the most recently presented frame
+    const InputLatencySample& getLatency(int age) const;
+};
@@ -0,0 +1,147 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum class LogLevel { DEBUG, INFO, WARN, ERROR };
+
+const int MAX_LOG_ARGS = 6;
+const size_t LOG_QUEUE_CAPACITY = 1024;  // Records per logging thread, must be a power of two
+
+// Arguments are captured as tagged binary values; formatting into text only
+// happens on the writer thread. Strings must outlive the record (literals).
+struct LogArg {
+    enum class Type : uint8_t { INT, UINT, FLOAT, STRING };
+
+    Type type;
+    union {
+        int64_t i;
+        uint64_t u;
+        double f;
+        const char* s;
+    };
+};
+
+struct LogRecord {
+    uint64_t timestampNs;
+    const char* format;  // "{}" placeholders, must be a string literal
+    LogLevel level;
+    uint8_t argCount;
+    LogArg args[MAX_LOG_ARGS];
+};
+
+inline LogArg makeLogArg(int v) { LogArg a; a.type = LogArg::Type::INT; a.i = v; return a; }
+inline LogArg makeLogArg(long v) { LogArg a; a.type = LogArg::Type::INT; a.i = v; return a; }
+inline LogArg makeLogArg(long long v) { LogArg a; a.type = LogArg::Type::INT; a.i = v; return a; }
+inline LogArg makeLogArg(unsigned int v) { LogArg a; a.type = LogArg::Type::UINT; a.u = v; return a; }
+inline LogArg makeLogArg(unsigned long v) { LogArg a; a.type = LogArg::Type::UINT; a.u = v; return a; }
+inline LogArg makeLogArg(unsigned long long v) { LogArg a; a.type = LogArg::Type::UINT; a.u = v; return a; }
+inline LogArg makeLogArg(float v) { LogArg a; a.type = LogArg::Type::FLOAT; a.f = v; return a; }
+inline LogArg makeLogArg(double v) { LogArg a; a.type = LogArg::Type::FLOAT; a.f = v; return a; }
+inline LogArg makeLogArg(const char* v) { LogArg a; a.type = LogArg::Type::STRING; a.s = v; return a; }
+
+class Logger;
+
+// Single-producer ring owned by one logging thread at a time; only the
+// writer thread consumes it. Neither side needs a read-modify-write.
+struct LogRing {
+    LogRecord records[LOG_QUEUE_CAPACITY];
+    alignas(64) std::atomic<size_t> head;     // Next record the producer writes
+    size_t cachedTail;                        // Producer's last look at tail
+    std::atomic<uint64_t> dropped;            // Only the producer adds
+    alignas(64) std::atomic<size_t> tail;     // Next record the writer reads
+    std::atomic<size_t> written;              // Records written and flushed
+    Logger* owner;
+    std::atomic<bool> leased;                 // Held by a live thread
+
+    LogRing() : head(0), cachedTail(0), dropped(0), tail(0), written(0), owner(nullptr), leased(false) {}
+};
+
+// The calling thread's ring; constant-initialized, so reading it is a plain
+// thread-local load
+inline thread_local LogRing* threadLogRing = nullptr;
+
+// Asynchronous logger. Any thread may log: each logging thread gets its own
+// bounded ring and a background thread formats and writes the records,
+// merging the rings in timestamp order (each thread's own records stay in
+// order; records from different threads stamped in the same clock period
+// may interleave either way). A full ring drops the record (and counts it)
+// rather than blocking the caller.
+//
+// Recording a record costs a few plain loads and stores: the record is
+// written straight into the ring, with no atomic read-modify-write, and the
+// timestamp is a coarse clock refreshed by updateClock() (once per frame or
+// tick) and by the writer thread whenever it wakes. That is as fine as the
+// millisecond timestamps the log prints.
+class Logger {
+private:
+    std::vector<std::unique_ptr<LogRing>> rings;  // Never shrinks; rings of exited threads are reused
+    mutable std::mutex ringsMutex;
+    alignas(64) std::atomic<uint64_t> clockNs;   // Coarse time since the logger started
+    std::atomic<int> minLevel;
+    std::atomic<bool> running;
+    std::FILE* output;
+    uint64_t startNs;
+    std::thread writer;
+
+    LogRing* acquireRing();
+    void writerLoop();
+    void writeRecord(const LogRecord& record, char* line, size_t lineSize);
+
+public:
+    Logger();
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    void setMinLevel(LogLevel level) { minLevel.store(static_cast<int>(level), std::memory_order_relaxed); }
+    bool isEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= minLevel.load(std::memory_order_relaxed);
+    }
+    uint64_t getDroppedCount() const;
+
+    // Re-reads the clock records are stamped with
+    void updateClock();
+
+    template <typename... Args>
+    void log(LogLevel level, const char* format, Args... args) {
+        static_assert(sizeof...(Args) <= MAX_LOG_ARGS, "Too many log arguments");
+        if (!isEnabled(level)) return;
+        LogRing* ring = threadLogRing;
+        if (!ring || ring->owner != this) ring = acquireRing();
+
+        size_t head = ring->head.load(std::memory_order_relaxed);
+        if (head - ring->cachedTail >= LOG_QUEUE_CAPACITY) {
+            ring->cachedTail = ring->tail.load(std::memory_order_acquire);
+            if (head - ring->cachedTail >= LOG_QUEUE_CAPACITY) {
+                ring->dropped.store(ring->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        LogRecord& record = ring->records[head & (LOG_QUEUE_CAPACITY - 1)];
+        record.timestampNs = clockNs.load(std::memory_order_relaxed);
+        record.format = format;
+        record.level = level;
+        record.argCount = static_cast<uint8_t>(sizeof...(Args));
+        LogArg* arg = record.args;
+        ((*arg++ = makeLogArg(args)), ...);
+        (void)arg;
+        ring->head.store(head + 1, std::memory_order_release);
+    }
+
+    // Blocks until everything queued so far has been written
+    void flush();
+};
+
+Logger& getLogger();
+
+#define LOG_DEBUG(...) getLogger().log(LogLevel::DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) getLogger().log(LogLevel::INFO, __VA_ARGS__)
+#define LOG_WARN(...) getLogger().log(LogLevel::WARN, __VA_ARGS__)
+#define LOG_ERROR(...) getLogger().log(LogLevel::ERROR, __VA_ARGS__)
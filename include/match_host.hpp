@@ -0,0 +1,106 @@
+#pragma once
+#include "game_manager.hpp"
+#include "net_server.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct epoll_event;
+
+const int MATCHES_PER_CHUNK = 4;          // Unit of work handed to a thread
+const int MATCH_HOST_MAX_CATCH_UP = 5;    // Ticks run() makes up after a stall before skipping ahead
+
+struct MatchHostConfig {
+    uint16_t basePort = NET_DEFAULT_PORT;  // Match i listens on basePort + i; 0 picks free ports
+    int snapshotInterval = 1;
+    float timeoutSeconds = NET_TIMEOUT_SECONDS;
+};
+
+// Per-match CPU accounting, kept with the thread CPU clock so time the
+// thread spent descheduled isn't charged to the match
+struct MatchStats {
+    uint64_t ticks = 0;         // Ticks with players connected
+    uint64_t cpuNs = 0;         // Everything the match did: network, simulation, snapshots
+    uint64_t peakTickNs = 0;
+    int players = 0;
+};
+
+// Hosts many independent co-op matches in one process: each is a
+// GameManager behind its own NetServer (dedicated, so every ship belongs to
+// a remote player). One epoll set covers every match's socket, so a tick
+// reads only the sockets with packets waiting. Matches tick in parallel over
+// chunks; they share nothing, so the thread count doesn't change results.
+// A match nobody is connected to costs next to nothing, and starts over once
+// its last player leaves.
+class MatchHost {
+private:
+    struct Match {
+        GameManager game;
+        NetServer server;
+        MatchStats stats;
+        bool readable;
+
+        explicit Match(const NetServerConfig& config) : server(game, config), readable(false) {}
+    };
+
+    std::vector<std::unique_ptr<Match>> matches;  // NetServer keeps a reference to its game, so they stay put
+    MatchHostConfig config;
+    int epollFd;
+    std::vector<epoll_event> events;  // One per match
+    uint64_t tickCount;
+    uint64_t nextTickNs;      // run()'s schedule, kept across calls
+    uint64_t lateTicks;
+    uint64_t skippedTicks;
+
+    // Workers; the calling thread works too
+    uint64_t jobNowNs;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    uint64_t jobGeneration;
+    int pendingWorkers;
+    bool stopping;
+    std::atomic<int> nextChunk;
+
+    void workerLoop();
+    void runJob();
+    void runChunks();
+    void tickMatch(Match& match);
+
+public:
+    // threadCount 0 uses every hardware thread
+    MatchHost(int matchCount, int threadCount = 0, const MatchHostConfig& config = MatchHostConfig());
+    ~MatchHost();
+
+    MatchHost(const MatchHost&) = delete;
+    MatchHost& operator=(const MatchHost&) = delete;
+
+    // Opens every match's socket; false if one can't be bound
+    bool start();
+    void stop();
+
+    // One tick of every match at nowNs (inputNowNs() time)
+    void tick(uint64_t nowNs);
+    // Ticks at NET_TICK_SECONDS intervals until stop is set or untilNs
+    // passes, sleeping in between. Ticks that start late still run, up to
+    // MATCH_HOST_MAX_CATCH_UP of them; beyond that the schedule skips ahead.
+    void run(const std::atomic<bool>& stop, uint64_t untilNs = UINT64_MAX);
+
+    int getMatchCount() const { return static_cast<int>(matches.size()); }
+    int getThreadCount() const { return static_cast<int>(workers.size()) + 1; }
+    int getPlayerCount() const;
+    uint16_t getPort(int match) const { return matches[match]->server.getPort(); }
+    GameManager& getGame(int match) { return matches[match]->game; }
+    const NetServer& getServer(int match) const { return matches[match]->server; }
+    const MatchStats& getMatchStats(int match) const { return matches[match]->stats; }
+    uint64_t getTickCount() const { return tickCount; }
+    uint64_t getLateTicks() const { return lateTicks; }        // Started a whole tick after their deadline
+    uint64_t getSkippedTicks() const { return skippedTicks; }
+    // Starts every match's accounting and the late and skipped counts over
+    void resetStats();
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include "game_manager.hpp"
+#include "net_protocol.hpp"
+#include "net_socket.hpp"
+#include <cstdint>
+#include <vector>
+
+struct NetClientStats {
+    uint64_t snapshots = 0;             // Whole snapshots, however many packets each took
+    uint64_t snapshotBytes = 0;         // UDP payload only
+    uint64_t undecodable = 0;           // Baseline already gone, or malformed
+    uint64_t incompleteSnapshots = 0;   // Split snapshots given up on with parts still missing
+    uint64_t inputPackets = 0;
+    uint64_t inputBytes = 0;
+    uint64_t sendFailures = 0;          // Packets the socket refused
+    uint64_t predictionSamples = 0;
+    double predictionErrorSum = 0;      // Pixels between where we predicted our ship and where the server put it
+    float maxPredictionError = 0;
+};
+
+// Joins a NetServer and keeps a GameManager that mirrors the server's game
+// for rendering. The local ship runs ahead of the snapshots: every input is
+// applied to it right away, and when a snapshot arrives the ship is put
+// where the server had it and the inputs the server hadn't seen yet are
+// replayed on top. Call receive() and then sendInput() once per tick.
+//
+// Snapshots too big for one packet come in parts; the parts of the last few
+// ticks are gathered side by side, since jitter can interleave them, and a
+// snapshot is decoded once all of its parts are in.
+class NetClient {
+public:
+    enum class Status { DISCONNECTED, CONNECTING, CONNECTED };
+
+private:
+    static const int PARTIAL_SNAPSHOTS = 4;
+
+    struct PartialSnapshot {
+        uint32_t tick;                      // 0 = free
+        uint32_t baselineTick;
+        uint32_t processed;
+        int partCount;
+        int received;
+        size_t size;                        // Known once the last part is in
+        std::vector<uint8_t> hasPart;
+        std::vector<uint8_t> bytes;         // Part i at i * NET_SNAPSHOT_PART_BYTES
+
+        PartialSnapshot() : tick(0), baselineTick(0), processed(0), partCount(0), received(0), size(0) {}
+    };
+
+    UdpSocket socket;
+    LinkConditioner conditioner;
+    NetAddress server;
+    Status status;
+    int player;
+    uint64_t lastConnectNs;
+
+    NetState states[NET_SNAPSHOT_HISTORY];  // Received states, by tick
+    PartialSnapshot partials[PARTIAL_SNAPSHOTS];  // By tick
+    uint32_t newestTick;
+    uint32_t processedSequence;             // Newest input the newest state includes
+
+    NetInput inputs[NET_INPUT_HISTORY];
+    Vec2 predictedPositions[NET_INPUT_HISTORY];
+    uint32_t sequence;                      // Newest input sent
+    Spacecraft predicted;
+
+    GameManager view;
+    NetClientStats stats;
+    NetWriter packet;
+    std::vector<uint8_t> receiveBuffer;
+
+    void sendConnect(uint64_t nowNs);
+    void handleSnapshot(NetReader& in, bool& updated);
+    void applySnapshot(NetReader& in, uint32_t tick, uint32_t baselineTick, uint32_t processed, bool& updated);
+    bool isPredicting() const;
+    void predict(const NetInput& input);
+    void reconcile();
+
+public:
+    explicit NetClient(const LinkConditions& link = LinkConditions(), uint64_t seed = 1);
+    ~NetClient();
+
+    bool connect(const NetAddress& address, uint64_t nowNs);
+    void disconnect();
+
+    // Takes in waiting snapshots and rebuilds the view from the newest
+    void receive(uint64_t nowNs);
+    // Predicts this tick's input on the local ship and sends it, with the
+    // last few inputs again in case earlier packets were lost
+    void sendInput(const ShipInput& input, bool start, uint64_t nowNs);
+
+    Status getStatus() const { return status; }
+    bool isConnected() const { return status == Status::CONNECTED; }
+    // Connecting or connected
+    bool isActive() const { return status != Status::DISCONNECTED; }
+    int getPlayer() const { return player; }
+    const GameManager& getGame() const { return view; }
+    // Null before the first snapshot
+    const NetState* getNewestState() const;
+    const NetClientStats& getStats() const { return stats; }
+};
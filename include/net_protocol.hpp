@@ -0,0 +1,140 @@
+#pragma once
+#include "game_manager.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Wire format shared by NetServer and NetClient. Every packet starts with
+// NET_PROTOCOL_ID and a NetPacketType byte; integers are little-endian or
+// LEB128 varints (zigzag for signed values).
+const uint32_t NET_PROTOCOL_ID = 0x504e5358;   // "XSNP"
+const uint16_t NET_DEFAULT_PORT = 27960;
+const size_t NET_MAX_PACKET = 1200;            // Fits common path MTUs, so nothing relies on IP fragmentation
+const size_t NET_SNAPSHOT_PART_BYTES = 1152;   // State bytes per snapshot packet; every part but the last is full
+const int NET_MAX_SNAPSHOT_PARTS = 255;
+const size_t NET_SNAPSHOT_HEADER_BYTES = 20;   // Packet header, ticks, sequence, player and part numbers
+static_assert(NET_SNAPSHOT_HEADER_BYTES + NET_SNAPSHOT_PART_BYTES <= NET_MAX_PACKET, "Snapshot parts must fit a packet");
+const float NET_TICK_SECONDS = 1.0f / 60.0f;   // Server tick, which clients predict with
+const int NET_SNAPSHOT_HISTORY = 64;           // Ticks a baseline stays usable
+const int NET_INPUT_HISTORY = 128;             // Inputs remembered per player
+const int NET_INPUT_REDUNDANCY = 8;            // Recent inputs repeated in every input packet
+const float NET_POSITION_SCALE = 8.0f;         // Quantization steps per pixel
+const int NET_ROTATION_STEPS = 4096;           // Per turn
+const float NET_TIMEOUT_SECONDS = 5.0f;
+
+enum class NetPacketType : uint8_t {
+    CONNECT,      // Client: asking for a ship, repeated until accepted
+    ACCEPT,       // Server: player index
+    REJECT,       // Server: no free ship
+    INPUT,        // Client: newest snapshot tick it has, then its recent inputs
+    SNAPSHOT,     // Server: tick, baseline tick (0 = none), newest input applied, player, part, part count, state bytes
+    DISCONNECT
+};
+
+const uint8_t NET_BUTTON_FIRE = 1;
+const uint8_t NET_BUTTON_RELOAD = 2;   // Presses, never repeated when an input is reused
+const uint8_t NET_BUTTON_START = 4;
+
+// One tick of a player's input as it goes over the wire. The client
+// predicts with the quantized values, so it moves exactly like the server.
+struct NetInput {
+    uint32_t sequence;
+    int8_t moveX, moveY;   // Of full speed, -127..127
+    int16_t aimX, aimY;    // Aim target in 1/NET_POSITION_SCALE pixels
+    uint8_t buttons;
+};
+
+NetInput quantizeInput(uint32_t sequence, const ShipInput& input, bool start);
+ShipInput toShipInput(const NetInput& input);
+
+// Replicated state: the game quantized to small integers, every entity a
+// list of fields under a stable id. Particles aren't replicated; they are
+// cosmetic and clients can make their own.
+enum NetSection { NET_SHIPS, NET_ALIENS, NET_MOTHERSHIPS, NET_PLASMAS, NET_SECTION_COUNT };
+
+enum NetShipField { NET_SHIP_X, NET_SHIP_Y, NET_SHIP_ROTATION, NET_SHIP_SHIELD, NET_SHIP_AMMO, NET_SHIP_FIELDS };
+enum NetAlienField {
+    NET_ALIEN_X, NET_ALIEN_Y, NET_ALIEN_TYPE, NET_ALIEN_HEALTH, NET_ALIEN_SPAWN, NET_ALIEN_GENERATION,
+    NET_ALIEN_FIELDS
+};
+enum NetMothershipField { NET_MOTHERSHIP_X, NET_MOTHERSHIP_Y, NET_MOTHERSHIP_TO_SPAWN, NET_MOTHERSHIP_FIELDS };
+enum NetPlasmaField { NET_PLASMA_X, NET_PLASMA_Y, NET_PLASMA_HEADING, NET_PLASMA_GENERATION, NET_PLASMA_FIELDS };
+enum NetGlobal { NET_WAVE, NET_SCORE, NET_KILLS, NET_WAVE_ACTIVE, NET_GAME_STATE, NET_GLOBALS };
+
+const int NET_MAX_FIELDS = 6;
+const int NET_SECTION_FIELDS[NET_SECTION_COUNT] = {
+    NET_SHIP_FIELDS, NET_ALIEN_FIELDS, NET_MOTHERSHIP_FIELDS, NET_PLASMA_FIELDS
+};
+
+// Ships use the player index as id, aliens and plasmas their SlotMap slot
+// (the generation is a field, so a reused slot reads as a new entity),
+// motherships their position in the wave's list
+struct NetEntity {
+    uint32_t id;
+    int32_t fields[NET_MAX_FIELDS];
+};
+
+struct NetState {
+    uint32_t tick;   // 0 = empty
+    int32_t globals[NET_GLOBALS];
+    std::vector<NetEntity> sections[NET_SECTION_COUNT];  // Each sorted by id
+
+    NetState() : tick(0), globals() {}
+    bool operator==(const NetState& other) const;
+    bool operator!=(const NetState& other) const { return !(*this == other); }
+};
+
+// Grows as needed; clear() keeps the capacity
+class NetWriter {
+private:
+    std::vector<uint8_t> bytes;
+
+public:
+    void clear() { bytes.clear(); }
+    void writeU8(uint8_t value) { bytes.push_back(value); }
+    void writeU32(uint32_t value);
+    void writeVarint(uint32_t value);
+    void writeSignedVarint(int32_t value);
+    void writeBytes(const void* data, size_t size);
+
+    const uint8_t* getData() const { return bytes.data(); }
+    size_t getSize() const { return bytes.size(); }
+};
+
+// Reads past the end or malformed values set a sticky failure flag and read as zero
+class NetReader {
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+    bool failed;
+
+public:
+    NetReader(const void* data, size_t size);
+
+    uint8_t readU8();
+    uint32_t readU32();
+    uint32_t readVarint();
+    int32_t readSignedVarint();
+    void readBytes(void* out, size_t count);
+    void fail() { failed = true; }
+
+    bool isOk() const { return !failed; }
+    size_t getRemaining() const { return failed ? 0 : size - offset; }
+};
+
+void writePacketHeader(NetWriter& out, NetPacketType type);
+// False if the packet isn't ours
+bool readPacketHeader(NetReader& in, NetPacketType& type);
+
+void captureNetState(const GameManager& game, uint32_t tick, NetState& out);
+// Rebuilds a game for display. localPlayer's ship becomes view.spacecraft, so
+// the HUD shows it; the other ships become the wingmen.
+void applyNetState(const NetState& state, int localPlayer, GameManager& view);
+
+// Writes state as changes from baseline (null: from nothing). Per entity an
+// id step, a byte flagging the fields that changed and their differences;
+// entities missing from the state are gone. tick isn't included.
+void encodeNetState(const NetState& state, const NetState* baseline, NetWriter& out);
+// Needs the same baseline the sender used; false on malformed data
+bool decodeNetState(NetReader& in, const NetState* baseline, uint32_t tick, NetState& out);
@@ -0,0 +1,106 @@
+#pragma once
+#include "game_manager.hpp"
+#include "net_protocol.hpp"
+#include "net_socket.hpp"
+#include <cstdint>
+#include <vector>
+
+struct NetServerConfig {
+    bool hostPlayer = true;             // Player 0 is played on this machine; false for a dedicated server
+    int snapshotInterval = 1;           // Ticks between snapshots
+    float timeoutSeconds = NET_TIMEOUT_SECONDS;
+    LinkConditions link;                // Simulated trouble on everything sent
+};
+
+struct NetServerStats {
+    uint64_t snapshots = 0;
+    uint64_t fullSnapshots = 0;         // Sent without a baseline
+    uint64_t snapshotPackets = 0;       // A snapshot takes one or more, see NET_SNAPSHOT_PART_BYTES
+    uint64_t snapshotBytes = 0;         // UDP payload only
+    uint64_t oversizedSnapshots = 0;    // Too big even split into NET_MAX_SNAPSHOT_PARTS, not sent
+    uint64_t sendFailures = 0;          // Packets the socket refused
+    uint64_t packetsReceived = 0;
+    uint64_t bytesReceived = 0;
+    uint64_t inputsMissed = 0;          // Ticks a player's input hadn't arrived, so the last one was reused
+};
+
+// Authoritative co-op server. The GameManager it is given is the only real
+// game: clients send inputs, the server applies them to their ships and
+// sends every client the state as a delta from the newest snapshot that
+// client acknowledged, split into packets of at most NET_MAX_PACKET bytes.
+// Ships are handed out as players connect; a ship nobody is flying is
+// wrecked until someone takes it.
+//
+// A hosting game calls receive() and applyInputs() before its own update()
+// and sendSnapshots() after it, once per NET_TICK_SECONDS. A dedicated
+// server (hostPlayer off) calls tick() instead, which also drives player 0.
+class NetServer {
+private:
+    struct Client {
+        NetAddress address;
+        int player;
+        uint32_t processedSequence;   // Newest input applied
+        uint32_t newestSequence;      // Newest input received
+        NetInput inputs[NET_INPUT_HISTORY];
+        NetInput lastInput;
+        uint32_t ackedTick;           // Newest snapshot the client has, 0 = none
+        uint64_t lastHeardNs;
+    };
+
+    GameManager& game;
+    NetServerConfig config;
+    UdpSocket socket;
+    LinkConditioner conditioner;
+    std::vector<Client> clients;
+    ShipInput playerZeroInput;        // Dedicated servers only
+    uint32_t tickCount;
+    NetState history[NET_SNAPSHOT_HISTORY];  // Sent states, by tick
+    NetServerStats stats;
+
+    // Encoded states of the current broadcast, shared by clients on the same baseline
+    struct Encoding {
+        uint32_t baselineTick;
+        NetWriter payload;
+    };
+    std::vector<Encoding> encodings;
+    NetWriter packet;
+    std::vector<uint8_t> receiveBuffer;
+
+    Client* findClient(const NetAddress& address);
+    bool isOwned(int player) const;
+    void handleConnect(const NetAddress& from, uint64_t nowNs);
+    void handleInput(Client& client, NetReader& in);
+    void dropClient(size_t index);
+    void dropSilentClients(uint64_t nowNs);
+    void sendControl(const NetAddress& to, NetPacketType type, int player);
+    void applyStart();
+
+public:
+    NetServer(GameManager& game, const NetServerConfig& config = NetServerConfig());
+
+    // Port 0 picks a free one
+    bool start(uint16_t port = NET_DEFAULT_PORT);
+    void stop();
+    bool isRunning() const { return socket.isOpen(); }
+
+    // Takes in every waiting packet: connections, inputs, disconnects
+    void receive(uint64_t nowNs);
+    // Hands each player's next input to its ship
+    void applyInputs();
+    // Records the game as the next tick and sends it
+    void sendSnapshots(uint64_t nowNs);
+    // Dedicated server step; does nothing while nobody is connected. With
+    // readable off the socket isn't read, for callers that poll it themselves.
+    void tick(uint64_t nowNs, bool readable = true);
+
+    int getClientCount() const { return static_cast<int>(clients.size()); }
+    uint16_t getPort() const { return socket.getPort(); }
+    int getDescriptor() const { return socket.getDescriptor(); }
+    uint32_t getTick() const { return tickCount; }
+    // Aim and trigger for update() on a dedicated server, as tick() passes them
+    const ShipInput& getPlayerZeroInput() const { return playerZeroInput; }
+    // A recently sent state, or null once it has been overwritten
+    const NetState* getHistory(uint32_t tick) const;
+    const NetServerStats& getStats() const { return stats; }
+    const LinkConditioner& getConditioner() const { return conditioner; }
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include "rng.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// IPv4 address and port, host byte order
+struct NetAddress {
+    uint32_t host;
+    uint16_t port;
+
+    NetAddress(uint32_t host = 0, uint16_t port = 0) : host(host), port(port) {}
+
+    bool operator==(const NetAddress& other) const { return host == other.host && port == other.port; }
+    bool operator!=(const NetAddress& other) const { return !(*this == other); }
+};
+
+const uint32_t NET_LOCALHOST = 0x7f000001;  // 127.0.0.1
+
+// "host" or "host:port", with host a dotted IPv4 address or a name
+bool resolveAddress(const char* text, uint16_t defaultPort, NetAddress& out);
+
+// Non-blocking IPv4 UDP socket
+class UdpSocket {
+private:
+    int fd;
+
+public:
+    UdpSocket();
+    ~UdpSocket();
+
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    // Binds every interface; port 0 picks a free one
+    bool open(uint16_t port);
+    void close();
+    bool isOpen() const { return fd >= 0; }
+    uint16_t getPort() const;
+    int getDescriptor() const { return fd; }
+
+    bool send(const NetAddress& to, const void* data, size_t size);
+    // Size of the datagram read, 0 when nothing is waiting (or on error)
+    size_t receive(NetAddress& from, void* buffer, size_t capacity);
+};
+
+// Simulated network trouble, applied to outgoing packets
+struct LinkConditions {
+    float latencyMs = 0;
+    float jitterMs = 0;      // Uniform, plus or minus; reorders packets like a real link
+    float lossPercent = 0;
+
+    bool isPerfect() const { return latencyMs <= 0 && jitterMs <= 0 && lossPercent <= 0; }
+};
+
+// Sits in front of a socket's sends: drops some packets and holds the rest
+// back until their delivery time, which flush() checks. Time is passed in
+// rather than read from a clock, so a benchmark can simulate a session
+// faster than real time. Packet buffers are recycled, so a steady stream
+// doesn't allocate. With perfect conditions packets go straight out.
+class LinkConditioner {
+private:
+    struct Pending {
+        uint64_t releaseNs;
+        NetAddress to;
+        std::vector<uint8_t> data;
+    };
+
+    LinkConditions conditions;
+    Rng rng;
+    std::vector<Pending> pending;
+    std::vector<std::vector<uint8_t>> spare;
+    uint64_t sentPackets;
+    uint64_t droppedPackets;
+
+public:
+    explicit LinkConditioner(const LinkConditions& conditions = LinkConditions(), uint64_t seed = 1);
+
+    void setConditions(const LinkConditions& newConditions) { conditions = newConditions; }
+    const LinkConditions& getConditions() const { return conditions; }
+
+    // False if the socket refused the packet; a simulated loss still counts as sent
+    bool send(UdpSocket& socket, uint64_t nowNs, const NetAddress& to, const void* data, size_t size);
+    // Sends every held packet that is due; returns how many the socket refused
+    int flush(UdpSocket& socket, uint64_t nowNs);
+
+    uint64_t getSentPackets() const { return sentPackets; }
+    uint64_t getDroppedPackets() const { return droppedPackets; }
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include "game_manager.hpp"
+#include <cstdint>
+
+// Fixed-size float observation of a game, from the spacecraft's point of view
+enum ObservationShipFeature {
+    OBS_SHIP_X,          // -1..1 across the screen
+    OBS_SHIP_Y,
+    OBS_SHIP_VELOCITY_X, // -1..1 of full speed
+    OBS_SHIP_VELOCITY_Y,
+    OBS_SHIP_AIM_COS,
+    OBS_SHIP_AIM_SIN,
+    OBS_SHIELD,          // 0..1
+    OBS_AMMO,            // 0..1 of a full magazine
+    OBS_COOLDOWN,        // 0..1 of the shot cooldown
+    OBS_WAVE,            // Wave / 10
+    OBS_SHIP_FEATURES
+};
+
+// Per alien, nearest first; all zero for empty slots
+enum ObservationAlienFeature {
+    OBS_ALIEN_DX,        // Relative position, in screen widths/heights
+    OBS_ALIEN_DY,
+    OBS_ALIEN_VELOCITY_X,
+    OBS_ALIEN_VELOCITY_Y,
+    OBS_ALIEN_SCOUT,     // Type, one-hot
+    OBS_ALIEN_HUNTER,
+    OBS_ALIEN_BRUTE,
+    OBS_ALIEN_HEALTH,    // Of the toughest type's full health
+    OBS_ALIEN_FEATURES
+};
+
+// Per mothership, nearest first; all zero for empty slots
+enum ObservationMothershipFeature {
+    OBS_MOTHERSHIP_DX,
+    OBS_MOTHERSHIP_DY,
+    OBS_MOTHERSHIP_TO_SPAWN,  // Aliens left to spawn / 10
+    OBS_MOTHERSHIP_PRESENT,
+    OBS_MOTHERSHIP_FEATURES
+};
+
+const int OBS_NEAREST_ALIENS = 16;
+const int OBS_NEAREST_MOTHERSHIPS = 2;
+const int OBS_ALIENS_OFFSET = OBS_SHIP_FEATURES;
+const int OBS_MOTHERSHIPS_OFFSET = OBS_ALIENS_OFFSET + OBS_NEAREST_ALIENS * OBS_ALIEN_FEATURES;
+const int OBSERVATION_SIZE = OBS_MOTHERSHIPS_OFFSET + OBS_NEAREST_MOTHERSHIPS * OBS_MOTHERSHIP_FEATURES;
+
+const int OBS_GRID_MIN_ALIENS = 32;  // Below this a plain scan beats walking the grid
+
+// Writes OBSERVATION_SIZE floats describing a game. With more than a few
+// dozen aliens the nearest ones come from GameManager::alienGrid, which the
+// game keeps current as aliens move, searched ring by ring outward from the
+// spacecraft's cell until no unvisited cell can hold anything closer. An
+// encode only touches the cells near the spacecraft, not every alien.
+// Aliens off the grid sit in the border cells, which keeps the search exact.
+// Ties in distance go to the alien that comes first in GameManager::aliens,
+// so the grid and the scan agree.
+//
+// Holds no state and never allocates, so one encoder can be shared between
+// threads.
+class ObservationEncoder {
+private:
+    struct Neighbor {
+        float distance;  // Squared
+        uint32_t index;
+    };
+
+    int findNearestInGrid(const GameManager& game, Vec2 origin, Neighbor* nearest) const;
+    int scanNearest(const GameManager& game, Vec2 origin, Neighbor* nearest) const;
+
+public:
+    void encode(const GameManager& game, float* out) const;
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include "game_manager.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// Channels of an occupancy grid pixel, interleaved (height x width x channels)
+enum OccupancyChannel {
+    OCC_SHIP,         // Spacecraft and wingmen
+    OCC_ALIENS,       // Brightness by type, see OCC_*_VALUE
+    OCC_PLASMA,
+    OCC_MOTHERSHIPS,
+    OCC_CHANNELS
+};
+
+const int OCC_DEFAULT_SIZE = 84;
+const uint8_t OCC_SCOUT_VALUE = 85;
+const uint8_t OCC_HUNTER_VALUE = 170;
+const uint8_t OCC_BRUTE_VALUE = 255;
+const uint8_t OCC_SOLID_VALUE = 255;  // Everything but aliens
+const float OCC_MIN_RADIUS = 0.75f;   // Pixels; anything smaller still lights the pixel it's in
+
+// Top-down uint8 image of a game for vision-based agents, drawn straight from
+// the simulation state without a graphics device. The whole screen is scaled
+// onto the grid, top row first, and each entity is stamped as a filled
+// ellipse (its collision circle, squashed by the aspect ratio) into its own
+// channel. Overlaps keep the brighter value. Pixels are tested against the
+// ellipse four at a time with SSE2 where available.
+//
+// Holds no scratch, so one rasterizer can be shared between threads.
+class OccupancyRasterizer {
+private:
+    int width, height;
+    float scaleX, scaleY;  // Grid pixels per screen unit
+
+    void stamp(uint8_t* out, Vec2 position, float radius, int channel, uint8_t value) const;
+
+public:
+    explicit OccupancyRasterizer(int width = OCC_DEFAULT_SIZE, int height = OCC_DEFAULT_SIZE);
+
+    // Overwrites getByteCount() bytes
+    void rasterize(const GameManager& game, uint8_t* out) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    size_t getByteCount() const { return static_cast<size_t>(width) * height * OCC_CHANNELS; }
+};
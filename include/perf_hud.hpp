@@ -0,0 +1,39 @@
+#pragma once
+#include "render_stats.hpp"
+
+const int PERF_HUD_HISTORY = 120;            // Frames in the rolling graph
+const float PERF_HUD_FRAME_BUDGET_MS = 16.67f;
+const int PERF_HUD_ALIEN_BUDGET = 500;
+const int PERF_HUD_PLASMA_BUDGET = 200;
+const int PERF_HUD_PARTICLE_BUDGET = 5000;
+const int PERF_HUD_DRAW_CALL_BUDGET = 20000;
+const float PERF_HUD_UPLOAD_BUDGET_KB = 4096.0f;
+
+struct PerfFrameSample {
+    float simMs;
+    float renderMs;
+    float gpuMs;
+    float inputMs;   // Oldest input event to present of the previous frame; 0 without input
+};
+
+// Rolling frame-time history and counters for the performance overlay.
+// Nothing is recorded while disabled.
+class PerfHud {
+private:
+    PerfFrameSample history[PERF_HUD_HISTORY];
+    int head;
+    float summaryTimer;
+
+public:
+    bool enabled;
+    RenderStats lastRenderStats;
+
+    PerfHud();
+
+    void toggle();
+    void recordFrame(float simMs, float renderMs, float gpuMs, float inputMs,
+                     const RenderStats& renderStats, float deltaTime);
+
+    // age 0 is the most recent frame
+    const PerfFrameSample& getSample(int age) const;
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+
+// Frame profiler. PROFILE_SCOPE records a timed event into a per-thread ring
+// buffer while a capture is running; finished captures are written out as
+// Chrome/Perfetto trace JSON. Everything compiles away unless
+// XS_PROFILER_ENABLED is 1 (the default for builds without NDEBUG).
+#ifndef XS_PROFILER_ENABLED
+#ifdef NDEBUG
+#define XS_PROFILER_ENABLED 0
+#else
+#define XS_PROFILER_ENABLED 1
+#endif
+#endif
+
+const int PROFILER_CAPTURE_FRAMES = 120;
+const int PROFILER_RING_SIZE = 1 << 16;  // Events per thread, must be a power of two
+
+#if XS_PROFILER_ENABLED
+
+namespace Profiler {
+    uint64_t nowNs();
+    bool isCapturing();
+    void record(const char* name, uint64_t startNs, uint64_t endNs);
+
+    // Starts capturing at the next beginFrame() for the given number of frames
+    void requestCapture(int frames = PROFILER_CAPTURE_FRAMES);
+    // Called once per frame by the frame loop; writes the trace when done
+    void beginFrame();
+    bool writeChromeTrace(const char* path);
+}
+
+class ProfileScope {
+private:
+    const char* name;
+    uint64_t startNs;
+
+public:
+    explicit ProfileScope(const char* name)
+        : name(name), startNs(Profiler::isCapturing() ? Profiler::nowNs() : 0) {}
+    ~ProfileScope() {
+        if (startNs) Profiler::record(name, startNs, Profiler::nowNs());
+    }
+};
+
+#define XS_PROFILE_CONCAT_INNER(a, b) a##b
+#define XS_PROFILE_CONCAT(a, b) XS_PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope XS_PROFILE_CONCAT(profileScope_, __LINE__)(name)
+
+#else
+
+namespace Profiler {
+    inline bool isCapturing() { return false; }
+    inline void requestCapture(int = PROFILER_CAPTURE_FRAMES) {}
+    inline void beginFrame() {}
+    inline bool writeChromeTrace(const char*) { return false; }
+}
+
+#define PROFILE_SCOPE(name) ((void)0)
+
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+
+// Links shader programs through an on-disk cache of driver program binaries
+// (glGetProgramBinary/glProgramBinary). Entries are keyed by a hash of the
+// GL vendor, renderer and version strings plus both shader sources, so a
+// driver update or a shader edit simply misses. Without program binary
+// support, or if the cache directory can't be created, every lookup misses.
+class ProgramCache {
+private:
+    std::string directory;
+    std::string driverKey;
+    bool supported;
+    int hits;
+    int misses;
+
+    uint64_t computeKey(const char* vertexSource, const char* fragmentSource) const;
+    std::string entryPath(const char* name, uint64_t key) const;
+    GLuint loadBinary(const std::string& path, uint64_t key) const;
+    void storeBinary(GLuint program, const std::string& path, uint64_t key) const;
+
+public:
+    ProgramCache();
+
+    // Needs a current context. XS_SHADER_CACHE_DIR overrides the default
+    // $XDG_CACHE_HOME/xenostrike (or ~/.cache/xenostrike) location.
+    bool initialize();
+
+    // A linked program from the cache, or 0 on a miss. name labels the
+    // cache file and must be a string literal.
+    GLuint findProgram(const char* name, const char* vertexSource, const char* fragmentSource);
+    // Saves a program linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+    void storeProgram(const char* name, const char* vertexSource, const char* fragmentSource, GLuint program);
+
+    bool isSupported() const { return supported; }
+    int getHits() const { return hits; }
+    int getMisses() const { return misses; }
+};
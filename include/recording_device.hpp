@@ -0,0 +1,84 @@
+#pragma once
+#include "graphics_device.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+enum class DeviceCommandType : uint8_t { BEGIN_FRAME, BEGIN_PASS, UPLOAD, SET_COLOR, SET_TRANSFORM, DRAW, END_FRAME };
+
+const char* getDeviceCommandName(DeviceCommandType type);
+
+// One recorded device call. UPLOAD and SET_TRANSFORM point into the
+// recorder's float data (offset/count); DRAW uses them as first/count
+// vertices; SET_COLOR and BEGIN_FRAME carry the color.
+struct DeviceCommand {
+    DeviceCommandType type;
+    PrimitiveType primitive;
+    RenderPass pass;
+    uint32_t offset;
+    uint32_t count;
+    Color color;
+};
+
+// Traffic counters for one recorded frame. A state set is redundant when it
+// repeats the value already bound.
+struct RecordingStats {
+    int drawCalls = 0;
+    int verticesDrawn = 0;
+    int uploads = 0;
+    size_t bytesUploaded = 0;
+    int stateChanges = 0;
+    int redundantStateSets = 0;
+    int passDrawCalls[RENDER_PASS_COUNT] = {};
+    size_t passBytesUploaded[RENDER_PASS_COUNT] = {};
+};
+
+// Records every call into a structured per-frame log instead of talking to
+// a GPU. The log of the last frame can be inspected, hashed for golden
+// comparisons, dumped as JSON lines or replayed into another device.
+// Buffers are reused across frames, so steady-state recording doesn't
+// allocate.
+class RecordingDevice : public GraphicsDevice {
+private:
+    std::vector<DeviceCommand> commands;
+    std::vector<float> data;
+    RecordingStats stats;
+
+    RenderPass currentPass;
+    Color currentColor;
+    float currentTransform[16];
+    bool colorBound;
+    bool transformBound;
+    size_t lastUploadFloats;
+
+    void push(DeviceCommandType type);
+
+public:
+    RecordingDevice();
+
+    bool initialize() override { return true; }
+    void cleanup() override {}
+
+    void beginFrame(Color clearColor) override;
+    void endFrame() override;
+    void beginPass(RenderPass pass) override;
+
+    void uploadVertices(const float* vertexData, size_t floatCount) override;
+    void setColor(Color color) override;
+    void setTransform(const float* matrix) override;
+    void draw(PrimitiveType primitive, int firstVertex, int vertexCount) override;
+
+    const std::vector<DeviceCommand>& getCommands() const { return commands; }
+    const float* getData(uint32_t offset) const { return data.data() + offset; }
+    const RecordingStats& getStats() const { return stats; }
+
+    // FNV-1a over the command stream and uploaded data; identical frames
+    // hash identically, so a stored hash works as a golden reference
+    uint64_t getFrameHash() const;
+
+    // One JSON object per command
+    void writeLog(std::FILE* out) const;
+
+    // Re-issues the recorded frame on another device
+    void replay(GraphicsDevice& target) const;
+};
@@ -0,0 +1,8 @@
+#pragma once
+#include <cstddef>
+
+// Per-frame renderer traffic counters
+struct RenderStats {
+    int drawCalls = 0;
+    size_t bytesUploaded = 0;
+};
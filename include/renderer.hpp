@@ -4,18 +4,24 @@
 #include "plasma.hpp"
 #include "particle.hpp"
 #include "game_manager.hpp"
-#include <GL/glew.h>
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
 #include <vector>
 #include "mothership.hpp"
+#include "render_stats.hpp"
+#include "perf_hud.hpp"
+#include "graphics_device.hpp"
 
+// Turns game state into flat-colored primitives. All API calls go through
+// the GraphicsDevice, so the same drawing code runs on OpenGL or into a
+// recording.
 class Renderer {
 private:
-    GLuint shaderProgram;
-    GLuint VAO, VBO;
+    GraphicsDevice& device;
     std::vector<float> vertices;
+    RenderStats frameStats;
+
+    void submitVertices(PrimitiveType primitive, Color color);
+    void drawBars(Vec2 origin, const float* bases, const float* heights, int count,
+                  float barWidth, Color color);
 
     void drawLine(Vec2 start, Vec2 end, Color color);
     void drawCircle(Vec2 center, float radius, Color color);
@@ -23,11 +29,11 @@ private:
     void drawTriangle(Vec2 p1, Vec2 p2, Vec2 p3, Color color);
 
     // Visual UI elements (no text!)
-    void drawGameOverScreen(GameState state, int wave, int score);
+    void drawGameOverScreen(GameState state, int wave, int score, float pulseTime);
     void drawMenuScreen(float pulseTime);
 
 public:
-    Renderer();
+    explicit Renderer(GraphicsDevice& device);
 
     bool initialize();
     void beginFrame();
@@ -40,5 +46,15 @@ public:
     void drawShieldBar(const Spacecraft& ship);
     void drawAmmoCounter(const Spacecraft& ship);
     void drawUI(const GameManager& game);
+    void drawPerfOverlay(const PerfHud& hud, const GameManager& game);
+    // Every pass of a game frame, in order: starfield through UI
+    void drawGame(const GameManager& game);
+    void endFrame();
     void cleanup();
+
+    // Brackets a logical pass for GPU timing; starting a pass ends the previous one
+    void beginPass(RenderPass pass) { device.beginPass(pass); }
+
+    const RenderStats& getFrameStats() const { return frameStats; }
+    float getGpuFrameTimeMs() const { return device.getGpuFrameTimeMs(); }
 };
\ No newline at end of file
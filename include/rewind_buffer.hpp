@@ -0,0 +1,75 @@
+#pragma once
+#include "game_manager.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+const size_t REWIND_DEFAULT_BUDGET_MB = 32;
+const int REWIND_DEFAULT_MAX_TICKS = 600;    // 20 seconds at REWIND_RECORD_HZ
+const int REWIND_KEYFRAME_INTERVAL = 30;
+// The game records (and plays back) at this fixed rate, whatever the frame
+// rate, and not at all while a state is bigger than REWIND_MAX_STATE_BYTES:
+// recording costs about 1 us per KB of state on the main thread.
+const int REWIND_RECORD_HZ = 30;
+const size_t REWIND_MAX_STATE_BYTES = 512 * 1024;
+
+// Ring of recent per-tick game states for rewinding and rollback. Every tick
+// is encoded as a snapshot (snapshot.hpp); keyframes are stored whole, the
+// ticks in between as the XOR against their keyframe with zero runs
+// collapsed, which is mostly zeros since little changes per tick. Restoring
+// is one copy of the keyframe plus one pass over the delta, whatever the
+// distance.
+//
+// All frames live in one preallocated byte ring of the budget's size, so
+// memory stays fixed; when it fills up, the oldest keyframe is dropped
+// together with its deltas. Recording doesn't touch the heap once the
+// scratch buffers have grown to the largest state seen.
+class RewindBuffer {
+private:
+    struct Frame {
+        uint64_t keyframeSequence;  // Own sequence for keyframes
+        size_t offset;              // Into storage
+        uint32_t storedBytes;
+        uint32_t rawBytes;          // Encoded snapshot size
+    };
+
+    std::vector<uint8_t> storage;
+    std::vector<Frame> frames;       // Ring indexed by sequence % size
+    uint64_t oldestSequence;
+    uint64_t nextSequence;
+    size_t writeOffset;              // End of the newest frame in storage
+    int keyframeInterval;
+
+    std::vector<uint8_t> encoded;    // Scratch: this tick's snapshot
+    std::vector<uint8_t> delta;      // Scratch: its delta
+    std::vector<uint8_t> decoded;    // Scratch: the state being restored
+
+    uint64_t rawBytesRecorded;
+    uint64_t storedBytesRecorded;
+
+    Frame& getFrame(uint64_t sequence) { return frames[sequence % frames.size()]; }
+    const Frame& getFrame(uint64_t sequence) const { return frames[sequence % frames.size()]; }
+    bool isKeyframe(uint64_t sequence) const { return getFrame(sequence).keyframeSequence == sequence; }
+    bool overlapsLiveFrames(size_t offset, size_t bytes) const;
+    void evictOldestGroup();
+    bool allocate(size_t bytes, size_t& offset);
+
+public:
+    RewindBuffer(size_t budgetBytes = REWIND_DEFAULT_BUDGET_MB * 1024 * 1024,
+                 int maxTicks = REWIND_DEFAULT_MAX_TICKS, int keyframeInterval = REWIND_KEYFRAME_INTERVAL);
+
+    // Once per tick, after the update
+    void record(const GameManager& game);
+    // Replaces the game's state with the one recorded ticksBack ticks before
+    // the newest (0 = newest); false if that tick is no longer held
+    bool restore(int ticksBack, GameManager& game);
+    // Forgets the newest ticks, e.g. before re-simulating from a restored tick
+    void discardNewest(int count);
+    void clear();
+
+    int getTickCount() const { return static_cast<int>(nextSequence - oldestSequence); }
+    size_t getBudgetBytes() const { return storage.size(); }
+    size_t getUsedBytes() const;
+    // Raw snapshot bytes per stored byte, over everything recorded so far
+    double getCompressionRatio() const;
+};
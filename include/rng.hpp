@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+
+// PCG32 (O'Neill): small, fast and fully described by two integers, so a
+// game's random stream can be saved, restored and replayed exactly. Replaces
+// rand(), whose hidden global state can't be serialized.
+class Rng {
+public:
+    uint64_t state;
+    uint64_t increment;  // Stream selector, always odd
+
+    explicit Rng(uint64_t seed = 0x853c49e6748fea9bull, uint64_t stream = 0xda3e39cb94b95bdbull) {
+        this->seed(seed, stream);
+    }
+
+    void seed(uint64_t seed, uint64_t stream = 0xda3e39cb94b95bdbull) {
+        state = 0;
+        increment = (stream << 1) | 1;
+        next();
+        state += seed;
+        next();
+    }
+
+    uint32_t next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ull + increment;
+        uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rotation = static_cast<uint32_t>(old >> 59);
+        return (xorshifted >> rotation) | (xorshifted << ((32 - rotation) & 31));
+    }
+
+    // 0..bound-1, drop-in for rand() % bound
+    int nextInt(int bound) { return static_cast<int>(next() % static_cast<uint32_t>(bound)); }
+};
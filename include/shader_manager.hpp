@@ -0,0 +1,76 @@
+#pragma once
+#include "program_cache.hpp"
+#include <GL/glew.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+const float SHADER_RELOAD_POLL_SECONDS = 0.5f;  // Source file mtime checks, hot reload builds
+
+// Owns every shader program. Programs come from the binary cache when
+// possible; otherwise compile and link are issued without waiting and polled
+// once per frame through GL_KHR_parallel_shader_compile, so the driver can
+// build them on its own threads. A finished program is swapped in at the
+// next update() and the previous one stays in use until then; a failed
+// compile keeps the previous program. Drivers without the extension finish
+// the work the first time the status is queried.
+//
+// Builds with XS_SHADER_HOT_RELOAD read the sources from disk (relative to
+// the working directory) when present, falling back to the embedded copies,
+// and recompile a program whenever one of its files changes.
+class ShaderManager {
+private:
+    struct ShaderProgram {
+        const char* name;
+        const char* vertexPath;
+        const char* fragmentPath;
+        GLuint program;          // In use, 0 until the first build finishes
+        uint32_t generation;     // Bumped whenever program changes
+
+        // Build in flight
+        GLuint pendingProgram;
+        GLuint pendingVertex;
+        GLuint pendingFragment;
+        std::string vertexSource;
+        std::string fragmentSource;
+
+        int64_t vertexStamp;     // Source mtimes, -1 when not on disk
+        int64_t fragmentStamp;
+    };
+
+    std::vector<ShaderProgram> programs;
+    ProgramCache cache;
+    bool parallelCompile;
+    std::chrono::steady_clock::time_point nextReloadPoll;
+
+    bool loadSources(ShaderProgram& entry) const;
+    void startBuild(ShaderProgram& entry);
+    void cancelBuild(ShaderProgram& entry);
+    bool isBuildComplete(const ShaderProgram& entry) const;
+    void finishBuild(ShaderProgram& entry);
+    void checkForEdits();
+
+public:
+    ShaderManager();
+
+    // Needs a current context
+    bool initialize();
+    void cleanup();
+
+    // Starts building a program; the returned id is valid immediately, the
+    // program once ready. Names and paths must be string literals.
+    // -1 if the sources can't be found.
+    int addProgram(const char* name, const char* vertexPath, const char* fragmentPath);
+
+    // Once per frame: swaps in finished programs and, in hot reload builds,
+    // restarts builds for edited sources
+    void update();
+    // Blocks until every pending build has finished
+    void finishPending();
+
+    GLuint getProgram(int id) const { return programs[id].program; }
+    uint32_t getGeneration(int id) const { return programs[id].generation; }
+    bool isPending(int id) const { return programs[id].pendingProgram != 0; }
+    bool hasParallelCompile() const { return parallelCompile; }
+};
@@ -1,6 +1,16 @@
 #pragma once
 #include <algorithm>
 
+// Every field of a ShieldSystem, for saving and restoring it
+struct ShieldState {
+    float maxEnergy;
+    float currentEnergy;
+    float regenRate;
+    float regenDelay;
+    float timeSinceLastHit;
+    float absorptionEfficiency;
+};
+
 class ShieldSystem {
 private:
     float maxEnergy;
@@ -19,4 +29,7 @@ public:
     float getPercentage() const { return currentEnergy / maxEnergy; }
     bool isDepleted() const { return currentEnergy <= 0; }
     float getCurrent() const { return currentEnergy; }
+
+    ShieldState getState() const;
+    void setState(const ShieldState& state);
 };
@@ -0,0 +1,156 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Stable reference to an entity stored in a SlotMap. A handle stays valid
+// until its entity is removed; after that the generation no longer matches
+// and lookups fail instead of returning whatever reused the slot.
+struct EntityHandle {
+    uint32_t index;
+    uint32_t generation;
+
+    EntityHandle(uint32_t index = UINT32_MAX, uint32_t generation = 0)
+        : index(index), generation(generation) {}
+
+    bool isValid() const { return generation != 0; }
+    bool operator==(const EntityHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+};
+
+// Slot map: O(1) insert/remove/lookup by handle, with the elements kept
+// densely packed for iteration. Removal moves the last element into the
+// hole: handles stay valid, but that element's dense index and its place in
+// iteration order change.
+template <typename T>
+class SlotMap {
+private:
+    struct Slot {
+        uint32_t denseIndex;  // Next free slot while the slot is unused
+        uint32_t generation;
+    };
+
+    std::vector<T> dense;
+    std::vector<uint32_t> denseToSlot;
+    std::vector<Slot> slots;
+    uint32_t freeHead = UINT32_MAX;
+
+    EntityHandle allocateSlot() {
+        uint32_t slotIndex;
+        if (freeHead != UINT32_MAX) {
+            slotIndex = freeHead;
+            freeHead = slots[slotIndex].denseIndex;
+        } else {
+            slotIndex = static_cast<uint32_t>(slots.size());
+            slots.push_back(Slot{0, 1});
+        }
+        slots[slotIndex].denseIndex = static_cast<uint32_t>(dense.size() - 1);
+        denseToSlot.push_back(slotIndex);
+        return EntityHandle(slotIndex, slots[slotIndex].generation);
+    }
+
+    void releaseSlot(uint32_t slotIndex) {
+        Slot& slot = slots[slotIndex];
+        slot.generation++;
+        if (slot.generation == 0) slot.generation = 1;  // 0 marks invalid handles
+        slot.denseIndex = freeHead;
+        freeHead = slotIndex;
+    }
+
+public:
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    EntityHandle insert(const T& value) {
+        dense.push_back(value);
+        return allocateSlot();
+    }
+
+    template <typename... Args>
+    EntityHandle emplace(Args&&... args) {
+        dense.emplace_back(std::forward<Args>(args)...);
+        return allocateSlot();
+    }
+
+    bool contains(EntityHandle handle) const {
+        return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+    }
+
+    T* get(EntityHandle handle) {
+        return contains(handle) ? &dense[slots[handle.index].denseIndex] : nullptr;
+    }
+
+    const T* get(EntityHandle handle) const {
+        return contains(handle) ? &dense[slots[handle.index].denseIndex] : nullptr;
+    }
+
+    // Position of a live entity in iteration order; the handle must be valid
+    size_t indexOf(EntityHandle handle) const { return slots[handle.index].denseIndex; }
+
+    EntityHandle handleAt(size_t denseIndex) const {
+        uint32_t slotIndex = denseToSlot[denseIndex];
+        return EntityHandle(slotIndex, slots[slotIndex].generation);
+    }
+
+    void removeAt(size_t denseIndex) {
+        releaseSlot(denseToSlot[denseIndex]);
+
+        size_t last = dense.size() - 1;
+        if (denseIndex != last) {
+            dense[denseIndex] = std::move(dense[last]);
+            denseToSlot[denseIndex] = denseToSlot[last];
+            slots[denseToSlot[denseIndex]].denseIndex = static_cast<uint32_t>(denseIndex);
+        }
+        dense.pop_back();
+        denseToSlot.pop_back();
+    }
+
+    bool remove(EntityHandle handle) {
+        if (!contains(handle)) return false;
+        removeAt(slots[handle.index].denseIndex);
+        return true;
+    }
+
+    // Removes every element matching pred by swap-removal: survivors keep
+    // their handles, but some move to new dense positions and the order changes
+    template <typename Pred>
+    size_t removeIf(Pred pred) {
+        size_t removed = 0;
+        size_t i = 0;
+        while (i < dense.size()) {
+            if (pred(dense[i])) {
+                removeAt(i);
+                removed++;
+            } else {
+                i++;
+            }
+        }
+        return removed;
+    }
+
+    void clear() {
+        for (uint32_t slotIndex : denseToSlot) releaseSlot(slotIndex);
+        dense.clear();
+        denseToSlot.clear();
+    }
+
+    void reserve(size_t capacity) {
+        dense.reserve(capacity);
+        denseToSlot.reserve(capacity);
+        slots.reserve(capacity);
+    }
+
+    size_t size() const { return dense.size(); }
+    bool empty() const { return dense.empty(); }
+
+    T& operator[](size_t denseIndex) { return dense[denseIndex]; }
+    const T& operator[](size_t denseIndex) const { return dense[denseIndex]; }
+
+    iterator begin() { return dense.begin(); }
+    iterator end() { return dense.end(); }
+    const_iterator begin() const { return dense.begin(); }
+    const_iterator end() const { return dense.end(); }
+};
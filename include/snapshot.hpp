@@ -0,0 +1,157 @@
+#pragma once
+#include "game_manager.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Records are mapped straight from disk, so the host must match the file
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Snapshots are little-endian and read without conversion"
+#endif
+
+const uint32_t SNAPSHOT_MAGIC = 0x4e535358;  // "XSSN"
+const uint32_t SNAPSHOT_VERSION = 3;  // 2: co-op wingmen, 3: alien steer slots
+
+// Fixed-layout records: only 4- and 8-byte fields, no implicit padding,
+// booleans and enums stored as uint32. Changing any of them means bumping
+// SNAPSHOT_VERSION.
+struct SpacecraftRecord {
+    float positionX, positionY;
+    float velocityX, velocityY;
+    float rotation;
+    float shootCooldown;
+    int32_t ammo;
+    int32_t maxAmmo;
+    float thrusterPulse;
+    float shieldMaxEnergy;
+    float shieldCurrentEnergy;
+    float shieldRegenRate;
+    float shieldRegenDelay;
+    float shieldTimeSinceLastHit;
+    float shieldAbsorptionEfficiency;
+    uint32_t reserved;
+};
+
+struct MothershipRecord {
+    float positionX, positionY;
+    float velocityX, velocityY;
+    float size;
+    uint32_t active;
+    float animationTime;
+    float spawnTimer;
+    float spawnInterval;
+    int32_t aliensToSpawn;
+};
+
+struct AlienRecord {
+    float positionX, positionY;
+    float velocityX, velocityY;
+    uint32_t type;
+    float health;
+    float speed;
+    uint32_t active;
+    float spawnAnimation;
+    float animationTime;
+    float pendingSteerTime;
+    uint32_t steerSlot;
+};
+
+struct PlasmaRecord {
+    float positionX, positionY;
+    float velocityX, velocityY;
+    uint32_t active;
+    float lifetime;
+};
+
+struct ParticleRecord {
+    float positionX, positionY;
+    float velocityX, velocityY;
+    float lifetime;
+    float maxLifetime;
+    float colorR, colorG, colorB, colorA;
+};
+
+// Followed by the motherships, aliens, plasmas, particles and wingmen
+// arrays, in that order, each in GameManager's iteration order
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerBytes;
+    uint32_t aliensSpawned;
+    uint64_t totalBytes;
+    uint64_t rngState;
+    uint64_t rngIncrement;
+
+    uint32_t mothershipCount;
+    uint32_t alienCount;
+    uint32_t plasmaCount;
+    uint32_t particleCount;
+
+    int32_t wave;
+    int32_t score;
+    int32_t killCount;
+    uint32_t waveActive;
+    uint32_t gameState;
+    float stateTimer;
+    uint32_t tickCount;
+    uint32_t wingmanCount;
+
+    SpacecraftRecord spacecraft;
+};
+
+static_assert(sizeof(SpacecraftRecord) == 64, "SpacecraftRecord layout changed");
+static_assert(sizeof(MothershipRecord) == 40, "MothershipRecord layout changed");
+static_assert(sizeof(AlienRecord) == 48, "AlienRecord layout changed");
+static_assert(sizeof(PlasmaRecord) == 24, "PlasmaRecord layout changed");
+static_assert(sizeof(ParticleRecord) == 40, "ParticleRecord layout changed");
+static_assert(sizeof(SnapshotHeader) == 152, "SnapshotHeader layout changed");
+static_assert(sizeof(SnapshotHeader) % 8 == 0, "Records after the header must stay aligned");
+
+size_t getSnapshotSize(const GameManager& game);
+// Serializes the whole game state into one contiguous buffer (resized to fit)
+void encodeSnapshot(const GameManager& game, std::vector<uint8_t>& out);
+// Encodes, then writes the buffer with a single write()
+bool saveSnapshot(const GameManager& game, const char* path);
+
+// Read-only view of an encoded snapshot. Records are read in place from the
+// caller's buffer or a private read-only mapping of the file; nothing is
+// copied until restore().
+class SnapshotView {
+private:
+    const uint8_t* data;
+    size_t size;
+    void* mapping;
+    size_t mappingSize;
+
+    template <typename T>
+    const T* section(size_t offset) const { return reinterpret_cast<const T*>(data + offset); }
+    size_t getAliensOffset() const;
+    size_t getPlasmasOffset() const;
+    size_t getParticlesOffset() const;
+    size_t getWingmenOffset() const;
+
+public:
+    SnapshotView();
+    ~SnapshotView();
+
+    SnapshotView(const SnapshotView&) = delete;
+    SnapshotView& operator=(const SnapshotView&) = delete;
+
+    // Borrows bytes (must be 8-byte aligned and outlive the view); false if
+    // they aren't a valid snapshot of this version
+    bool open(const void* bytes, size_t byteCount);
+    // Memory-maps the file
+    bool openFile(const char* path);
+    void close();
+
+    const SnapshotHeader& getHeader() const { return *section<SnapshotHeader>(0); }
+    const MothershipRecord* getMotherships() const { return section<MothershipRecord>(sizeof(SnapshotHeader)); }
+    const AlienRecord* getAliens() const { return section<AlienRecord>(getAliensOffset()); }
+    const PlasmaRecord* getPlasmas() const { return section<PlasmaRecord>(getPlasmasOffset()); }
+    const ParticleRecord* getParticles() const { return section<ParticleRecord>(getParticlesOffset()); }
+    const SpacecraftRecord* getWingmen() const { return section<SpacecraftRecord>(getWingmenOffset()); }
+
+    // Replaces the game's state with the snapshot's. Entity handles from
+    // before the restore are not preserved.
+    void restore(GameManager& game) const;
+};
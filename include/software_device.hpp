@@ -0,0 +1,95 @@
+#pragma once
+#include "graphics_device.hpp"
+#include "constants.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+const int SOFTWARE_TILE_SIZE = 64;  // Pixels, must be a multiple of 4
+
+// CPU rasterizer for machines without a GPU. Draws are transformed and
+// binned into screen tiles as they arrive; endFrame() rasterizes the tiles
+// in parallel, each tile replaying its draws in submission order so
+// alpha blending matches GL. Edge functions and blending work on four
+// pixels at a time with SSE2 where available. Pixels are RGBA8, top row
+// first.
+class SoftwareDevice : public GraphicsDevice {
+private:
+    struct DrawRecord {
+        PrimitiveType primitive;
+        uint32_t firstVertex;  // Into screenVertices, x/y pairs
+        uint32_t vertexCount;
+        uint32_t color;        // RGBA8, alpha already scaled to 0..255
+        int alpha;             // Blend weight 0..128
+        bool convex;           // Fan outline is convex: filled as spans
+    };
+
+    int width, height, stride;
+    int tilesX, tilesY;
+    std::vector<uint32_t> pixels;
+    std::vector<float> screenVertices;
+    std::vector<float> uploaded;
+    std::vector<DrawRecord> draws;
+    std::vector<std::vector<uint32_t>> tileBins;  // Draw indices per tile
+
+    uint32_t clearColor;
+    Color currentColor;
+    float transform[16];
+    float lastFrameMs;
+
+    // Tile workers; the calling thread works too
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    uint64_t jobGeneration;
+    int pendingWorkers;
+    bool stopping;
+    std::atomic<int> nextTile;
+
+    void workerLoop();
+    void runTiles();
+    void rasterizeTile(int tile);
+    void rasterizeTriangle(const int* tileRect, const float* a, const float* b, const float* c,
+                           const DrawRecord& draw);
+    void rasterizeConvex(const int* tileRect, const float* v, int count, const DrawRecord& draw);
+    void blendSpan(uint32_t* row, int x0, int x1, const DrawRecord& draw);
+
+public:
+    // threadCount 0 uses every hardware thread
+    SoftwareDevice(int width = WINDOW_WIDTH, int height = WINDOW_HEIGHT, int threadCount = 0);
+    ~SoftwareDevice();
+
+    SoftwareDevice(const SoftwareDevice&) = delete;
+    SoftwareDevice& operator=(const SoftwareDevice&) = delete;
+
+    bool initialize() override { return true; }
+    void cleanup() override {}
+
+    void beginFrame(Color clearColor) override;
+    void endFrame() override;
+    void beginPass(RenderPass) override {}
+
+    void uploadVertices(const float* data, size_t floatCount) override;
+    void setColor(Color color) override;
+    void setTransform(const float* matrix) override;
+    void draw(PrimitiveType primitive, int firstVertex, int vertexCount) override;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getThreadCount() const { return static_cast<int>(workers.size()) + 1; }
+    // Wall time of the last endFrame() rasterization
+    float getLastFrameMs() const { return lastFrameMs; }
+
+    // Row pointer into the framebuffer, valid until the next beginFrame()
+    const uint32_t* getRow(int y) const { return pixels.data() + static_cast<size_t>(y) * stride; }
+    // Copies the frame as tightly packed RGBA8
+    void readPixels(uint8_t* rgba) const;
+    // FNV-1a over the visible pixels, for golden-image comparisons
+    uint64_t getImageHash() const;
+    // Binary PPM (alpha dropped)
+    bool writePpm(const char* path) const;
+};
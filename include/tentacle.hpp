@@ -8,12 +8,24 @@ private:
     float baseAngle;
     float length;
     int segments;
+    float baseCos, baseSin;  // Cached direction of baseAngle
 
 public:
     float phase;
 
-    Tentacle(float angle, float len);
+    Tentacle(float angle = 0, float len = 0);
 
     Vec2 getSegmentPosition(int segment, float animTime) const;
     int getSegmentCount() const { return segments; }
+    float getBaseAngle() const { return baseAngle; }
+    float getLength() const { return length; }
+};
+
+// Fixed-capacity tentacle layout shared by every alien of the same type
+struct TentacleSet {
+    Tentacle tentacles[MAX_TENTACLES];
+    int count = 0;
+
+    const Tentacle* begin() const { return tentacles; }
+    const Tentacle* end() const { return tentacles + count; }
 };
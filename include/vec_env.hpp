@@ -0,0 +1,109 @@
+#pragma once
+#include "game_manager.hpp"
+#include "observation_encoder.hpp"
+#include "occupancy_grid.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Per-environment action: six floats
+enum EnvAction {
+    ENV_ACTION_MOVE_X,   // -1..1
+    ENV_ACTION_MOVE_Y,
+    ENV_ACTION_AIM_X,    // Aim direction, any length
+    ENV_ACTION_AIM_Y,
+    ENV_ACTION_FIRE,     // Fires when > 0.5
+    ENV_ACTION_RELOAD,   // Reloads when > 0.5 (costs score, as in the game)
+    ENV_ACTION_SIZE
+};
+
+const int ENV_OBSERVATION_SIZE = OBSERVATION_SIZE;  // See observation_encoder.hpp
+
+// Values written to the dones array; nonzero means the environment was reset
+// and its observation is the first of a new episode
+const uint8_t ENV_DONE_TERMINATED = 1;  // Game over
+const uint8_t ENV_DONE_TRUNCATED = 2;   // Hit maxEpisodeTicks
+
+const float ENV_SCORE_REWARD_SCALE = 0.01f;
+const float ENV_GAME_OVER_REWARD = -1.0f;
+const int ENV_ENVS_PER_CHUNK = 16;       // Unit of work handed to a thread
+
+struct EnvConfig {
+    int maxEpisodeTicks = 60 * 60 * 5;   // 5 minutes of play
+    int frameSkip = 1;                   // Ticks per step, repeating the action
+    bool spawnEffects = false;           // Cosmetic particles, only useful when rendering
+    int imageWidth = OCC_DEFAULT_SIZE;   // Occupancy grids written by render()
+    int imageHeight = OCC_DEFAULT_SIZE;
+};
+
+// A batch of independent games stepped together for training agents.
+// Observations, actions, rewards and dones are flat caller-owned arrays,
+// one row per environment, written in place. Steps run in parallel over
+// chunks of environments; a game only ever depends on its own seed and
+// actions, so results don't depend on the thread count. Finished
+// environments reset themselves with a seed drawn from their own stream.
+class VecEnv {
+private:
+    struct Env {
+        GameManager game;
+        Rng episodeSeeds;
+        int episodeTicks;
+    };
+
+    enum JobType { JOB_RESET, JOB_STEP, JOB_RENDER };
+
+    std::vector<Env> envs;
+    EnvConfig config;
+    ObservationEncoder encoder;
+    OccupancyRasterizer rasterizer;
+
+    // Arguments of the job in flight
+    const float* jobActions;
+    float* jobObservations;
+    float* jobRewards;
+    uint8_t* jobDones;
+    uint8_t* jobImages;
+    JobType jobType;
+
+    // Workers; the calling thread works too
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    uint64_t jobGeneration;
+    int pendingWorkers;
+    bool stopping;
+    std::atomic<int> nextChunk;
+
+    void workerLoop();
+    void runJob();
+    void runChunks();
+    void startEpisode(Env& env);
+    void stepEnv(int index);
+
+public:
+    // threadCount 0 uses every hardware thread
+    VecEnv(int envCount, int threadCount = 0, const EnvConfig& config = EnvConfig());
+    ~VecEnv();
+
+    VecEnv(const VecEnv&) = delete;
+    VecEnv& operator=(const VecEnv&) = delete;
+
+    // Starts every environment over; environment i is seeded from (seed, i).
+    // observations: getEnvCount() * ENV_OBSERVATION_SIZE floats.
+    void reset(uint64_t seed, float* observations);
+    // actions: getEnvCount() * ENV_ACTION_SIZE floats; rewards and dones one per environment
+    void step(const float* actions, float* observations, float* rewards, uint8_t* dones);
+    // Occupancy grids of the current states (see occupancy_grid.hpp), in
+    // parallel like step(). images: getEnvCount() * getImageBytes() bytes.
+    void render(uint8_t* images);
+
+    int getEnvCount() const { return static_cast<int>(envs.size()); }
+    int getThreadCount() const { return static_cast<int>(workers.size()) + 1; }
+    size_t getImageBytes() const { return rasterizer.getByteCount(); }
+    const EnvConfig& getConfig() const { return config; }
+    const GameManager& getGame(int index) const { return envs[index].game; }
+};
@@ -0,0 +1,46 @@
+#pragma once
+/* C interface to VecEnv (vec_env.hpp) for loading the environments from
+ * other runtimes, built as libxenostrike_env.so by `make env-lib`. All
+ * arrays are caller-owned, row-major with one row per environment, and are
+ * read or written in place. No function throws; creation returns NULL on
+ * failure. */
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define XS_ENV_API __attribute__((visibility("default")))
+#else
+#define XS_ENV_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct XsVecEnv XsVecEnv;
+
+/* thread_count 0 uses every hardware thread; frame_skip is the number of
+ * game ticks per step (the action repeats); max_episode_ticks 0 keeps the
+ * default */
+XS_ENV_API XsVecEnv* xs_env_create(int env_count, int thread_count, int frame_skip, int max_episode_ticks);
+XS_ENV_API void xs_env_destroy(XsVecEnv* env);
+
+XS_ENV_API int xs_env_count(const XsVecEnv* env);
+XS_ENV_API int xs_env_observation_size(void);
+XS_ENV_API int xs_env_action_size(void);
+
+/* observations: count * observation_size floats */
+XS_ENV_API void xs_env_reset(XsVecEnv* env, uint64_t seed, float* observations);
+/* actions: count * action_size floats; rewards: count floats; dones: count
+ * bytes, 1 = game over, 2 = truncated, after which the environment has
+ * already been reset */
+XS_ENV_API void xs_env_step(XsVecEnv* env, const float* actions, float* observations, float* rewards, uint8_t* dones);
+
+/* Top-down occupancy grids of the current states, height x width x 4
+ * uint8 channels (ship, aliens, plasma, motherships); images: count *
+ * image_size bytes */
+XS_ENV_API int xs_env_image_size(const XsVecEnv* env);
+XS_ENV_API void xs_env_render(XsVecEnv* env, uint8_t* images);
+
+#ifdef __cplusplus
+}
+#endif
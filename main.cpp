@@ -5,56 +5,232 @@
 #include <algorithm>
 #include <ctime>
 #include <string>
+#include <cstring>
+#include <cstdlib>
 #include <glm/gtc/type_ptr.hpp>
 #include "include/game_manager.hpp"
 #include "include/renderer.hpp"
+#include "include/gl_device.hpp"
+#include "include/gl_frame_reader.hpp"
+#include "include/frame_capture.hpp"
 #include "include/mothership.hpp"
+#include "include/frame_arena.hpp"
+#include "include/alloc_stats.hpp"
+#include "include/logger.hpp"
+#include "include/profiler.hpp"
+#include "include/perf_hud.hpp"
+#include "include/input.hpp"
+#include "include/rewind_buffer.hpp"
+#include "include/snapshot.hpp"
+#include "include/net_client.hpp"
+#include "include/net_server.hpp"
+#include "include/net_socket.hpp"
+#include <chrono>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
-#include "shader.hpp"
 #include <glm/glm.hpp>
 
 // Global game objects
 GameManager game;
-Renderer renderer;
-Vec2 mousePosition;
-bool mousePressed = false;
-bool spacePressed = false;
+GlDevice glDevice;
+Renderer renderer(glDevice);
+InputSystem input;
+FramePacer framePacer;
+FrameAllocTracker allocTracker;
+PerfHud perfHud;
+FrameCapture frameCapture;
+RewindBuffer rewindBuffer;
+GlFrameReader frameReader;
+NetServer netServer(game);  // --host: co-op players join this game
+NetClient netClient;        // --join: this window shows someone else's game
+int captureCount = 0;
+const int ALLOC_REPORT_FRAMES = 300;
+const float REWIND_TICK_SECONDS = 1.0f / REWIND_RECORD_HZ;
+float rewindAccumulator = 0;
+bool rewindTooLarge = false;
 
+// Callbacks only queue game input; it is applied when sampled right before the sim step
 void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
-    if (button == GLFW_MOUSE_BUTTON_LEFT) {
-        mousePressed = (action == GLFW_PRESS || action == GLFW_REPEAT);
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action != GLFW_REPEAT) {
+        input.pushAction(InputAction::FIRE, action == GLFW_PRESS);
     }
 }
 
 void cursorPositionCallback(GLFWwindow* window, double xpos, double ypos) {
-    mousePosition.x = static_cast<float>(xpos);
-    mousePosition.y = WINDOW_HEIGHT - static_cast<float>(ypos);
+    input.pushCursor(Vec2(static_cast<float>(xpos), WINDOW_HEIGHT - static_cast<float>(ypos)));
 }
 
-void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
-    if (key == GLFW_KEY_SPACE && action == GLFW_PRESS) {
+bool mapGameKey(int key, InputAction& action) {
+    switch (key) {
+    case GLFW_KEY_W: action = InputAction::MOVE_UP; return true;
+    case GLFW_KEY_S: action = InputAction::MOVE_DOWN; return true;
+    case GLFW_KEY_A: action = InputAction::MOVE_LEFT; return true;
+    case GLFW_KEY_D: action = InputAction::MOVE_RIGHT; return true;
+    case GLFW_KEY_SPACE: action = InputAction::START; return true;
+    case GLFW_KEY_R: action = InputAction::RELOAD; return true;
+    case GLFW_KEY_BACKSPACE: action = InputAction::REWIND; return true;
+    default: return false;
+    }
+}
+
+Vec2 getMoveVelocity(const InputFrame& frame) {
+    Vec2 velocity(0, 0);
+    if (frame.isHeld(InputAction::MOVE_UP)) velocity.y += SPACECRAFT_SPEED * 60.0f;
+    if (frame.isHeld(InputAction::MOVE_DOWN)) velocity.y -= SPACECRAFT_SPEED * 60.0f;
+    if (frame.isHeld(InputAction::MOVE_LEFT)) velocity.x -= SPACECRAFT_SPEED * 60.0f;
+    if (frame.isHeld(InputAction::MOVE_RIGHT)) velocity.x += SPACECRAFT_SPEED * 60.0f;
+    return velocity;
+}
+
+void applyInput(const InputFrame& frame) {
+    for (int i = 0; i < frame.getPresses(InputAction::START); i++) {
         // SPACE handles starting game, restarting, and starting waves
         if (game.gameState == GameState::GAME_OVER_SHIELD ||
             game.gameState == GameState::GAME_OVER_AMMO ||
             game.gameState == GameState::MENU) {
             game.reset();
-            std::cout << "\n=== NEW GAME STARTED ===" << std::endl;
+            LOG_INFO("=== NEW GAME STARTED ===");
         } else if (game.gameState == GameState::PLAYING && !game.waveActive) {
             game.startWave();
         }
     }
-    if (key == GLFW_KEY_R && action == GLFW_PRESS && game.gameState == GameState::PLAYING) {
+
+    if (game.gameState != GameState::PLAYING) return;
+
+    for (int i = 0; i < frame.getPresses(InputAction::RELOAD); i++) {
         game.spacecraft.reload(game.score);
-        std::cout << "Reloaded! (-50 score)" << std::endl;
+        LOG_INFO("Reloaded! (-50 score)");
+    }
+
+    game.spacecraft.velocity = getMoveVelocity(frame);
+}
+
+// Rewind ticks are REWIND_TICK_SECONDS apart whatever the frame rate, so N
+// ticks back is always the same time. Slow frames don't record a state twice.
+bool isRewindTickDue(float deltaTime) {
+    rewindAccumulator += deltaTime;
+    if (rewindAccumulator < REWIND_TICK_SECONDS) return false;
+    rewindAccumulator = std::fmod(rewindAccumulator, REWIND_TICK_SECONDS);
+    return true;
+}
+
+void recordRewind(float deltaTime) {
+    if (!isRewindTickDue(deltaTime)) return;
+    // Big fights aren't worth a millisecond or more of every tick; the history
+    // is dropped so a later rewind can't jump across the gap
+    bool tooLarge = getSnapshotSize(game) > REWIND_MAX_STATE_BYTES;
+    if (tooLarge != rewindTooLarge) {
+        rewindTooLarge = tooLarge;
+        if (tooLarge) {
+            rewindBuffer.clear();
+            LOG_INFO("Rewind paused: game state over {} KB", static_cast<int>(REWIND_MAX_STATE_BYTES / 1024));
+        } else {
+            LOG_INFO("Rewind recording again");
+        }
+    }
+    if (!tooLarge) rewindBuffer.record(game);
+}
+
+void playRewind(float deltaTime) {
+    if (!isRewindTickDue(deltaTime)) return;
+    rewindBuffer.discardNewest(1);
+    rewindBuffer.restore(0, game);
+}
+
+// Co-op runs at the server's fixed tick: whole ticks of the frame's time are
+// stepped, and presses only count on the first of them. Presses from frames
+// too short to reach a tick wait for the next tick that runs.
+void stepNetworked(InputFrame frame, float deltaTime) {
+    static float accumulator = 0;
+    static int pendingPresses[INPUT_ACTION_COUNT] = {};  // Sampled on frames no tick was due
+    accumulator = std::min(accumulator + deltaTime, 0.1f);
+    for (int action = 0; action < INPUT_ACTION_COUNT; action++) {
+        pendingPresses[action] += frame.presses[action];
+        frame.presses[action] = pendingPresses[action];
+    }
+    while (accumulator >= NET_TICK_SECONDS) {
+        accumulator -= NET_TICK_SECONDS;
+        uint64_t nowNs = inputNowNs();
+        if (netClient.isActive()) {
+            netClient.receive(nowNs);
+            ShipInput shipInput{getMoveVelocity(frame), frame.mousePosition, frame.isHeld(InputAction::FIRE),
+                                frame.getPresses(InputAction::RELOAD) > 0};
+            netClient.sendInput(shipInput, frame.getPresses(InputAction::START) > 0, nowNs);
+        } else {
+            netServer.receive(nowNs);
+            applyInput(frame);
+            netServer.applyInputs();
+            game.update(NET_TICK_SECONDS, frame.mousePosition, frame.isHeld(InputAction::FIRE));
+            netServer.sendSnapshots(nowNs);
+        }
+        std::fill(frame.presses, frame.presses + INPUT_ACTION_COUNT, 0);
+        std::fill(pendingPresses, pendingPresses + INPUT_ACTION_COUNT, 0);
+    }
+}
+
+// F9 starts/stops recording to xenostrike_capture_N.y4m (Shift+F9: raw RGBA)
+void toggleCapture(GLFWwindow* window, bool raw) {
+    if (frameCapture.isActive()) {
+        frameReader.flush(frameCapture);
+        frameReader.cleanup();
+        frameCapture.stop();
+        return;
+    }
+
+    int framebufferWidth, framebufferHeight;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    char path[64];
+    std::snprintf(path, sizeof(path), raw ? "xenostrike_capture_%d.rgba" : "xenostrike_capture_%d.y4m", ++captureCount);
+    if (!frameReader.initialize(framebufferWidth, framebufferHeight)) return;
+    if (!frameCapture.start(path, framebufferWidth, framebufferHeight,
+                            raw ? CaptureFormat::RAW_RGBA : CaptureFormat::Y4M)) {
+        frameReader.cleanup();
+        return;
+    }
+    LOG_INFO("Capture: recording to xenostrike_capture_{}.{}", captureCount, raw ? "rgba" : "y4m");
+}
+
+void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    InputAction gameAction;
+    if (action != GLFW_REPEAT && mapGameKey(key, gameAction)) {
+        input.pushAction(gameAction, action == GLFW_PRESS);
+    }
+    if (key == GLFW_KEY_P && action == GLFW_PRESS) {
+        // Capture the next frames to a Chrome trace (chrome://tracing, ui.perfetto.dev)
+        Profiler::requestCapture(PROFILER_CAPTURE_FRAMES);
+    }
+    if (key == GLFW_KEY_F3 && action == GLFW_PRESS) {
+        perfHud.toggle();
+    }
+    if (key == GLFW_KEY_F8 && action == GLFW_PRESS) {
+        framePacer.toggle();
+    }
+    if (key == GLFW_KEY_F9 && action == GLFW_PRESS) {
+        toggleCapture(window, (mods & GLFW_MOD_SHIFT) != 0);
     }
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
         glfwSetWindowShouldClose(window, GLFW_TRUE);
     }
 }
 
-int main() {
-    srand(time(NULL));
+int main(int argc, char** argv) {
+    game.rng.seed(static_cast<uint64_t>(time(NULL)));
+
+    // --host [port] or --join host[:port]
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--host")) {
+            uint16_t port = NET_DEFAULT_PORT;
+            if (i + 1 < argc && argv[i + 1][0] != '-') port = static_cast<uint16_t>(std::atoi(argv[++i]));
+            if (!netServer.start(port)) return -1;
+        } else if (!std::strcmp(argv[i], "--join") && i + 1 < argc) {
+            NetAddress address;
+            if (!resolveAddress(argv[++i], NET_DEFAULT_PORT, address)) {
+                std::cerr << "Unknown server address: " << argv[i] << std::endl;
+                return -1;
+            }
+            if (!netClient.connect(address, inputNowNs())) return -1;
+        }
+    }
 
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW" << std::endl;
@@ -74,6 +250,10 @@ int main() {
     }
 
     glfwMakeContextCurrent(window);
+    glfwSwapInterval(1);  // Frame pacing (F8) assumes vsync
+    if (const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor())) {
+        framePacer.setRefreshRate(mode->refreshRate);
+    }
     glfwSetMouseButtonCallback(window, mouseButtonCallback);
     glfwSetCursorPosCallback(window, cursorPositionCallback);
     glfwSetKeyCallback(window, keyCallback);
@@ -96,72 +276,97 @@ int main() {
     std::cout << "  Click - Shoot" << std::endl;
     std::cout << "  R - Reload" << std::endl;
     std::cout << "  SPACE - Start/Continue" << std::endl;
+    std::cout << "  Backspace (hold) - Rewind (not in co-op)" << std::endl;
     std::cout << "  ESC - Quit" << std::endl;
+    std::cout << "Co-op: --host [port] to let others --join host[:port]" << std::endl;
     std::cout << "\nDefend Station Osiris!" << std::endl;
     std::cout << std::endl;
 
     float lastTime = glfwGetTime();
+    int frameCount = 0;
 
     while (!glfwWindowShouldClose(window)) {
+        // Frame-local data from the previous frame is dead by now
+        getFrameArena().reset();
+        allocTracker.beginFrame();
+        Profiler::beginFrame();
+        getLogger().updateClock();
+
+        // Sample input as late as possible: right before the sim step, after
+        // the optional pacing delay, instead of after the previous swap
+        {
+            PROFILE_SCOPE("FramePacing");
+            framePacer.waitForSampleTime();
+        }
+        InputFrame inputFrame;
+        {
+            PROFILE_SCOPE("InputSample");
+            glfwPollEvents();
+            inputFrame = input.sample();
+        }
+        framePacer.markSampled(inputFrame);
+
         float currentTime = glfwGetTime();
         float deltaTime = currentTime - lastTime;
         lastTime = currentTime;
         deltaTime = std::min(deltaTime, 0.1f);
 
-        // Handle input
-        if (game.gameState == GameState::PLAYING) {
-            game.spacecraft.velocity = Vec2(0, 0);
-            if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-                game.spacecraft.velocity.y += SPACECRAFT_SPEED * 60.0f;
-            if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-                game.spacecraft.velocity.y -= SPACECRAFT_SPEED * 60.0f;
-            if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-                game.spacecraft.velocity.x -= SPACECRAFT_SPEED * 60.0f;
-            if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-                game.spacecraft.velocity.x += SPACECRAFT_SPEED * 60.0f;
-
-            if (spacePressed && !prevSpacePressed && !game.waveActive) {
-                game.startWave();
-            }
+        // Update game logic; holding Backspace steps back through recent ticks instead
+        auto simStart = std::chrono::steady_clock::now();
+        if (netServer.isRunning() || netClient.isActive()) {
+            stepNetworked(inputFrame, deltaTime);
+        } else if (inputFrame.isHeld(InputAction::REWIND) && rewindBuffer.getTickCount() > 1) {
+            playRewind(deltaTime);
+        } else {
+            applyInput(inputFrame);
+            game.update(deltaTime, inputFrame.mousePosition, inputFrame.isHeld(InputAction::FIRE));
+            recordRewind(deltaTime);
         }
-
-        prevSpacePressed = spacePressed;
-
-        // Update game logic
-        game.update(deltaTime, mousePosition, mousePressed);
+        auto simEnd = std::chrono::steady_clock::now();
 
         // Render
         renderer.beginFrame();
-        renderer.drawStarfield();
+        // Joined: draw the server's game as last received, our ship predicted ahead
+        const GameManager& shown = netClient.isActive() ? netClient.getGame() : game;
+        renderer.drawGame(shown);
 
-        for (const auto& particle : game.particles) {
-            renderer.drawParticle(particle);
+        if (perfHud.enabled) {
+            auto renderEnd = std::chrono::steady_clock::now();
+            perfHud.recordFrame(std::chrono::duration<float, std::milli>(simEnd - simStart).count(),
+                                std::chrono::duration<float, std::milli>(renderEnd - simEnd).count(),
+                                renderer.getGpuFrameTimeMs(), framePacer.getLatency(0).eventToPresentMs,
+                                renderer.getFrameStats(), deltaTime);
+            renderer.drawPerfOverlay(perfHud, shown);
         }
+        renderer.endFrame();
 
-        for (const auto& alien : game.aliens) {
-            renderer.drawAlien(alien);
-        }
-        // In the render loop, replace the single mothership with:
-        for (const auto& mothership : game.motherships) {
-            renderer.drawMothership(mothership);
+        if (frameCapture.isActive()) {
+            PROFILE_SCOPE("FrameCapture");
+            frameReader.readFrame(frameCapture);
         }
 
-        for (const auto& plasma : game.plasmas) {
-            renderer.drawPlasma(plasma);
+        framePacer.markSubmitted(inputNowNs());
+        {
+            PROFILE_SCOPE("glfwSwapBuffers");
+            glfwSwapBuffers(window);
         }
+        framePacer.markPresented(inputNowNs());
 
-        if (game.gameState == GameState::PLAYING) {
-            renderer.drawSpacecraft(game.spacecraft);
+        allocTracker.endFrame();
+        if (isAllocTrackingEnabled() && ++frameCount % ALLOC_REPORT_FRAMES == 0) {
+            LOG_DEBUG("Heap: {}/{} frames allocated (peak {}), frame arena peak {} KB",
+                      allocTracker.getFramesWithAllocations(), ALLOC_REPORT_FRAMES,
+                      allocTracker.getPeakFrameAllocations(), getFrameArena().getHighWaterMark() / 1024);
+            allocTracker.resetStats();
         }
-
-        renderer.drawUI(game);
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
     }
 
+    if (frameCapture.isActive()) toggleCapture(window, false);
+    netClient.disconnect();
+    netServer.stop();
     renderer.cleanup();
     glfwTerminate();
+    getLogger().flush();
 
     std::cout << "\n=== GAME OVER ===" << std::endl;
     std::cout << "Final Score: " << game.score << std::endl;
@@ -0,0 +1,80 @@
+// Headless dedicated server: many co-op matches in one process, ticked at
+// 60 Hz on a shared thread pool until interrupted. Match i listens on
+// port + i; players join it with "app --join host:port". Every report
+// interval it logs players, the CPU the matches used and the busiest match,
+// then starts the accounting over.
+// Usage: xenostrike_server [--matches N] [--port P] [--threads N] [--report seconds]
+#include "../include/input.hpp"
+#include "../include/logger.hpp"
+#include "../include/match_host.hpp"
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    std::atomic<bool> stopRequested(false);
+
+    void requestStop(int) {
+        stopRequested.store(true);
+    }
+
+    void report(const MatchHost& host, double seconds) {
+        uint64_t cpuNs = 0, ticks = 0, busiestNs = 0;
+        int activeMatches = 0, busiest = 0;
+        for (int i = 0; i < host.getMatchCount(); i++) {
+            const MatchStats& stats = host.getMatchStats(i);
+            uint64_t matchNs = stats.cpuNs;
+            cpuNs += matchNs;
+            ticks += stats.ticks;
+            if (stats.players > 0) activeMatches++;
+            if (matchNs > busiestNs) {
+                busiestNs = matchNs;
+                busiest = i;
+            }
+        }
+        double tickUs = ticks ? cpuNs / 1000.0 / ticks : 0;
+        LOG_INFO("Server: {} players in {}/{} matches, {} cores busy, {} us per match tick",
+                 host.getPlayerCount(), activeMatches, host.getMatchCount(), cpuNs / 1e9 / seconds, tickUs);
+        if (busiestNs > 0) {
+            LOG_INFO("Server: busiest match {} (port {}) used {} ms, peak tick {} us, {} ticks late, {} skipped",
+                     busiest, static_cast<int>(host.getPort(busiest)), busiestNs / 1e6,
+                     host.getMatchStats(busiest).peakTickNs / 1e3, host.getLateTicks(), host.getSkippedTicks());
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    int matchCount = 64;
+    int threads = 0;
+    float reportSeconds = 10.0f;
+    MatchHostConfig config;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--matches") && i + 1 < argc) matchCount = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--port") && i + 1 < argc) config.basePort = static_cast<uint16_t>(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--report") && i + 1 < argc) reportSeconds = std::max(1.0f, static_cast<float>(std::atof(argv[++i])));
+    }
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    MatchHost host(matchCount, threads, config);
+    if (!host.start()) {
+        getLogger().flush();
+        return 1;
+    }
+
+    while (!stopRequested.load()) {
+        uint64_t start = inputNowNs();
+        host.run(stopRequested, start + static_cast<uint64_t>(reportSeconds * 1e9f));
+        report(host, (inputNowNs() - start) / 1e9);
+        host.resetStats();
+    }
+
+    LOG_INFO("Server: shutting down after {} ticks", host.getTickCount());
+    host.stop();
+    getLogger().flush();
+    return 0;
+}
@@ -0,0 +1,29 @@
+#include "../include/ai_lod.hpp"
+
+AiLodTier classifyAiLod(Vec2 alienPos, Vec2 playerPos) {
+    // Anything outside the window (e.g. fresh spawns) is always far
+    if (alienPos.x < 0 || alienPos.x > WINDOW_WIDTH ||
+        alienPos.y < 0 || alienPos.y > WINDOW_HEIGHT) {
+        return AiLodTier::FAR;
+    }
+
+    Vec2 diff = alienPos - playerPos;
+    float distSq = diff.dot(diff);
+    if (distSq < AI_LOD_NEAR_RADIUS * AI_LOD_NEAR_RADIUS) return AiLodTier::NEAR;
+    if (distSq < AI_LOD_MID_RADIUS * AI_LOD_MID_RADIUS) return AiLodTier::MID;
+    return AiLodTier::FAR;
+}
+
+int getAiLodInterval(AiLodTier tier) {
+    switch (tier) {
+    case AiLodTier::NEAR: return 1;
+    case AiLodTier::MID: return AI_LOD_MID_INTERVAL;
+    case AiLodTier::FAR: return AI_LOD_FAR_INTERVAL;
+    }
+    return 1;
+}
+
+bool shouldSteerThisTick(AiLodTier tier, unsigned int tick, unsigned int slot) {
+    unsigned int interval = static_cast<unsigned int>(getAiLodInterval(tier));
+    return (tick + slot) % interval == 0;
+}
@@ -3,7 +3,7 @@
 
 Alien::Alien(Vec2 pos, AlienType t, int wave)
     : position(pos), velocity(0, 0), type(t), active(true),
-    spawnAnimation(0), animationTime(0) {
+    spawnAnimation(0), animationTime(0), pendingSteerTime(0), steerSlot(0) {
 
 
     float waveSpeedMultiplier = 1.0f + (wave - 1) * 0.08f;
@@ -28,19 +28,50 @@ Alien::Alien(Vec2 pos, AlienType t, int wave)
         case AlienType::HUNTER: health = 25; speed = ALIEN_SPEED * 8.0f; break;
         case AlienType::BRUTE: health = 70; speed = ALIEN_SPEED * 5.0f; break;
     }
+}
+
+namespace {
+    // ANIMATION: Tentacle layout depends only on the alien type
+    TentacleSet buildTentacleSet(int numTentacles) {
+        TentacleSet set;
+        for (int i = 0; i < numTentacles; i++) {
+            float angle = (2.0f * PI * i / numTentacles) + PI * 0.5f;
+            float length = ALIEN_RADIUS * 0.8f;
+            Tentacle tent(angle, length);
+            tent.phase = i * PI * 0.5f; // Different phase for each tentacle
+            set.tentacles[set.count++] = tent;
+        }
+        return set;
+    }
+}
+
+const TentacleSet& Alien::getTentacles() const {
+    static const TentacleSet fourTentacles = buildTentacleSet(4);
+    static const TentacleSet sixTentacles = buildTentacleSet(6);
+
+    return (type == AlienType::BRUTE) ? sixTentacles : fourTentacles;
+}
+
+void Alien::update(float deltaTime, Vec2 playerPos, bool steerThisTick) {
+    pendingSteerTime += deltaTime;
+    if (steerThisTick) steer(playerPos);
+    integrate(deltaTime);
+}
 
-    // ANIMATION: Initialize tentacles with different angles
-    int numTentacles = (type == AlienType::BRUTE) ? 6 : 4;
-    for (int i = 0; i < numTentacles; i++) {
-        float angle = (2.0f * PI * i / numTentacles) + PI * 0.5f;
-        float length = ALIEN_RADIUS * 0.8f;
-        Tentacle tent(angle, length);
-        tent.phase = i * PI * 0.5f; // Different phase for each tentacle
-        tentacles.push_back(tent);
+// Steering covers all time elapsed since the previous steer, so aliens on a
+// reduced AI update rate catch up in a single step.
+void Alien::steer(Vec2 playerPos) {
+    Vec2 direction = (playerPos - position).normalized();
+    float accel = 120.0f * pendingSteerTime;
+    pendingSteerTime = 0;
+    velocity = velocity + direction * accel;
+    if (velocity.length() > speed) {
+        velocity = velocity.normalized() * speed;
     }
 }
 
-void Alien::update(float deltaTime, Vec2 playerPos) {
+// Dead reckoning: advance animation and position along the current velocity
+void Alien::integrate(float deltaTime) {
     if (spawnAnimation < 1.0f) {
         spawnAnimation += deltaTime * 3.0f;
         spawnAnimation = std::min(1.0f, spawnAnimation);
@@ -49,12 +80,6 @@ void Alien::update(float deltaTime, Vec2 playerPos) {
     // ANIMATION: Update tentacle animation time
     animationTime += deltaTime;
 
-    Vec2 direction = (playerPos - position).normalized();
-    float accel = 120.0f * deltaTime;
-    velocity = velocity + direction * accel;
-    if (velocity.length() > speed) {
-        velocity = velocity.normalized() * speed;
-    }
     position = position + velocity * deltaTime;
 }
 
@@ -0,0 +1,49 @@
+#include "../include/alien_grid.hpp"
+#include <cmath>
+
+AlienGrid::AlienGrid()
+    : width(static_cast<int>(std::ceil((WINDOW_WIDTH + 2 * ALIEN_GRID_MARGIN) / ALIEN_GRID_CELL_SIZE))),
+      height(static_cast<int>(std::ceil((WINDOW_HEIGHT + 2 * ALIEN_GRID_MARGIN) / ALIEN_GRID_CELL_SIZE))),
+      cellHead(width * height, NONE), count(0) {}
+
+void AlienGrid::link(uint32_t slot, uint32_t cell) {
+    Entry& entry = entries[slot];
+    entry.cell = cell;
+    entry.prev = NONE;
+    entry.next = cellHead[cell];
+    if (entry.next != NONE) entries[entry.next].prev = slot;
+    cellHead[cell] = slot;
+}
+
+void AlienGrid::unlink(uint32_t slot) {
+    Entry& entry = entries[slot];
+    if (entry.prev != NONE) entries[entry.prev].next = entry.next;
+    else cellHead[entry.cell] = entry.next;
+    if (entry.next != NONE) entries[entry.next].prev = entry.prev;
+    entry.cell = NONE;
+}
+
+void AlienGrid::clear() {
+    std::fill(cellHead.begin(), cellHead.end(), NONE);
+    for (Entry& entry : entries) entry.cell = NONE;
+    count = 0;
+}
+
+void AlienGrid::rebuild(const SlotMap<Alien>& aliens) {
+    clear();
+    for (size_t i = 0; i < aliens.size(); i++) insert(aliens.handleAt(i), aliens[i].position);
+}
+
+void AlienGrid::insert(EntityHandle handle, Vec2 position) {
+    if (handle.index >= entries.size()) entries.resize(handle.index + 1, Entry{NONE, 0, NONE, NONE});
+    if (entries[handle.index].cell != NONE) remove(getHandle(handle.index));
+    entries[handle.index].generation = handle.generation;
+    link(handle.index, static_cast<uint32_t>(getCell(position)));
+    count++;
+}
+
+void AlienGrid::remove(EntityHandle handle) {
+    if (handle.index >= entries.size() || entries[handle.index].cell == NONE) return;
+    unlink(handle.index);
+    count--;
+}
@@ -0,0 +1,112 @@
+#include "../include/alloc_stats.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<uint64_t> allocationCount(0);
+    std::atomic<uint64_t> allocationBytes(0);
+}
+
+#ifdef XS_TRACK_ALLOCATIONS
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+// Over-aligned types (alignas beyond the default, e.g. LogRing) come through here
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+    // aligned_alloc wants the size to be a multiple of the alignment
+    std::size_t rounded = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+    if (void* ptr = std::aligned_alloc(align, rounded)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+bool isAllocTrackingEnabled() {
+    return true;
+}
+
+#else
+
+bool isAllocTrackingEnabled() {
+    return false;
+}
+
+#endif
+
+AllocCounters getAllocCounters() {
+    AllocCounters counters;
+    counters.allocations = allocationCount.load(std::memory_order_relaxed);
+    counters.bytes = allocationBytes.load(std::memory_order_relaxed);
+    return counters;
+}
+
+FrameAllocTracker::FrameAllocTracker()
+    : frameStart(getAllocCounters()), framesWithAllocations(0), peakFrameAllocations(0) {}
+
+void FrameAllocTracker::beginFrame() {
+    frameStart = getAllocCounters();
+}
+
+AllocCounters FrameAllocTracker::endFrame() {
+    AllocCounters now = getAllocCounters();
+    AllocCounters frame;
+    frame.allocations = now.allocations - frameStart.allocations;
+    frame.bytes = now.bytes - frameStart.bytes;
+
+    if (frame.allocations > 0) framesWithAllocations++;
+    peakFrameAllocations = std::max(peakFrameAllocations, frame.allocations);
+    return frame;
+}
+
+void FrameAllocTracker::resetStats() {
+    framesWithAllocations = 0;
+    peakFrameAllocations = 0;
+}
@@ -0,0 +1,15 @@
+#include "../include/embedded_shaders.hpp"
+#include <cstring>
+
+namespace {
+    const EmbeddedShader EMBEDDED_SHADERS[] = {
+#include "../generated/embedded_shaders.inc"
+    };
+}
+
+const char* findEmbeddedShader(const char* path) {
+    for (const EmbeddedShader& shader : EMBEDDED_SHADERS) {
+        if (std::strcmp(shader.path, path) == 0) return shader.source;
+    }
+    return nullptr;
+}
@@ -0,0 +1,43 @@
+#include "../include/frame_arena.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+FrameArena::FrameArena(size_t capacity)
+    : buffer(new unsigned char[capacity]), capacity(capacity), offset(0),
+      highWaterMark(0), overflowCount(0) {}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment) {
+    uintptr_t base = reinterpret_cast<uintptr_t>(buffer.get());
+    uintptr_t aligned = (base + offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    size_t newOffset = (aligned - base) + bytes;
+
+    if (newOffset > capacity) {
+        // Out of arena space: stay correct, but make it visible in the stats
+        overflowCount++;
+        return ::operator new(bytes);
+    }
+
+    offset = newOffset;
+    highWaterMark = std::max(highWaterMark, offset);
+    return reinterpret_cast<void*>(aligned);
+}
+
+void FrameArena::deallocate(void* ptr) {
+    // Arena memory is released in bulk by reset()
+    if (ptr && !owns(ptr)) ::operator delete(ptr);
+}
+
+void FrameArena::reset() {
+    offset = 0;
+}
+
+bool FrameArena::owns(const void* ptr) const {
+    const unsigned char* p = static_cast<const unsigned char*>(ptr);
+    return p >= buffer.get() && p < buffer.get() + capacity;
+}
+
+FrameArena& getFrameArena() {
+    thread_local FrameArena arena;
+    return arena;
+}
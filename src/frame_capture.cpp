@@ -0,0 +1,174 @@
+#include "../include/frame_capture.hpp"
+#include "../include/logger.hpp"
+
+namespace {
+    const size_t CAPTURE_FILE_BUFFER = 1 << 20;
+
+    // BT.601 limited range, 8.8 fixed point
+    inline uint8_t lumaOf(int r, int g, int b) {
+        return static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+    }
+    inline uint8_t chromaUOf(int r, int g, int b) {
+        return static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+    }
+    inline uint8_t chromaVOf(int r, int g, int b) {
+        return static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+}
+
+FrameCapture::FrameCapture()
+    : width(0), height(0), frameBytes(0), format(CaptureFormat::Y4M), output(nullptr),
+      queue(), queueHead(0), queueCount(0), stopping(false), framesWritten(0), framesDropped(0),
+      bytesWritten(0), writeFailed(false) {}
+
+FrameCapture::~FrameCapture() {
+    stop();
+}
+
+bool FrameCapture::start(const char* path, int frameWidth, int frameHeight, CaptureFormat captureFormat, int fps) {
+    if (output || frameWidth <= 0 || frameHeight <= 0) return false;
+
+    output = std::fopen(path, "wb");
+    if (!output) {
+        LOG_WARN("Capture: failed to open output file");
+        return false;
+    }
+    std::setvbuf(output, nullptr, _IOFBF, CAPTURE_FILE_BUFFER);
+
+    width = frameWidth;
+    height = frameHeight;
+    format = captureFormat;
+    frameBytes = static_cast<size_t>(width) * height * 4;
+
+    // Allocated once per capture; frames recycle through freeSlots
+    storage.assign(frameBytes * FRAME_CAPTURE_POOL_FRAMES, 0);
+    if (format == CaptureFormat::Y4M) {
+        size_t chroma = static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+        planes.assign(static_cast<size_t>(width) * height + 2 * chroma, 0);
+        std::fprintf(output, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps);
+    }
+    freeSlots.clear();
+    for (int i = FRAME_CAPTURE_POOL_FRAMES - 1; i >= 0; i--) freeSlots.push_back(i);
+    queueHead = queueCount = 0;
+    stopping = false;
+    writeFailed = false;
+    framesWritten = framesDropped = bytesWritten = 0;
+
+    writer = std::thread(&FrameCapture::writerLoop, this);
+    LOG_INFO("Capture: started {}x{} {}", width, height, format == CaptureFormat::Y4M ? "y4m" : "raw rgba");
+    return true;
+}
+
+void FrameCapture::stop() {
+    if (!output) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+
+    if (std::fclose(output) != 0) writeFailed = true;
+    output = nullptr;
+    if (writeFailed) LOG_WARN("Capture: write error, the file is incomplete");
+    LOG_INFO("Capture: stopped, {} frames written, {} dropped, {} MB", getFramesWritten(),
+             getFramesDropped(), getBytesWritten() / (1024 * 1024));
+
+    std::vector<uint8_t>().swap(storage);
+    std::vector<uint8_t>().swap(planes);
+}
+
+uint8_t* FrameCapture::acquireFrame() {
+    if (!output) return nullptr;
+    int slot;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (freeSlots.empty()) {
+            framesDropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    return storage.data() + slot * frameBytes;
+}
+
+void FrameCapture::submitFrame(uint8_t* frame) {
+    int slot = static_cast<int>((frame - storage.data()) / frameBytes);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // Can't overflow: a slot is either free, held by the producer or queued
+        queue[(queueHead + queueCount) % FRAME_CAPTURE_POOL_FRAMES] = slot;
+        queueCount++;
+    }
+    wake.notify_one();
+}
+
+void FrameCapture::noteDroppedFrame() {
+    framesDropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FrameCapture::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return queueCount > 0 || stopping; });
+        if (queueCount == 0) return;  // Stopping and drained
+
+        int slot = queue[queueHead];
+        queueHead = (queueHead + 1) % FRAME_CAPTURE_POOL_FRAMES;
+        queueCount--;
+
+        // Conversion and file I/O run without the lock
+        lock.unlock();
+        if (!writeFailed && !writeFrame(storage.data() + slot * frameBytes)) writeFailed = true;
+        lock.lock();
+        freeSlots.push_back(slot);
+    }
+}
+
+bool FrameCapture::writeFrame(const uint8_t* rgba) {
+    size_t bytes;
+    if (format == CaptureFormat::Y4M) {
+        convertToI420(rgba);
+        if (std::fputs("FRAME\n", output) == EOF) return false;
+        bytes = planes.size();
+        if (std::fwrite(planes.data(), 1, bytes, output) != bytes) return false;
+        bytes += 6;
+    } else {
+        bytes = frameBytes;
+        if (std::fwrite(rgba, 1, bytes, output) != bytes) return false;
+    }
+    framesWritten.fetch_add(1, std::memory_order_relaxed);
+    bytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+    return true;
+}
+
+void FrameCapture::convertToI420(const uint8_t* rgba) {
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    uint8_t* yPlane = planes.data();
+    uint8_t* uPlane = yPlane + static_cast<size_t>(width) * height;
+    uint8_t* vPlane = uPlane + static_cast<size_t>(chromaWidth) * chromaHeight;
+
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row = rgba + static_cast<size_t>(y) * width * 4;
+        uint8_t* out = yPlane + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; x++) out[x] = lumaOf(row[x * 4], row[x * 4 + 1], row[x * 4 + 2]);
+    }
+
+    // Chroma from the average of each 2x2 block (edge pixels repeat for odd sizes)
+    for (int cy = 0; cy < chromaHeight; cy++) {
+        const uint8_t* row0 = rgba + static_cast<size_t>(cy * 2) * width * 4;
+        const uint8_t* row1 = cy * 2 + 1 < height ? row0 + static_cast<size_t>(width) * 4 : row0;
+        for (int cx = 0; cx < chromaWidth; cx++) {
+            int x0 = cx * 2 * 4;
+            int x1 = cx * 2 + 1 < width ? x0 + 4 : x0;
+            int r = (row0[x0] + row0[x1] + row1[x0] + row1[x1] + 2) >> 2;
+            int g = (row0[x0 + 1] + row0[x1 + 1] + row1[x0 + 1] + row1[x1 + 1] + 2) >> 2;
+            int b = (row0[x0 + 2] + row0[x1 + 2] + row1[x0 + 2] + row1[x1 + 2] + 2) >> 2;
+            size_t index = static_cast<size_t>(cy) * chromaWidth + cx;
+            uPlane[index] = chromaUOf(r, g, b);
+            vPlane[index] = chromaVOf(r, g, b);
+        }
+    }
+}
@@ -1,19 +1,22 @@
 #include "../include/game_manager.hpp"
 #include "../include/collision.hpp"
 #include "../include/mothership.hpp"
-#include <cstdlib>
-#include <iostream>
+#include "../include/ai_lod.hpp"
+#include "../include/frame_arena.hpp"
+#include "../include/logger.hpp"
+#include "../include/profiler.hpp"
 #include <algorithm>
 
 GameManager::GameManager()
     : wave(0), score(0), killCount(0), waveActive(false),
-    gameState(GameState::PLAYING), stateTimer(0) {
+    gameState(GameState::PLAYING), stateTimer(0), tickCount(0), aliensSpawned(0), logEvents(true), spawnEffects(true) {
 }  // Start directly in PLAYING state, skip MENU
 
 void GameManager::reset() {
-    spacecraft = Spacecraft();
+    for (int player = 0; player < getShipCount(); player++) respawnShip(player);
     plasmas.clear();
     aliens.clear();
+    alienGrid.clear();
     particles.clear();
     motherships.clear();  // Clear the vector instead
     wave = 0;
@@ -21,71 +24,161 @@ void GameManager::reset() {
     killCount = 0;
     waveActive = false;
     stateTimer = 0;
+    tickCount = 0;
+    aliensSpawned = 0;
     gameState = GameState::PLAYING;
 }
 
+EntityHandle GameManager::spawnAlien(Alien alien) {
+    alien.steerSlot = aliensSpawned++;
+    EntityHandle handle = aliens.insert(alien);
+    alienGrid.insert(handle, alien.position);
+    return handle;
+}
+
+int GameManager::addWingman() {
+    if (getShipCount() >= MAX_PLAYERS) return -1;
+    wingmen.push_back(Spacecraft());
+    wingmanInputs.push_back(ShipInput());
+    int player = getShipCount() - 1;
+    respawnShip(player);
+    return player;
+}
+
+void GameManager::respawnShip(int player) {
+    Spacecraft& ship = getShip(player);
+    ship = Spacecraft();
+    ship.position = getStartPosition(player);
+    if (player > 0) {
+        // Idle, facing the same way as a fresh ship
+        wingmanInputs[player - 1] = ShipInput{Vec2(0, 0), ship.position + Vec2(100, 0), false, false};
+    }
+}
+
+bool GameManager::isAnyShipAlive() const {
+    for (int player = 0; player < getShipCount(); player++) {
+        if (getShip(player).isAlive()) return true;
+    }
+    return false;
+}
+
+// Player 0 in the middle, wingmen alternating right and left of it
+Vec2 GameManager::getStartPosition(int player) const {
+    float side = player % 2 == 1 ? 1.0f : -1.0f;
+    return Vec2(WINDOW_WIDTH / 2 + side * ((player + 1) / 2) * WINGMAN_SPACING, WINDOW_HEIGHT / 2);
+}
+
+// Aliens go for the nearest ship still flying
+Vec2 GameManager::getTargetPosition(Vec2 from) const {
+    if (wingmen.empty()) return spacecraft.position;
+    Vec2 target = spacecraft.position;
+    float bestDistance = -1;
+    for (int player = 0; player < getShipCount(); player++) {
+        const Spacecraft& ship = getShip(player);
+        if (!ship.isAlive()) continue;
+        Vec2 diff = ship.position - from;
+        float distance = diff.dot(diff);
+        if (bestDistance < 0 || distance < bestDistance) {
+            bestDistance = distance;
+            target = ship.position;
+        }
+    }
+    return target;
+}
+
+// Every ship still flying is out of ammo, and aliens are on at least one of them
+bool GameManager::isOutOfAmmo() const {
+    bool alienNearby = false;
+    for (int player = 0; player < getShipCount(); player++) {
+        const Spacecraft& ship = getShip(player);
+        if (!ship.isAlive()) continue;
+        if (ship.ammo > 0) return false;
+        for (auto& alien : aliens) {
+            if (alien.active) {
+                float dist = (alien.position - ship.position).length();
+                if (dist < 150.0f) {
+                    alienNearby = true;
+                    break;
+                }
+            }
+        }
+    }
+    return alienNearby;
+}
+
 Vec2 GameManager::getSpawnPosition() {
-    int side = rand() % 4;
+    int side = rng.nextInt(4);
     float x, y;
 
     switch (side) {
-    case 0: x = rand() % WINDOW_WIDTH; y = -50; break;
-    case 1: x = rand() % WINDOW_WIDTH; y = WINDOW_HEIGHT + 50; break;
-    case 2: x = -50; y = rand() % WINDOW_HEIGHT; break;
-    case 3: x = WINDOW_WIDTH + 50; y = rand() % WINDOW_HEIGHT; break;
+    case 0: x = rng.nextInt(WINDOW_WIDTH); y = -50; break;
+    case 1: x = rng.nextInt(WINDOW_WIDTH); y = WINDOW_HEIGHT + 50; break;
+    case 2: x = -50; y = rng.nextInt(WINDOW_HEIGHT); break;
+    default: x = WINDOW_WIDTH + 50; y = rng.nextInt(WINDOW_HEIGHT); break;
     }
 
     return Vec2(x, y);
 }
 
 void GameManager::createAlienExplosion(Vec2 pos, Color baseColor) {
+    if (!spawnEffects) return;
     for (int i = 0; i < 12; i++) {
-        float angle = (rand() % 360) * PI / 180.0f;
-        float speed = 50.0f + (rand() % 100);
+        float angle = rng.nextInt(360) * PI / 180.0f;
+        float speed = 50.0f + rng.nextInt(100);
         Vec2 vel(cos(angle) * speed, sin(angle) * speed);
-        particles.push_back(Particle(pos, vel, 0.6f, baseColor));
+        particles.insert(Particle(pos, vel, 0.6f, baseColor));
     }
 }
 
 void GameManager::createPlasmaFlash(Vec2 pos) {
+    if (!spawnEffects) return;
     for (int i = 0; i < 5; i++) {
-        float angle = (rand() % 60 - 30) * PI / 180.0f;
+        float angle = (rng.nextInt(60) - 30) * PI / 180.0f;
         Vec2 vel(cos(angle) * 200, sin(angle) * 200);
-        particles.push_back(Particle(pos, vel, 0.2f, Color(0.3f, 0.9f, 1.0f, 1.0f)));
+        particles.insert(Particle(pos, vel, 0.2f, Color(0.3f, 0.9f, 1.0f, 1.0f)));
     }
 }
 
 void GameManager::createShieldImpact(Vec2 pos) {
+    if (!spawnEffects) return;
     for (int i = 0; i < 15; i++) {
-        float angle = (rand() % 360) * PI / 180.0f;
-        float speed = 80.0f + (rand() % 120);
+        float angle = rng.nextInt(360) * PI / 180.0f;
+        float speed = 80.0f + rng.nextInt(120);
         Vec2 vel(cos(angle) * speed, sin(angle) * speed);
-        particles.push_back(Particle(pos, vel, 0.4f, Color(0.2f, 0.8f, 1.0f, 0.8f)));
+        particles.insert(Particle(pos, vel, 0.4f, Color(0.2f, 0.8f, 1.0f, 0.8f)));
     }
 }
 
-void GameManager::createDeathExplosion() {
+void GameManager::createDeathExplosion(Vec2 pos) {
+    if (!spawnEffects) return;
     for (int i = 0; i < 40; i++) {
-        float angle = (rand() % 360) * PI / 180.0f;
-        float speed = 100.0f + (rand() % 250);
+        float angle = rng.nextInt(360) * PI / 180.0f;
+        float speed = 100.0f + rng.nextInt(250);
         Vec2 vel(cos(angle) * speed, sin(angle) * speed);
-        Color col = (rand() % 2 == 0) ? Color(1.0f, 0.3f, 0.0f, 1.0f) : Color(0.2f, 0.6f, 1.0f, 1.0f);
-        particles.push_back(Particle(spacecraft.position, vel, 1.5f, col));
+        Color col = (rng.nextInt(2) == 0) ? Color(1.0f, 0.3f, 0.0f, 1.0f) : Color(0.2f, 0.6f, 1.0f, 1.0f);
+        particles.insert(Particle(pos, vel, 1.5f, col));
     }
 }
 
+void GameManager::logGameOver(const char* reason) {
+    if (!logEvents) return;
+    LOG_INFO("=== GAME OVER - {} === Final Score: {} | Waves Survived: {} | Aliens Eliminated: {}",
+             reason, score, wave, killCount);
+    LOG_INFO("Press SPACE to restart");
+}
+
 void GameManager::startWave() {
     wave++;
     waveActive = true;
     int alienCount = ALIENS_PER_WAVE + (wave - 1) * 2;
 
-    std::cout << "Wave " << wave << " - " << alienCount << " aliens incoming!" << std::endl;
+    if (logEvents) LOG_INFO("Wave {} - {} aliens incoming!", wave, alienCount);
 
     // Determine number of motherships (but ensure we don't have more motherships than aliens)
     int mothershipCount = std::min(2 + (wave / 2), alienCount);
 
-    // Distribute aliens to motherships
-    std::vector<int> alienDistribution(mothershipCount, 0);
+    // Distribute aliens to motherships (frame-local, so it lives in the frame arena)
+    std::vector<int, ArenaAllocator<int>> alienDistribution(mothershipCount, 0);
     for (int i = 0; i < alienCount; i++) {
         alienDistribution[i % mothershipCount]++;  // Round-robin distribution
     }
@@ -93,39 +186,68 @@ void GameManager::startWave() {
     // Create motherships with their alien counts
     for (int i = 0; i < mothershipCount; i++) {
         float x = (WINDOW_WIDTH / (mothershipCount + 1)) * (i + 1);
-        float y = WINDOW_HEIGHT - 80 - (rand() % 40);
+        float y = WINDOW_HEIGHT - 80 - rng.nextInt(40);
         Vec2 pos(x, y);
         motherships.push_back(Mothership(pos, alienDistribution[i]));
     }
 }
 
+void GameManager::fireFrom(Spacecraft& ship) {
+    Vec2 direction = Vec2(cos(ship.rotation), sin(ship.rotation));
+    Vec2 plasmaVel = direction * PLASMA_SPEED * 60.0f;
+    Vec2 backDirection = Vec2(cos(ship.rotation + PI), sin(ship.rotation + PI));
+    Vec2 muzzlePos = ship.position + backDirection * SPACECRAFT_RADIUS;
+    plasmas.insert(Plasma(muzzlePos, plasmaVel));
+    createPlasmaFlash(muzzlePos);
+    ship.shoot();
+}
+
+void GameManager::updateAliens(float deltaTime) {
+    PROFILE_SCOPE("GameManager::updateAliens");
+    // AI LOD: every alien moves each tick, but only nearby ones re-steer every
+    // tick; distant/off-screen ones dead-reckon between staggered updates.
+    // The stagger is each alien's own steerSlot, not its position in the
+    // array, so swap-removing another alien never shifts its schedule.
+    for (size_t i = 0; i < aliens.size(); i++) {
+        Alien& alien = aliens[i];
+        if (!alien.active) continue;
+        Vec2 target = getTargetPosition(alien.position);
+        AiLodTier tier = classifyAiLod(alien.position, target);
+        alien.update(deltaTime, target, shouldSteerThisTick(tier, tickCount, alien.steerSlot));
+        alienGrid.move(aliens.handleAt(i), alien.position);
+    }
+}
+
 void GameManager::update(float deltaTime, Vec2 mousePos, bool shooting) {
+    PROFILE_SCOPE("GameManager::update");
     stateTimer += deltaTime;
+    tickCount++;
 
     if (gameState != GameState::PLAYING) {
         // Continue particle animations
         for (auto& particle : particles) {
             particle.update(deltaTime);
         }
-        for (auto& alien : aliens) {
-            if (alien.active) alien.update(deltaTime, spacecraft.position);
-        }
+        updateAliens(deltaTime);
         for (auto& mothership : motherships) {
             mothership.update(deltaTime);
         }
         return;
     }
 
-    spacecraft.update(deltaTime, mousePos);
-
-    if (shooting && spacecraft.canShoot() && spacecraft.isAlive()) {
-        Vec2 direction = Vec2(cos(spacecraft.rotation), sin(spacecraft.rotation));
-        Vec2 plasmaVel = direction * PLASMA_SPEED * 60.0f;
-        Vec2 backDirection = Vec2(cos(spacecraft.rotation + PI), sin(spacecraft.rotation + PI));
-        Vec2 muzzlePos = spacecraft.position + backDirection * SPACECRAFT_RADIUS;
-        plasmas.push_back(Plasma(muzzlePos, plasmaVel));
-        createPlasmaFlash(muzzlePos);
-        spacecraft.shoot();
+    // Wrecked ships stay where they are until respawned
+    if (spacecraft.isAlive()) {
+        spacecraft.update(deltaTime, mousePos);
+        if (shooting && spacecraft.canShoot()) fireFrom(spacecraft);
+    }
+    for (size_t i = 0; i < wingmen.size(); i++) {
+        Spacecraft& wingman = wingmen[i];
+        const ShipInput& wingmanInput = wingmanInputs[i];
+        if (!wingman.isAlive()) continue;
+        if (wingmanInput.reload && wingman.ammo < wingman.maxAmmo) wingman.reload(score);
+        wingman.velocity = wingmanInput.velocity;
+        wingman.update(deltaTime, wingmanInput.aimTarget);
+        if (wingmanInput.shooting && wingman.canShoot()) fireFrom(wingman);
     }
 
     // Update motherships and spawn aliens
@@ -137,10 +259,10 @@ void GameManager::update(float deltaTime, Vec2 mousePos, bool shooting) {
             Vec2 spawnPos = mothership.getSpawnPosition();
 
             AlienType type = AlienType::SCOUT;
-            if (wave > 2 && (rand() % 100) < 35) type = AlienType::HUNTER;
-            if (wave > 4 && (rand() % 100) < 20) type = AlienType::BRUTE;
+            if (wave > 2 && rng.nextInt(100) < 35) type = AlienType::HUNTER;
+            if (wave > 4 && rng.nextInt(100) < 20) type = AlienType::BRUTE;
 
-            aliens.push_back(Alien(spawnPos, type, wave));
+            spawnAlien(Alien(spawnPos, type, wave));
         }
 
         if (!mothership.hasFinishedSpawning()) {
@@ -153,58 +275,49 @@ void GameManager::update(float deltaTime, Vec2 mousePos, bool shooting) {
         motherships.clear();
         waveActive = false;
         score += wave * 100;
-        std::cout << "Wave " << wave << " complete! Score: " << score << std::endl;
-        spacecraft.reload(score);
+        if (logEvents) LOG_INFO("Wave {} complete! Score: {}", wave, score);
+        // Every ship restocks on the same terms, paid for out of the bonus
+        for (int player = 0; player < getShipCount(); player++) getShip(player).reload(score);
     }
 
     // Check for out of ammo game over
-    if (spacecraft.ammo == 0 && plasmas.empty() && !aliens.empty() && waveActive) {
-        bool alienNearby = false;
-        for (auto& alien : aliens) {
-            if (alien.active) {
-                float dist = (alien.position - spacecraft.position).length();
-                if (dist < 150.0f) {
-                    alienNearby = true;
-                    break;
-                }
-            }
-        }
-        if (alienNearby) {
-            gameState = GameState::GAME_OVER_AMMO;
-            createDeathExplosion();
-            std::cout << "\n=== GAME OVER - Out of Ammo! ===" << std::endl;
-            std::cout << "Final Score: " << score << std::endl;
-            std::cout << "Waves Survived: " << wave << std::endl;
-            std::cout << "Aliens Eliminated: " << killCount << std::endl;
-            std::cout << "Press SPACE to restart\n" << std::endl;
-        }
+    if (plasmas.empty() && !aliens.empty() && waveActive && isOutOfAmmo()) {
+        gameState = GameState::GAME_OVER_AMMO;
+        createDeathExplosion(spacecraft.position);
+        logGameOver("Out of Ammo!");
     }
 
-    for (auto& plasma : plasmas) {
-        if (plasma.active) plasma.update(deltaTime);
+    {
+        PROFILE_SCOPE("GameManager::updatePlasmas");
+        for (auto& plasma : plasmas) {
+            if (plasma.active) plasma.update(deltaTime);
+        }
     }
 
-    for (auto& alien : aliens) {
-        if (alien.active) alien.update(deltaTime, spacecraft.position);
-    }
+    updateAliens(deltaTime);
 
-    for (auto& particle : particles) {
-        particle.update(deltaTime);
+    {
+        PROFILE_SCOPE("GameManager::updateParticles");
+        for (auto& particle : particles) {
+            particle.update(deltaTime);
+        }
     }
 
     checkCollisions();
 
-    plasmas.erase(std::remove_if(plasmas.begin(), plasmas.end(),
-        [](const Plasma& p) { return !p.active; }), plasmas.end());
-
-    aliens.erase(std::remove_if(aliens.begin(), aliens.end(),
-        [](const Alien& a) { return !a.active; }), aliens.end());
-
-    particles.erase(std::remove_if(particles.begin(), particles.end(),
-        [](const Particle& p) { return !p.isAlive(); }), particles.end());
+    // Swap-remove dead entities; survivors keep their handles, but dense
+    // positions and iteration order change
+    PROFILE_SCOPE("GameManager::removeDead");
+    plasmas.removeIf([](const Plasma& p) { return !p.active; });
+    for (size_t i = 0; i < aliens.size(); i++) {
+        if (!aliens[i].active) alienGrid.remove(aliens.handleAt(i));
+    }
+    aliens.removeIf([](const Alien& a) { return !a.active; });
+    particles.removeIf([](const Particle& p) { return !p.isAlive(); });
 }
 
 void GameManager::checkCollisions() {
+    PROFILE_SCOPE("GameManager::checkCollisions");
     // Plasma-alien collisions
     for (auto& plasma : plasmas) {
         if (!plasma.active) continue;
@@ -236,31 +349,36 @@ void GameManager::checkCollisions() {
         }
     }
 
+    for (int player = 0; player < getShipCount(); player++) {
+        collideShip(getShip(player));
+    }
+}
+
+// The game ends when the last ship still flying goes down
+void GameManager::collideShip(Spacecraft& ship) {
     // Spacecraft-alien collisions
-    if (!spacecraft.isAlive()) return;
-    for (auto& alien : aliens) {
+    if (!ship.isAlive()) return;
+    for (size_t i = 0; i < aliens.size(); i++) {
+        Alien& alien = aliens[i];
         if (!alien.active) continue;
 
-        CollisionInfo collision = detectCollision(spacecraft.position, SPACECRAFT_RADIUS,
+        CollisionInfo collision = detectCollision(ship.position, SPACECRAFT_RADIUS,
             alien.position, alien.getSize());
 
         if (collision.hasCollision) {
             float damage = 0.8f + (collision.penetrationDepth * 0.1f);
-            spacecraft.takeDamage(damage);
+            ship.takeDamage(damage);
 
             Vec2 pushBack = collision.collisionNormal * -1.0f * collision.penetrationDepth;
             alien.position = alien.position + pushBack;
+            alienGrid.move(aliens.handleAt(i), alien.position);
 
             createShieldImpact(collision.contactPoint);
 
-            if (!spacecraft.isAlive()) {
+            if (!ship.isAlive() && !isAnyShipAlive()) {
                 gameState = GameState::GAME_OVER_SHIELD;
-                createDeathExplosion();
-                std::cout << "\n=== GAME OVER - Shields Failed! ===" << std::endl;
-                std::cout << "Final Score: " << score << std::endl;
-                std::cout << "Waves Survived: " << wave << std::endl;
-                std::cout << "Aliens Eliminated: " << killCount << std::endl;
-                std::cout << "Press SPACE to restart\n" << std::endl;
+                createDeathExplosion(ship.position);
+                logGameOver("Shields Failed!");
             }
         }
     }
@@ -269,23 +387,19 @@ void GameManager::checkCollisions() {
     for (auto& mothership : motherships) {
         if (!mothership.active) continue;
 
-        CollisionInfo collision = detectCollision(spacecraft.position, SPACECRAFT_RADIUS,
+        CollisionInfo collision = detectCollision(ship.position, SPACECRAFT_RADIUS,
             mothership.position, mothership.size);
 
         if (collision.hasCollision) {
             float damage = 2.0f + (collision.penetrationDepth * 0.2f);  // More damage than aliens
-            spacecraft.takeDamage(damage);
+            ship.takeDamage(damage);
 
             createShieldImpact(collision.contactPoint);
 
-            if (!spacecraft.isAlive()) {
+            if (!ship.isAlive() && !isAnyShipAlive()) {
                 gameState = GameState::GAME_OVER_SHIELD;
-                createDeathExplosion();
-                std::cout << "\n=== GAME OVER - Crashed into Mothership! ===" << std::endl;
-                std::cout << "Final Score: " << score << std::endl;
-                std::cout << "Waves Survived: " << wave << std::endl;
-                std::cout << "Aliens Eliminated: " << killCount << std::endl;
-                std::cout << "Press SPACE to restart\n" << std::endl;
+                createDeathExplosion(ship.position);
+                logGameOver("Crashed into Mothership!");
             }
         }
     }
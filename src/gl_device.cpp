@@ -0,0 +1,91 @@
+#include "../include/gl_device.hpp"
+
+GlDevice::GlDevice()
+    : simpleProgram(-1), programGeneration(0), shaderProgram(0), VAO(0), VBO(0), colorLocation(-1), transformLocation(-1) {}
+
+bool GlDevice::initialize() {
+    shaders.initialize();
+    simpleProgram = shaders.addProgram("simple", "SimpleVertexShader.vertexshader",
+                                       "SimpleFragmentShader.fragmentshader");
+    if (simpleProgram < 0) return false;
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    gpuTimer.initialize();  // Optional; rendering works without it
+    return true;
+}
+
+void GlDevice::cleanup() {
+    gpuTimer.cleanup();
+    if (VBO) glDeleteBuffers(1, &VBO);
+    if (VAO) glDeleteVertexArrays(1, &VAO);
+    shaders.cleanup();
+    VBO = VAO = shaderProgram = 0;
+    simpleProgram = -1;
+}
+
+void GlDevice::bindProgram() {
+    if (shaders.getGeneration(simpleProgram) == programGeneration) return;
+    programGeneration = shaders.getGeneration(simpleProgram);
+    shaderProgram = shaders.getProgram(simpleProgram);
+
+    // Looked up once per build instead of on every draw
+    colorLocation = glGetUniformLocation(shaderProgram, "color");
+    transformLocation = glGetUniformLocation(shaderProgram, "transform");
+}
+
+void GlDevice::finishShaderBuilds() {
+    shaders.finishPending();
+    bindProgram();
+}
+
+void GlDevice::beginFrame(Color clearColor) {
+    gpuTimer.beginFrame();
+    shaders.update();
+    bindProgram();
+
+    glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+    glClear(GL_COLOR_BUFFER_BIT);
+    if (shaderProgram) glUseProgram(shaderProgram);
+}
+
+void GlDevice::endFrame() {
+    gpuTimer.endFrame();
+}
+
+void GlDevice::uploadVertices(const float* data, size_t floatCount) {
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, floatCount * sizeof(float), data, GL_DYNAMIC_DRAW);
+}
+
+void GlDevice::setColor(Color color) {
+    if (!shaderProgram) return;
+    glUniform4f(colorLocation, color.r, color.g, color.b, color.a);
+}
+
+void GlDevice::setTransform(const float* matrix) {
+    if (!shaderProgram) return;
+    glUniformMatrix4fv(transformLocation, 1, GL_FALSE, matrix);
+}
+
+void GlDevice::draw(PrimitiveType primitive, int firstVertex, int vertexCount) {
+    if (!shaderProgram) return;  // First build still in flight
+    GLenum mode = GL_TRIANGLES;
+    switch (primitive) {
+    case PrimitiveType::LINES: mode = GL_LINES; break;
+    case PrimitiveType::TRIANGLES: mode = GL_TRIANGLES; break;
+    case PrimitiveType::TRIANGLE_FAN: mode = GL_TRIANGLE_FAN; break;
+    }
+    glBindVertexArray(VAO);
+    glDrawArrays(mode, firstVertex, vertexCount);
+    glBindVertexArray(0);
+}
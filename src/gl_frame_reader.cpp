@@ -0,0 +1,97 @@
+#include "../include/gl_frame_reader.hpp"
+#include "../include/logger.hpp"
+#include <cstring>
+
+namespace {
+    const GLuint64 FLUSH_TIMEOUT_NS = 1000000000ull;
+}
+
+GlFrameReader::GlFrameReader()
+    : pbos(), fences(), width(0), height(0), head(0), pending(0) {}
+
+bool GlFrameReader::initialize(int frameWidth, int frameHeight) {
+    if (!GLEW_VERSION_3_2 && !GLEW_ARB_sync) {
+        LOG_WARN("Capture: fence sync unavailable, frame capture disabled");
+        return false;
+    }
+    width = frameWidth;
+    height = frameHeight;
+
+    glGenBuffers(PBO_COUNT, pbos);
+    for (int i = 0; i < PBO_COUNT; i++) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(width) * height * 4, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    head = pending = 0;
+    return glGetError() == GL_NO_ERROR;
+}
+
+void GlFrameReader::cleanup() {
+    for (int i = 0; i < PBO_COUNT; i++) {
+        if (fences[i]) glDeleteSync(fences[i]);
+        fences[i] = 0;
+    }
+    if (pbos[0]) glDeleteBuffers(PBO_COUNT, pbos);
+    for (int i = 0; i < PBO_COUNT; i++) pbos[i] = 0;
+    head = pending = 0;
+}
+
+void GlFrameReader::collect(FrameCapture& capture, bool wait) {
+    while (pending > 0) {
+        GLenum status = glClientWaitSync(fences[head], wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                         wait ? FLUSH_TIMEOUT_NS : 0);
+        if (status == GL_TIMEOUT_EXPIRED && !wait) return;  // Still in flight: try next frame
+        glDeleteSync(fences[head]);
+        fences[head] = 0;
+
+        bool captured = false;
+        if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[head]);
+            const uint8_t* mapped = static_cast<const uint8_t*>(glMapBufferRange(
+                GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(width) * height * 4, GL_MAP_READ_BIT));
+            if (mapped) {
+                uint8_t* frame = capture.acquireFrame();  // Counts the drop itself when the pool is empty
+                if (frame) {
+                    // GL rows are bottom-up; flip while copying out
+                    size_t rowBytes = static_cast<size_t>(width) * 4;
+                    for (int y = 0; y < height; y++) {
+                        std::memcpy(frame + y * rowBytes, mapped + (height - 1 - y) * rowBytes, rowBytes);
+                    }
+                    capture.submitFrame(frame);
+                }
+                captured = true;
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+        if (!captured) capture.noteDroppedFrame();
+
+        head = (head + 1) % PBO_COUNT;
+        pending--;
+    }
+}
+
+void GlFrameReader::readFrame(FrameCapture& capture) {
+    if (!pbos[0] || !capture.isActive()) return;
+    collect(capture, false);
+
+    if (pending == PBO_COUNT) {
+        // GPU more than PBO_COUNT frames behind: skip this one
+        capture.noteDroppedFrame();
+        return;
+    }
+
+    int slot = (head + pending) % PBO_COUNT;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[slot]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pending++;
+}
+
+void GlFrameReader::flush(FrameCapture& capture) {
+    if (!pbos[0]) return;
+    collect(capture, true);
+}
@@ -0,0 +1,109 @@
+#include "../include/gpu_timer.hpp"
+#include "../include/logger.hpp"
+
+GpuTimer::GpuTimer()
+    : queries(), issued(), slotComplete(), frameSlot(0), activePass(-1), supported(false),
+      passMs(), summaryMs(), summaryFrames(0) {}
+
+bool GpuTimer::initialize() {
+    supported = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+
+    // Some drivers expose the entry points but a zero-bit counter
+    if (supported) {
+        GLint counterBits = 0;
+        glGetQueryiv(GL_TIME_ELAPSED, GL_QUERY_COUNTER_BITS, &counterBits);
+        supported = counterBits > 0;
+    }
+
+    if (supported) {
+        glGenQueries(FRAMES_IN_FLIGHT * RENDER_PASS_COUNT, &queries[0][0]);
+        supported = glGetError() == GL_NO_ERROR;
+    }
+
+    if (!supported) {
+        LOG_WARN("GPU timer queries unavailable, per-pass GPU times disabled");
+    }
+    return supported;
+}
+
+void GpuTimer::cleanup() {
+    if (supported) glDeleteQueries(FRAMES_IN_FLIGHT * RENDER_PASS_COUNT, &queries[0][0]);
+    supported = false;
+}
+
+void GpuTimer::collectSlot(int slot) {
+    bool complete = slotComplete[slot];
+    float frameMs[RENDER_PASS_COUNT] = {};  // Passes the frame didn't issue took no time
+    for (int pass = 0; pass < RENDER_PASS_COUNT; pass++) {
+        if (!issued[slot][pass]) continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(queries[slot][pass], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            // Still in flight: drop the frame rather than block
+            complete = false;
+            continue;
+        }
+
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(queries[slot][pass], GL_QUERY_RESULT, &elapsedNs);
+        frameMs[pass] = elapsedNs / 1.0e6f;
+        issued[slot][pass] = false;
+    }
+    if (!complete) return;
+
+    for (int pass = 0; pass < RENDER_PASS_COUNT; pass++) {
+        passMs[pass] = frameMs[pass];
+        summaryMs[pass] += frameMs[pass];
+    }
+    if (++summaryFrames >= GPU_TIMER_SUMMARY_FRAMES) logSummary();
+}
+
+void GpuTimer::logSummary() {
+    for (int pass = 0; pass < RENDER_PASS_COUNT; pass++) {
+        LOG_INFO("GPU pass {}: {} ms avg over {} frames", getRenderPassName(static_cast<RenderPass>(pass)),
+                 summaryMs[pass] / summaryFrames, summaryFrames);
+        summaryMs[pass] = 0;
+    }
+    summaryFrames = 0;
+}
+
+void GpuTimer::beginFrame() {
+    if (!supported) return;
+    // This slot was last used FRAMES_IN_FLIGHT frames ago
+    collectSlot(frameSlot);
+    slotComplete[frameSlot] = true;
+}
+
+void GpuTimer::beginPass(RenderPass pass) {
+    if (!supported) return;
+    if (activePass >= 0) endPass();  // Elapsed-time queries can't nest
+
+    int index = static_cast<int>(pass);
+    if (issued[frameSlot][index]) {
+        // Previous result still pending: this frame won't have every pass
+        slotComplete[frameSlot] = false;
+        return;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, queries[frameSlot][index]);
+    activePass = index;
+}
+
+void GpuTimer::endPass() {
+    if (!supported || activePass < 0) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    issued[frameSlot][activePass] = true;
+    activePass = -1;
+}
+
+void GpuTimer::endFrame() {
+    if (!supported) return;
+    endPass();
+    frameSlot = (frameSlot + 1) % FRAMES_IN_FLIGHT;
+}
+
+float GpuTimer::getFrameTimeMs() const {
+    float total = 0;
+    for (int pass = 0; pass < RENDER_PASS_COUNT; pass++) total += passMs[pass];
+    return total;
+}
@@ -0,0 +1,134 @@
+#include "../include/input.hpp"
+#include "../include/logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+uint64_t inputNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+InputSystem::InputSystem() : eventCount(0), droppedEvents(0), held() {}
+
+void InputSystem::push(const InputEvent& event) {
+    if (eventCount == INPUT_QUEUE_CAPACITY) {
+        droppedEvents++;
+        return;
+    }
+    events[eventCount++] = event;
+}
+
+void InputSystem::pushAction(InputAction action, bool pressed) {
+    InputEvent event;
+    event.timestampNs = inputNowNs();
+    event.isCursor = false;
+    event.action = action;
+    event.pressed = pressed;
+    push(event);
+}
+
+void InputSystem::pushCursor(Vec2 position) {
+    // Only the latest position matters: coalesce consecutive moves
+    if (eventCount > 0 && events[eventCount - 1].isCursor) {
+        events[eventCount - 1].cursor = position;
+        return;
+    }
+    InputEvent event;
+    event.timestampNs = inputNowNs();
+    event.isCursor = true;
+    event.action = InputAction::COUNT;
+    event.pressed = false;
+    event.cursor = position;
+    push(event);
+}
+
+InputFrame InputSystem::sample() {
+    InputFrame frame;
+    frame.eventCount = eventCount;
+    frame.droppedEvents = static_cast<int>(droppedEvents);
+    droppedEvents = 0;
+    frame.oldestEventNs = eventCount > 0 ? events[0].timestampNs : 0;
+    std::fill(frame.presses, frame.presses + INPUT_ACTION_COUNT, 0);
+
+    for (int i = 0; i < eventCount; i++) {
+        const InputEvent& event = events[i];
+        if (event.isCursor) {
+            mousePosition = event.cursor;
+            continue;
+        }
+        int index = static_cast<int>(event.action);
+        if (event.pressed && !held[index]) frame.presses[index]++;
+        held[index] = event.pressed;
+    }
+    eventCount = 0;
+
+    frame.mousePosition = mousePosition;
+    std::copy(held, held + INPUT_ACTION_COUNT, frame.held);
+    frame.sampleNs = inputNowNs();
+    return frame;
+}
+
+FramePacer::FramePacer()
+    : refreshMs(1000.0f / 60.0f), workMs(), workHead(0), lastPresentNs(0), lastSampleNs(0),
+      lastOldestEventNs(0), lastDelayMs(0), lastEvents(0), lastDroppedEvents(0), latency(), latencyHead(0),
+      enabled(false) {}
+
+void FramePacer::setRefreshRate(int hz) {
+    if (hz > 0) refreshMs = 1000.0f / hz;
+}
+
+void FramePacer::toggle() {
+    enabled = !enabled;
+    LOG_INFO("Frame pacing {} ({} ms refresh)", enabled ? "on" : "off", refreshMs);
+}
+
+float FramePacer::predictWorkMs() const {
+    // Worst recent frame: a late sample misses vsync, which costs a whole frame
+    return *std::max_element(workMs, workMs + FRAME_PACING_HISTORY);
+}
+
+void FramePacer::waitForSampleTime() {
+    lastDelayMs = 0;
+    if (!enabled || lastPresentNs == 0) return;
+
+    // The previous swap returned at (roughly) a vsync; the next one is a refresh later
+    float sincePresent = (inputNowNs() - lastPresentNs) / 1.0e6f;
+    float delay = refreshMs - predictWorkMs() - FRAME_PACING_MARGIN_MS - sincePresent;
+    delay = std::min(delay, FRAME_PACING_MAX_DELAY_MS);
+    if (delay <= 0) return;
+
+    std::this_thread::sleep_for(std::chrono::duration<float, std::milli>(delay));
+    lastDelayMs = delay;
+}
+
+void FramePacer::markSampled(const InputFrame& frame) {
+    lastSampleNs = frame.sampleNs;
+    lastOldestEventNs = frame.oldestEventNs;
+    lastEvents = frame.eventCount;
+    lastDroppedEvents = frame.droppedEvents;
+    if (frame.droppedEvents > 0) LOG_WARN("Input: {} events dropped, queue full", frame.droppedEvents);
+}
+
+void FramePacer::markSubmitted(uint64_t submitNs) {
+    // CPU work only: the swap itself may block until vsync
+    workMs[workHead] = (submitNs - lastSampleNs) / 1.0e6f;
+    workHead = (workHead + 1) % FRAME_PACING_HISTORY;
+}
+
+void FramePacer::markPresented(uint64_t presentNs) {
+    lastPresentNs = presentNs;
+    InputLatencySample& sample = latency[latencyHead];
+    sample.eventToPresentMs = lastOldestEventNs ? (presentNs - lastOldestEventNs) / 1.0e6f : 0;
+    sample.sampleToPresentMs = (presentNs - lastSampleNs) / 1.0e6f;
+    sample.pacingDelayMs = lastDelayMs;
+    sample.events = lastEvents;
+    sample.droppedEvents = lastDroppedEvents;
+    latencyHead = (latencyHead + 1) % INPUT_LATENCY_HISTORY;
+}
+
+const InputLatencySample& FramePacer::getLatency(int age) const {
+    int index = (latencyHead - 1 - age) % INPUT_LATENCY_HISTORY;
+    if (index < 0) index += INPUT_LATENCY_HISTORY;
+    return latency[index];
+}
@@ -0,0 +1,189 @@
+#include "../include/logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstring>
+
+namespace {
+    const size_t LOG_LINE_SIZE = 512;
+
+#ifdef NDEBUG
+    const LogLevel DEFAULT_LOG_LEVEL = LogLevel::INFO;
+#else
+    const LogLevel DEFAULT_LOG_LEVEL = LogLevel::DEBUG;
+#endif
+
+    uint64_t steadyNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    const char* levelName(LogLevel level) {
+        switch (level) {
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO: return "INFO ";
+        case LogLevel::WARN: return "WARN ";
+        case LogLevel::ERROR: return "ERROR";
+        }
+        return "?????";
+    }
+
+    // Hands the thread's ring back when the thread exits, for the next new
+    // thread to reuse
+    struct RingLease {
+        bool held = false;
+
+        ~RingLease() {
+            if (held && threadLogRing) threadLogRing->leased.store(false, std::memory_order_release);
+        }
+    };
+
+    thread_local RingLease ringLease;
+}
+
+Logger::Logger()
+    : clockNs(0), minLevel(static_cast<int>(DEFAULT_LOG_LEVEL)), running(true), output(stdout),
+      startNs(steadyNs()) {
+    writer = std::thread(&Logger::writerLoop, this);
+}
+
+Logger::~Logger() {
+    running.store(false, std::memory_order_release);
+    if (writer.joinable()) writer.join();
+}
+
+LogRing* Logger::acquireRing() {
+    LogRing* ring = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (std::unique_ptr<LogRing>& candidate : rings) {
+            if (!candidate->leased.load(std::memory_order_acquire)) {
+                ring = candidate.get();
+                break;
+            }
+        }
+        if (!ring) {
+            rings.emplace_back(new LogRing());
+            ring = rings.back().get();
+            ring->owner = this;
+        }
+        ring->leased.store(true, std::memory_order_relaxed);
+    }
+    threadLogRing = ring;
+    ringLease.held = true;
+    return ring;
+}
+
+void Logger::updateClock() {
+    clockNs.store(steadyNs() - startNs, std::memory_order_relaxed);
+}
+
+uint64_t Logger::getDroppedCount() const {
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    uint64_t dropped = 0;
+    for (const std::unique_ptr<LogRing>& ring : rings) dropped += ring->dropped.load(std::memory_order_relaxed);
+    return dropped;
+}
+
+void Logger::writeRecord(const LogRecord& record, char* line, size_t lineSize) {
+    int len = std::snprintf(line, lineSize, "[%9.3f] %s ",
+                            record.timestampNs / 1e9, levelName(record.level));
+    size_t pos = len > 0 ? static_cast<size_t>(len) : 0;
+
+    int argIndex = 0;
+    for (const char* f = record.format; *f && pos < lineSize - 1; f++) {
+        if (f[0] == '{' && f[1] == '}' && argIndex < record.argCount) {
+            const LogArg& arg = record.args[argIndex++];
+            size_t room = lineSize - pos;
+            switch (arg.type) {
+            case LogArg::Type::INT: len = std::snprintf(line + pos, room, "%" PRId64, arg.i); break;
+            case LogArg::Type::UINT: len = std::snprintf(line + pos, room, "%" PRIu64, arg.u); break;
+            case LogArg::Type::FLOAT: len = std::snprintf(line + pos, room, "%.3f", arg.f); break;
+            case LogArg::Type::STRING: len = std::snprintf(line + pos, room, "%s", arg.s); break;
+            }
+            pos = std::min(pos + (len > 0 ? static_cast<size_t>(len) : 0), lineSize - 1);
+            f++;
+        } else {
+            line[pos++] = *f;
+        }
+    }
+    line[pos++] = '\n';
+    std::fwrite(line, 1, pos, output);
+}
+
+void Logger::writerLoop() {
+    char line[LOG_LINE_SIZE + 1];
+    std::vector<LogRing*> active;
+    uint64_t reportedDrops = 0;
+
+    for (;;) {
+        updateClock();
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            if (active.size() != rings.size()) {
+                active.clear();
+                for (std::unique_ptr<LogRing>& ring : rings) active.push_back(ring.get());
+            }
+        }
+
+        // Merge the rings: always write the oldest pending record next
+        bool wrote = false;
+        for (;;) {
+            LogRing* oldest = nullptr;
+            uint64_t oldestNs = 0;
+            for (LogRing* ring : active) {
+                size_t tail = ring->tail.load(std::memory_order_relaxed);
+                if (tail == ring->head.load(std::memory_order_acquire)) continue;
+                uint64_t ns = ring->records[tail & (LOG_QUEUE_CAPACITY - 1)].timestampNs;
+                if (!oldest || ns < oldestNs) {
+                    oldest = ring;
+                    oldestNs = ns;
+                }
+            }
+            if (!oldest) break;
+            size_t tail = oldest->tail.load(std::memory_order_relaxed);
+            writeRecord(oldest->records[tail & (LOG_QUEUE_CAPACITY - 1)], line, LOG_LINE_SIZE);
+            oldest->tail.store(tail + 1, std::memory_order_release);
+            wrote = true;
+        }
+
+        uint64_t dropped = 0;
+        for (LogRing* ring : active) dropped += ring->dropped.load(std::memory_order_relaxed);
+        if (dropped != reportedDrops) {
+            std::fprintf(output, "[logger] %" PRIu64 " records dropped (queue full)\n", dropped - reportedDrops);
+            reportedDrops = dropped;
+            wrote = true;
+        }
+
+        if (wrote) {
+            std::fflush(output);
+            for (LogRing* ring : active) {
+                ring->written.store(ring->tail.load(std::memory_order_relaxed), std::memory_order_release);
+            }
+        } else if (!running.load(std::memory_order_acquire)) {
+            break;  // Drained and shutting down
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+}
+
+void Logger::flush() {
+    std::vector<std::pair<LogRing*, size_t>> targets;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (std::unique_ptr<LogRing>& ring : rings) {
+            targets.emplace_back(ring.get(), ring->head.load(std::memory_order_acquire));
+        }
+    }
+    for (const std::pair<LogRing*, size_t>& target : targets) {
+        while (target.first->written.load(std::memory_order_acquire) < target.second) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+Logger& getLogger() {
+    static Logger logger;
+    return logger;
+}
@@ -0,0 +1,193 @@
+#include "../include/match_host.hpp"
+#include "../include/frame_arena.hpp"
+#include "../include/input.hpp"
+#include "../include/logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace {
+    const uint64_t TICK_NS = static_cast<uint64_t>(NET_TICK_SECONDS * 1e9);
+
+    uint64_t threadCpuNs() {
+        timespec now;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + now.tv_nsec;
+    }
+}
+
+MatchHost::MatchHost(int matchCount, int threadCount, const MatchHostConfig& config)
+    : config(config), epollFd(-1), tickCount(0), nextTickNs(0), lateTicks(0), skippedTicks(0), jobNowNs(0),
+      jobGeneration(0), pendingWorkers(0), stopping(false), nextChunk(0) {
+    NetServerConfig serverConfig;
+    serverConfig.hostPlayer = false;
+    serverConfig.snapshotInterval = config.snapshotInterval;
+    serverConfig.timeoutSeconds = config.timeoutSeconds;
+    for (int i = 0; i < std::max(1, matchCount); i++) {
+        matches.emplace_back(new Match(serverConfig));
+        // Nobody watches a dedicated server: no log spam, no particles
+        matches.back()->game.logEvents = false;
+        matches.back()->game.spawnEffects = false;
+    }
+
+    if (threadCount <= 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    int chunkCount = (getMatchCount() + MATCHES_PER_CHUNK - 1) / MATCHES_PER_CHUNK;
+    threadCount = std::min(threadCount, chunkCount);
+    for (int i = 1; i < threadCount; i++) {
+        workers.emplace_back(&MatchHost::workerLoop, this);
+    }
+}
+
+MatchHost::~MatchHost() {
+    stop();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+bool MatchHost::start() {
+    stop();
+    epollFd = epoll_create1(0);
+    if (epollFd < 0) {
+        LOG_ERROR("MatchHost: epoll_create1 failed");
+        return false;
+    }
+    for (int i = 0; i < getMatchCount(); i++) {
+        uint16_t port = config.basePort ? static_cast<uint16_t>(config.basePort + i) : 0;
+        if (!matches[i]->server.start(port)) {
+            stop();
+            return false;
+        }
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u32 = static_cast<uint32_t>(i);
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, matches[i]->server.getDescriptor(), &event);
+    }
+    events.resize(matches.size());
+    LOG_INFO("MatchHost: {} matches on {} threads, ports {}-{}", getMatchCount(), getThreadCount(),
+             static_cast<int>(getPort(0)), static_cast<int>(getPort(getMatchCount() - 1)));
+    return true;
+}
+
+void MatchHost::stop() {
+    for (std::unique_ptr<Match>& match : matches) {
+        if (match->server.isRunning()) match->server.stop();
+    }
+    if (epollFd >= 0) ::close(epollFd);
+    epollFd = -1;
+}
+
+int MatchHost::getPlayerCount() const {
+    int players = 0;
+    for (const std::unique_ptr<Match>& match : matches) players += match->server.getClientCount();
+    return players;
+}
+
+void MatchHost::resetStats() {
+    for (std::unique_ptr<Match>& match : matches) {
+        int players = match->stats.players;
+        match->stats = MatchStats();
+        match->stats.players = players;
+    }
+    lateTicks = 0;
+    skippedTicks = 0;
+}
+
+void MatchHost::workerLoop() {
+    uint64_t seenGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = jobGeneration;
+        }
+        runChunks();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pendingWorkers == 0) done.notify_one();
+        }
+    }
+}
+
+void MatchHost::runChunks() {
+    int matchCount = getMatchCount();
+    int chunkCount = (matchCount + MATCHES_PER_CHUNK - 1) / MATCHES_PER_CHUNK;
+    for (int chunk = nextChunk.fetch_add(1); chunk < chunkCount; chunk = nextChunk.fetch_add(1)) {
+        int end = std::min(matchCount, (chunk + 1) * MATCHES_PER_CHUNK);
+        for (int i = chunk * MATCHES_PER_CHUNK; i < end; i++) tickMatch(*matches[i]);
+    }
+}
+
+void MatchHost::runJob() {
+    nextChunk.store(0);
+    if (!workers.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pendingWorkers = static_cast<int>(workers.size());
+            jobGeneration++;
+        }
+        wake.notify_all();
+    }
+    runChunks();
+    if (!workers.empty()) {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return pendingWorkers == 0; });
+    }
+}
+
+void MatchHost::tickMatch(Match& match) {
+    uint64_t start = threadCpuNs();
+    bool hadPlayers = match.server.getClientCount() > 0;
+    match.server.tick(jobNowNs, match.readable);
+    match.readable = false;
+    getFrameArena().reset();
+
+    int players = match.server.getClientCount();
+    if (hadPlayers && players == 0) {
+        // Everyone left: the next group gets a fresh game
+        match.game.reset();
+    }
+    uint64_t cpuNs = threadCpuNs() - start;
+    match.stats.cpuNs += cpuNs;
+    match.stats.peakTickNs = std::max(match.stats.peakTickNs, cpuNs);
+    if (players > 0) match.stats.ticks++;
+    match.stats.players = players;
+}
+
+void MatchHost::tick(uint64_t nowNs) {
+    // Level-triggered and sized for every socket, so one call reports them all
+    if (epollFd >= 0) {
+        int ready = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), 0);
+        for (int i = 0; i < ready; i++) matches[events[i].data.u32]->readable = true;
+    }
+    getLogger().updateClock();
+    jobNowNs = nowNs;
+    runJob();
+    tickCount++;
+}
+
+void MatchHost::run(const std::atomic<bool>& stop, uint64_t untilNs) {
+    if (nextTickNs == 0) nextTickNs = inputNowNs();
+    while (!stop.load(std::memory_order_relaxed)) {
+        uint64_t now = inputNowNs();
+        if (now >= untilNs) return;
+        if (now < nextTickNs) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(std::min(nextTickNs, untilNs) - now));
+            continue;
+        }
+        if (now - nextTickNs > MATCH_HOST_MAX_CATCH_UP * TICK_NS) {
+            uint64_t behind = (now - nextTickNs) / TICK_NS;
+            skippedTicks += behind;
+            nextTickNs += behind * TICK_NS;
+        }
+        if (now - nextTickNs >= TICK_NS) lateTicks++;
+        tick(now);
+        nextTickNs += TICK_NS;
+    }
+}
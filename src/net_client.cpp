@@ -0,0 +1,236 @@
+#include "../include/net_client.hpp"
+#include "../include/logger.hpp"
+#include "../include/profiler.hpp"
+#include <algorithm>
+
+namespace {
+    const uint64_t CONNECT_RETRY_NS = 250000000;
+}
+
+NetClient::NetClient(const LinkConditions& link, uint64_t seed)
+    : conditioner(link, seed), status(Status::DISCONNECTED), player(-1), lastConnectNs(0),
+      newestTick(0), processedSequence(0), inputs(), sequence(0), receiveBuffer(NET_MAX_PACKET) {
+    view.logEvents = false;
+    view.spawnEffects = false;
+}
+
+NetClient::~NetClient() {
+    disconnect();
+}
+
+void NetClient::sendConnect(uint64_t nowNs) {
+    writePacketHeader(packet, NetPacketType::CONNECT);
+    if (!socket.send(server, packet.getData(), packet.getSize())) stats.sendFailures++;
+    lastConnectNs = nowNs;
+}
+
+bool NetClient::connect(const NetAddress& address, uint64_t nowNs) {
+    disconnect();
+    if (!socket.open(0)) return false;
+    server = address;
+    status = Status::CONNECTING;
+    newestTick = 0;
+    processedSequence = 0;
+    sequence = 0;
+    for (NetState& state : states) state.tick = 0;
+    for (PartialSnapshot& partial : partials) partial.tick = 0;
+    sendConnect(nowNs);
+    return true;
+}
+
+void NetClient::disconnect() {
+    if (status != Status::DISCONNECTED) {
+        writePacketHeader(packet, NetPacketType::DISCONNECT);
+        if (!socket.send(server, packet.getData(), packet.getSize())) stats.sendFailures++;
+    }
+    status = Status::DISCONNECTED;
+    socket.close();
+}
+
+const NetState* NetClient::getNewestState() const {
+    return newestTick ? &states[newestTick % NET_SNAPSHOT_HISTORY] : nullptr;
+}
+
+void NetClient::handleSnapshot(NetReader& in, bool& updated) {
+    uint32_t tick = in.readU32();
+    uint32_t baselineTick = in.readU32();
+    uint32_t processed = in.readU32();
+    int snapshotPlayer = in.readU8();
+    int part = in.readU8();
+    int partCount = in.readU8();
+    // Older than what we have: nothing to learn from it
+    if (!in.isOk() || tick <= newestTick || snapshotPlayer != player) return;
+    size_t size = in.getRemaining();
+    if (part >= partCount || size > NET_SNAPSHOT_PART_BYTES || (part + 1 < partCount && size != NET_SNAPSHOT_PART_BYTES)) {
+        stats.undecodable++;
+        return;
+    }
+    if (partCount == 1) {
+        stats.snapshots++;
+        applySnapshot(in, tick, baselineTick, processed, updated);
+        return;
+    }
+
+    PartialSnapshot& partial = partials[tick % PARTIAL_SNAPSHOTS];
+    if (partial.tick != tick) {
+        if (partial.tick) stats.incompleteSnapshots++;
+        partial.tick = tick;
+        partial.baselineTick = baselineTick;
+        partial.processed = processed;
+        partial.partCount = partCount;
+        partial.received = 0;
+        partial.size = 0;
+        partial.hasPart.assign(partCount, 0);
+        partial.bytes.resize(partCount * NET_SNAPSHOT_PART_BYTES);
+    } else if (partial.partCount != partCount || partial.baselineTick != baselineTick) {
+        stats.undecodable++;
+        return;
+    }
+    if (partial.hasPart[part]) return;  // Duplicate
+    partial.hasPart[part] = 1;
+    partial.received++;
+    in.readBytes(partial.bytes.data() + part * NET_SNAPSHOT_PART_BYTES, size);
+    if (part + 1 == partCount) partial.size = part * NET_SNAPSHOT_PART_BYTES + size;
+    if (partial.received < partCount) return;
+
+    partial.tick = 0;
+    stats.snapshots++;
+    NetReader state(partial.bytes.data(), partial.size);
+    applySnapshot(state, tick, partial.baselineTick, partial.processed, updated);
+}
+
+void NetClient::applySnapshot(NetReader& in, uint32_t tick, uint32_t baselineTick, uint32_t processed, bool& updated) {
+    const NetState* baseline = nullptr;
+    if (baselineTick) {
+        const NetState& candidate = states[baselineTick % NET_SNAPSHOT_HISTORY];
+        if (baselineTick >= tick || tick - baselineTick >= static_cast<uint32_t>(NET_SNAPSHOT_HISTORY) ||
+            candidate.tick != baselineTick) {
+            stats.undecodable++;
+            return;
+        }
+        baseline = &candidate;
+    }
+
+    NetState& state = states[tick % NET_SNAPSHOT_HISTORY];
+    if (!decodeNetState(in, baseline, tick, state)) {
+        state.tick = 0;
+        stats.undecodable++;
+        return;
+    }
+    newestTick = tick;
+    processedSequence = std::min(processed, sequence);
+    updated = true;
+}
+
+void NetClient::receive(uint64_t nowNs) {
+    PROFILE_SCOPE("NetClient::receive");
+    if (status == Status::DISCONNECTED) return;
+    stats.sendFailures += conditioner.flush(socket, nowNs);
+    if (status == Status::CONNECTING && nowNs >= lastConnectNs + CONNECT_RETRY_NS) sendConnect(nowNs);
+
+    bool updated = false;
+    NetAddress from;
+    while (size_t size = socket.receive(from, receiveBuffer.data(), receiveBuffer.size())) {
+        if (from != server) continue;
+        NetReader in(receiveBuffer.data(), size);
+        NetPacketType type;
+        if (!readPacketHeader(in, type)) continue;
+
+        switch (type) {
+        case NetPacketType::ACCEPT:
+            if (status == Status::CONNECTING) {
+                player = in.readU8();
+                status = Status::CONNECTED;
+                LOG_INFO("Net: joined as player {}", player);
+            }
+            break;
+        case NetPacketType::REJECT:
+            LOG_WARN("Net: server is full");
+            status = Status::DISCONNECTED;
+            return;
+        case NetPacketType::DISCONNECT:
+            LOG_INFO("Net: server closed the game");
+            status = Status::DISCONNECTED;
+            return;
+        case NetPacketType::SNAPSHOT:
+            if (status != Status::CONNECTED) break;
+            stats.snapshotBytes += size;
+            handleSnapshot(in, updated);
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (updated) {
+        applyNetState(states[newestTick % NET_SNAPSHOT_HISTORY], player, view);
+        reconcile();
+    }
+}
+
+bool NetClient::isPredicting() const {
+    return newestTick > 0 && view.gameState == GameState::PLAYING && predicted.isAlive();
+}
+
+// What GameManager::update() does to a wingman, minus firing, which is
+// left to the server
+void NetClient::predict(const NetInput& input) {
+    ShipInput shipInput = toShipInput(input);
+    if (shipInput.reload && predicted.ammo < predicted.maxAmmo) {
+        int score = view.score;
+        predicted.reload(score);
+    }
+    predicted.velocity = shipInput.velocity;
+    predicted.update(NET_TICK_SECONDS, shipInput.aimTarget);
+}
+
+void NetClient::reconcile() {
+    // The view's spacecraft now holds the server's ship as of processedSequence
+    if (processedSequence > 0 && sequence - processedSequence < static_cast<uint32_t>(NET_INPUT_HISTORY)) {
+        float error = (predictedPositions[processedSequence % NET_INPUT_HISTORY] - view.spacecraft.position).length();
+        stats.predictionSamples++;
+        stats.predictionErrorSum += error;
+        stats.maxPredictionError = std::max(stats.maxPredictionError, error);
+    }
+
+    predicted = view.spacecraft;
+    if (!isPredicting()) return;
+    uint32_t oldest = sequence > static_cast<uint32_t>(NET_INPUT_HISTORY) ? sequence - NET_INPUT_HISTORY + 1 : 1;
+    for (uint32_t s = std::max(processedSequence + 1, oldest); s <= sequence; s++) {
+        predict(inputs[s % NET_INPUT_HISTORY]);
+        predictedPositions[s % NET_INPUT_HISTORY] = predicted.position;
+    }
+    view.spacecraft = predicted;
+}
+
+void NetClient::sendInput(const ShipInput& input, bool start, uint64_t nowNs) {
+    if (status != Status::CONNECTED) return;
+    PROFILE_SCOPE("NetClient::sendInput");
+
+    sequence++;
+    NetInput quantized = quantizeInput(sequence, input, start);
+    inputs[sequence % NET_INPUT_HISTORY] = quantized;
+    if (isPredicting()) {
+        predict(quantized);
+        view.spacecraft = predicted;
+    }
+    predictedPositions[sequence % NET_INPUT_HISTORY] = predicted.position;
+
+    writePacketHeader(packet, NetPacketType::INPUT);
+    packet.writeU32(newestTick);
+    packet.writeU32(sequence);
+    int count = static_cast<int>(std::min<uint32_t>(sequence, NET_INPUT_REDUNDANCY));
+    packet.writeU8(static_cast<uint8_t>(count));
+    for (int i = 0; i < count; i++) {
+        const NetInput& sent = inputs[(sequence - i) % NET_INPUT_HISTORY];
+        packet.writeU8(static_cast<uint8_t>(sent.moveX));
+        packet.writeU8(static_cast<uint8_t>(sent.moveY));
+        packet.writeSignedVarint(sent.aimX);
+        packet.writeSignedVarint(sent.aimY);
+        packet.writeU8(sent.buttons);
+    }
+    if (!conditioner.send(socket, nowNs, server, packet.getData(), packet.getSize())) stats.sendFailures++;
+    stats.sendFailures += conditioner.flush(socket, nowNs);
+    stats.inputPackets++;
+    stats.inputBytes += packet.getSize();
+}
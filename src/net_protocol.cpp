@@ -0,0 +1,366 @@
+#include "../include/net_protocol.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    const float FULL_SPEED = SPACECRAFT_SPEED * 60.0f;
+    const float TWO_PI = 6.2831853f;
+    const int HEADING_STEPS = 256;
+    const int32_t ZERO_FIELDS[NET_MAX_FIELDS > NET_GLOBALS ? NET_MAX_FIELDS : NET_GLOBALS] = {};
+
+    int32_t quantizePosition(float value) {
+        return static_cast<int32_t>(std::lround(value * NET_POSITION_SCALE));
+    }
+
+    float toPosition(int32_t value) {
+        return value / NET_POSITION_SCALE;
+    }
+
+    int32_t quantizeAngle(float radians, int steps) {
+        int32_t step = static_cast<int32_t>(std::lround(radians / TWO_PI * steps)) % steps;
+        return step < 0 ? step + steps : step;
+    }
+
+    int8_t quantizeUnit(float value) {
+        return static_cast<int8_t>(std::lround(std::max(-1.0f, std::min(value, 1.0f)) * 127.0f));
+    }
+
+    int16_t quantizeAim(float value) {
+        return static_cast<int16_t>(std::max(-32768l, std::min(std::lround(value * NET_POSITION_SCALE), 32767l)));
+    }
+
+    bool byId(const NetEntity& a, const NetEntity& b) {
+        return a.id < b.id;
+    }
+
+    // Deltas wrap in uint32_t: a malformed packet reads as garbage, never as
+    // signed overflow
+    int32_t wrappingAdd(int32_t a, int32_t b) {
+        return static_cast<int32_t>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+    }
+
+    int32_t wrappingSubtract(int32_t a, int32_t b) {
+        return static_cast<int32_t>(static_cast<uint32_t>(a) - static_cast<uint32_t>(b));
+    }
+
+    void encodeFields(NetWriter& out, const int32_t* values, const int32_t* base, int count) {
+        uint8_t mask = 0;
+        for (int i = 0; i < count; i++) {
+            if (values[i] != base[i]) mask |= static_cast<uint8_t>(1 << i);
+        }
+        out.writeU8(mask);
+        for (int i = 0; i < count; i++) {
+            if (mask & (1 << i)) out.writeSignedVarint(wrappingSubtract(values[i], base[i]));
+        }
+    }
+
+    void decodeFields(NetReader& in, int32_t* values, const int32_t* base, int count) {
+        uint8_t mask = in.readU8();
+        if (mask >> count) in.fail();
+        for (int i = 0; i < count; i++) {
+            values[i] = wrappingAdd(base[i], (mask & (1 << i)) ? in.readSignedVarint() : 0);
+        }
+    }
+
+    // Entities are sorted by id, so the baseline is walked alongside
+    const int32_t* findBase(const std::vector<NetEntity>* baseEntities, size_t& cursor, uint32_t id) {
+        if (!baseEntities) return ZERO_FIELDS;
+        while (cursor < baseEntities->size() && (*baseEntities)[cursor].id < id) cursor++;
+        if (cursor < baseEntities->size() && (*baseEntities)[cursor].id == id) return (*baseEntities)[cursor].fields;
+        return ZERO_FIELDS;
+    }
+
+    bool isValid(int section, const NetEntity& e) {
+        switch (section) {
+        case NET_SHIPS: return e.id < static_cast<uint32_t>(MAX_PLAYERS);
+        case NET_ALIENS:
+            return e.fields[NET_ALIEN_TYPE] >= 0 && e.fields[NET_ALIEN_TYPE] <= static_cast<int32_t>(AlienType::BRUTE);
+        default: return true;
+        }
+    }
+}
+
+NetInput quantizeInput(uint32_t sequence, const ShipInput& input, bool start) {
+    NetInput q;
+    q.sequence = sequence;
+    q.moveX = quantizeUnit(input.velocity.x / FULL_SPEED);
+    q.moveY = quantizeUnit(input.velocity.y / FULL_SPEED);
+    q.aimX = quantizeAim(input.aimTarget.x);
+    q.aimY = quantizeAim(input.aimTarget.y);
+    q.buttons = (input.shooting ? NET_BUTTON_FIRE : 0) | (input.reload ? NET_BUTTON_RELOAD : 0) |
+                (start ? NET_BUTTON_START : 0);
+    return q;
+}
+
+ShipInput toShipInput(const NetInput& input) {
+    ShipInput s;
+    s.velocity = Vec2(input.moveX / 127.0f, input.moveY / 127.0f) * FULL_SPEED;
+    s.aimTarget = Vec2(input.aimX / NET_POSITION_SCALE, input.aimY / NET_POSITION_SCALE);
+    s.shooting = (input.buttons & NET_BUTTON_FIRE) != 0;
+    s.reload = (input.buttons & NET_BUTTON_RELOAD) != 0;
+    return s;
+}
+
+bool NetState::operator==(const NetState& other) const {
+    if (tick != other.tick || std::memcmp(globals, other.globals, sizeof(globals)) != 0) return false;
+    for (int s = 0; s < NET_SECTION_COUNT; s++) {
+        if (sections[s].size() != other.sections[s].size()) return false;
+        if (!sections[s].empty() &&
+            std::memcmp(sections[s].data(), other.sections[s].data(), sections[s].size() * sizeof(NetEntity)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void NetWriter::writeU32(uint32_t value) {
+    for (int i = 0; i < 4; i++) bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+void NetWriter::writeVarint(uint32_t value) {
+    while (value >= 0x80) {
+        bytes.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<uint8_t>(value));
+}
+
+void NetWriter::writeSignedVarint(int32_t value) {
+    uint32_t bits = static_cast<uint32_t>(value);
+    writeVarint((bits << 1) ^ (value < 0 ? 0xffffffffu : 0));
+}
+
+void NetWriter::writeBytes(const void* data, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    bytes.insert(bytes.end(), p, p + size);
+}
+
+NetReader::NetReader(const void* data, size_t size)
+    : data(static_cast<const uint8_t*>(data)), size(size), offset(0), failed(false) {}
+
+uint8_t NetReader::readU8() {
+    if (failed || offset >= size) {
+        failed = true;
+        return 0;
+    }
+    return data[offset++];
+}
+
+uint32_t NetReader::readU32() {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) value |= static_cast<uint32_t>(readU8()) << (8 * i);
+    return failed ? 0 : value;
+}
+
+uint32_t NetReader::readVarint() {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint8_t byte = readU8();
+        value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return failed ? 0 : value;
+    }
+    failed = true;
+    return 0;
+}
+
+int32_t NetReader::readSignedVarint() {
+    uint32_t bits = readVarint();
+    return static_cast<int32_t>((bits >> 1) ^ (0u - (bits & 1)));
+}
+
+void NetReader::readBytes(void* out, size_t count) {
+    if (failed || count > size - offset) {
+        failed = true;
+        return;
+    }
+    std::memcpy(out, data + offset, count);
+    offset += count;
+}
+
+void writePacketHeader(NetWriter& out, NetPacketType type) {
+    out.clear();
+    out.writeU32(NET_PROTOCOL_ID);
+    out.writeU8(static_cast<uint8_t>(type));
+}
+
+bool readPacketHeader(NetReader& in, NetPacketType& type) {
+    uint32_t id = in.readU32();
+    uint8_t value = in.readU8();
+    if (!in.isOk() || id != NET_PROTOCOL_ID || value > static_cast<uint8_t>(NetPacketType::DISCONNECT)) return false;
+    type = static_cast<NetPacketType>(value);
+    return true;
+}
+
+void captureNetState(const GameManager& game, uint32_t tick, NetState& out) {
+    out.tick = tick;
+    out.globals[NET_WAVE] = game.wave;
+    out.globals[NET_SCORE] = game.score;
+    out.globals[NET_KILLS] = game.killCount;
+    out.globals[NET_WAVE_ACTIVE] = game.waveActive;
+    out.globals[NET_GAME_STATE] = static_cast<int32_t>(game.gameState);
+
+    std::vector<NetEntity>& ships = out.sections[NET_SHIPS];
+    ships.clear();
+    for (int player = 0; player < game.getShipCount(); player++) {
+        const Spacecraft& ship = game.getShip(player);
+        NetEntity e = {};
+        e.id = static_cast<uint32_t>(player);
+        e.fields[NET_SHIP_X] = quantizePosition(ship.position.x);
+        e.fields[NET_SHIP_Y] = quantizePosition(ship.position.y);
+        e.fields[NET_SHIP_ROTATION] = quantizeAngle(ship.rotation, NET_ROTATION_STEPS);
+        // Rounded up, so a ship with any shield left still reads as alive
+        e.fields[NET_SHIP_SHIELD] = static_cast<int32_t>(std::ceil(ship.shield.getPercentage() * 255.0f));
+        e.fields[NET_SHIP_AMMO] = ship.ammo;
+        ships.push_back(e);
+    }
+
+    std::vector<NetEntity>& aliens = out.sections[NET_ALIENS];
+    aliens.clear();
+    for (size_t i = 0; i < game.aliens.size(); i++) {
+        const Alien& alien = game.aliens[i];
+        if (!alien.active) continue;
+        EntityHandle handle = game.aliens.handleAt(i);
+        NetEntity e = {};
+        e.id = handle.index;
+        e.fields[NET_ALIEN_X] = quantizePosition(alien.position.x);
+        e.fields[NET_ALIEN_Y] = quantizePosition(alien.position.y);
+        e.fields[NET_ALIEN_TYPE] = static_cast<int32_t>(alien.type);
+        e.fields[NET_ALIEN_HEALTH] = static_cast<int32_t>(std::lround(alien.health));
+        e.fields[NET_ALIEN_SPAWN] = static_cast<int32_t>(std::lround(alien.spawnAnimation * 255.0f));
+        e.fields[NET_ALIEN_GENERATION] = static_cast<int32_t>(handle.generation & 0xff);
+        aliens.push_back(e);
+    }
+    std::sort(aliens.begin(), aliens.end(), byId);
+
+    std::vector<NetEntity>& motherships = out.sections[NET_MOTHERSHIPS];
+    motherships.clear();
+    for (size_t i = 0; i < game.motherships.size(); i++) {
+        const Mothership& m = game.motherships[i];
+        if (!m.active) continue;
+        NetEntity e = {};
+        e.id = static_cast<uint32_t>(i);
+        e.fields[NET_MOTHERSHIP_X] = quantizePosition(m.position.x);
+        e.fields[NET_MOTHERSHIP_Y] = quantizePosition(m.position.y);
+        e.fields[NET_MOTHERSHIP_TO_SPAWN] = m.aliensToSpawn;
+        motherships.push_back(e);
+    }
+
+    std::vector<NetEntity>& plasmas = out.sections[NET_PLASMAS];
+    plasmas.clear();
+    for (size_t i = 0; i < game.plasmas.size(); i++) {
+        const Plasma& plasma = game.plasmas[i];
+        if (!plasma.active) continue;
+        EntityHandle handle = game.plasmas.handleAt(i);
+        NetEntity e = {};
+        e.id = handle.index;
+        e.fields[NET_PLASMA_X] = quantizePosition(plasma.position.x);
+        e.fields[NET_PLASMA_Y] = quantizePosition(plasma.position.y);
+        e.fields[NET_PLASMA_HEADING] = quantizeAngle(std::atan2(plasma.velocity.y, plasma.velocity.x), HEADING_STEPS);
+        e.fields[NET_PLASMA_GENERATION] = static_cast<int32_t>(handle.generation & 0xff);
+        plasmas.push_back(e);
+    }
+    std::sort(plasmas.begin(), plasmas.end(), byId);
+}
+
+void applyNetState(const NetState& state, int localPlayer, GameManager& view) {
+    view.wave = state.globals[NET_WAVE];
+    view.score = state.globals[NET_SCORE];
+    view.killCount = state.globals[NET_KILLS];
+    view.waveActive = state.globals[NET_WAVE_ACTIVE] != 0;
+    view.gameState = static_cast<GameState>(state.globals[NET_GAME_STATE]);
+    view.tickCount = state.tick;
+
+    const std::vector<NetEntity>& ships = state.sections[NET_SHIPS];
+    bool hasLocal = false;
+    for (const NetEntity& e : ships) hasLocal = hasLocal || static_cast<int>(e.id) == localPlayer;
+    size_t wingmanCount = ships.size() - (hasLocal ? 1 : 0);
+    view.wingmen.resize(wingmanCount);
+    view.wingmanInputs.resize(wingmanCount);
+    size_t wingman = 0;
+    for (const NetEntity& e : ships) {
+        Spacecraft& ship = static_cast<int>(e.id) == localPlayer ? view.spacecraft : view.wingmen[wingman++];
+        ship.position = Vec2(toPosition(e.fields[NET_SHIP_X]), toPosition(e.fields[NET_SHIP_Y]));
+        ship.rotation = e.fields[NET_SHIP_ROTATION] * TWO_PI / NET_ROTATION_STEPS;
+        ship.ammo = e.fields[NET_SHIP_AMMO];
+        ShieldState shield = ship.shield.getState();
+        shield.currentEnergy = e.fields[NET_SHIP_SHIELD] / 255.0f * shield.maxEnergy;
+        ship.shield.setState(shield);
+    }
+
+    // Animation clocks aren't replicated: derived from the tick, offset per entity
+    float animationTime = state.tick * NET_TICK_SECONDS;
+    view.aliens.clear();
+    for (const NetEntity& e : state.sections[NET_ALIENS]) {
+        Alien alien(Vec2(toPosition(e.fields[NET_ALIEN_X]), toPosition(e.fields[NET_ALIEN_Y])),
+                    static_cast<AlienType>(e.fields[NET_ALIEN_TYPE]), view.wave);
+        alien.health = static_cast<float>(e.fields[NET_ALIEN_HEALTH]);
+        alien.spawnAnimation = e.fields[NET_ALIEN_SPAWN] / 255.0f;
+        alien.animationTime = animationTime + e.id * 0.37f;
+        view.aliens.insert(alien);
+    }
+    view.rebuildAlienGrid();
+
+    view.motherships.clear();
+    for (const NetEntity& e : state.sections[NET_MOTHERSHIPS]) {
+        Mothership m(Vec2(toPosition(e.fields[NET_MOTHERSHIP_X]), toPosition(e.fields[NET_MOTHERSHIP_Y])),
+                     e.fields[NET_MOTHERSHIP_TO_SPAWN]);
+        m.animationTime = animationTime + e.id * 0.37f;
+        view.motherships.push_back(m);
+    }
+
+    view.plasmas.clear();
+    for (const NetEntity& e : state.sections[NET_PLASMAS]) {
+        float heading = e.fields[NET_PLASMA_HEADING] * TWO_PI / HEADING_STEPS;
+        Vec2 velocity = Vec2(std::cos(heading), std::sin(heading)) * (PLASMA_SPEED * 60.0f);
+        view.plasmas.insert(Plasma(Vec2(toPosition(e.fields[NET_PLASMA_X]), toPosition(e.fields[NET_PLASMA_Y])), velocity));
+    }
+}
+
+void encodeNetState(const NetState& state, const NetState* baseline, NetWriter& out) {
+    encodeFields(out, state.globals, baseline ? baseline->globals : ZERO_FIELDS, NET_GLOBALS);
+    for (int s = 0; s < NET_SECTION_COUNT; s++) {
+        const std::vector<NetEntity>& entities = state.sections[s];
+        const std::vector<NetEntity>* baseEntities = baseline ? &baseline->sections[s] : nullptr;
+        out.writeVarint(static_cast<uint32_t>(entities.size()));
+        uint32_t nextId = 0;
+        size_t cursor = 0;
+        for (const NetEntity& e : entities) {
+            out.writeVarint(e.id - nextId);
+            nextId = e.id + 1;
+            encodeFields(out, e.fields, findBase(baseEntities, cursor, e.id), NET_SECTION_FIELDS[s]);
+        }
+    }
+}
+
+bool decodeNetState(NetReader& in, const NetState* baseline, uint32_t tick, NetState& out) {
+    out.tick = tick;
+    decodeFields(in, out.globals, baseline ? baseline->globals : ZERO_FIELDS, NET_GLOBALS);
+    int32_t gameState = out.globals[NET_GAME_STATE];
+    if (gameState < 0 || gameState > static_cast<int32_t>(GameState::GAME_OVER_AMMO)) in.fail();
+
+    for (int s = 0; s < NET_SECTION_COUNT && in.isOk(); s++) {
+        std::vector<NetEntity>& entities = out.sections[s];
+        const std::vector<NetEntity>* baseEntities = baseline ? &baseline->sections[s] : nullptr;
+        uint32_t count = in.readVarint();
+        // Every entity takes at least two bytes, which bounds the count before allocating
+        if (count > in.getRemaining() / 2) {
+            in.fail();
+            break;
+        }
+        entities.resize(count);
+        uint32_t nextId = 0;
+        size_t cursor = 0;
+        for (uint32_t i = 0; i < count && in.isOk(); i++) {
+            NetEntity& e = entities[i];
+            uint32_t step = in.readVarint();
+            e.id = nextId + step;
+            if (e.id < nextId) in.fail();  // Wrapped around
+            nextId = e.id + 1;
+            std::fill(e.fields, e.fields + NET_MAX_FIELDS, 0);
+            decodeFields(in, e.fields, findBase(baseEntities, cursor, e.id), NET_SECTION_FIELDS[s]);
+            if (!isValid(s, e)) in.fail();
+        }
+    }
+    return in.isOk();
+}
@@ -0,0 +1,283 @@
+#include "../include/net_server.hpp"
+#include "../include/logger.hpp"
+#include "../include/profiler.hpp"
+#include <algorithm>
+
+NetServer::NetServer(GameManager& game, const NetServerConfig& config)
+    : game(game), config(config), conditioner(config.link, 0x5e5e),
+      playerZeroInput{Vec2(0, 0), Vec2(0, 0), false, false}, tickCount(0), receiveBuffer(NET_MAX_PACKET) {
+    if (this->config.snapshotInterval < 1) this->config.snapshotInterval = 1;
+}
+
+bool NetServer::start(uint16_t port) {
+    if (!socket.open(port)) return false;
+    LOG_INFO("Net: serving co-op on UDP port {}", static_cast<int>(socket.getPort()));
+    return true;
+}
+
+void NetServer::stop() {
+    for (const Client& client : clients) sendControl(client.address, NetPacketType::DISCONNECT, client.player);
+    clients.clear();
+    socket.close();
+}
+
+NetServer::Client* NetServer::findClient(const NetAddress& address) {
+    for (Client& client : clients) {
+        if (client.address == address) return &client;
+    }
+    return nullptr;
+}
+
+bool NetServer::isOwned(int player) const {
+    if (player == 0 && config.hostPlayer) return true;
+    for (const Client& client : clients) {
+        if (client.player == player) return true;
+    }
+    return false;
+}
+
+// Control packets are rare and repeated by the client if lost, so they skip the conditioner
+void NetServer::sendControl(const NetAddress& to, NetPacketType type, int player) {
+    writePacketHeader(packet, type);
+    packet.writeU8(static_cast<uint8_t>(player));
+    if (!socket.send(to, packet.getData(), packet.getSize())) stats.sendFailures++;
+}
+
+void NetServer::handleConnect(const NetAddress& from, uint64_t nowNs) {
+    if (Client* existing = findClient(from)) {
+        sendControl(from, NetPacketType::ACCEPT, existing->player);  // Our ACCEPT was lost
+        return;
+    }
+
+    int player = -1;
+    for (int p = 0; p < MAX_PLAYERS && player < 0; p++) {
+        if (!isOwned(p)) player = p;
+    }
+    if (player < 0) {
+        sendControl(from, NetPacketType::REJECT, 0);
+        return;
+    }
+    // Ships are only ever added, so free ones below the count are wrecks to reuse
+    while (game.getShipCount() <= player) game.addWingman();
+    game.respawnShip(player);
+
+    Client client = Client();
+    client.address = from;
+    client.player = player;
+    client.lastHeardNs = nowNs;
+    clients.push_back(client);
+    sendControl(from, NetPacketType::ACCEPT, player);
+    LOG_INFO("Net: player {} joined ({} connected)", player, static_cast<int>(clients.size()));
+}
+
+void NetServer::handleInput(Client& client, NetReader& in) {
+    uint32_t ackTick = in.readU32();
+    uint32_t newest = in.readU32();
+    int count = in.readU8();
+    if (!in.isOk() || count > NET_INPUT_REDUNDANCY || static_cast<uint32_t>(count) > newest) return;
+
+    if (ackTick > client.ackedTick && ackTick <= tickCount) client.ackedTick = ackTick;
+    for (int i = 0; i < count; i++) {
+        NetInput input;
+        input.sequence = newest - i;
+        input.moveX = static_cast<int8_t>(in.readU8());
+        input.moveY = static_cast<int8_t>(in.readU8());
+        int32_t aimX = in.readSignedVarint();
+        int32_t aimY = in.readSignedVarint();
+        input.buttons = in.readU8();
+        if (!in.isOk() || aimX != static_cast<int16_t>(aimX) || aimY != static_cast<int16_t>(aimY)) return;
+        input.aimX = static_cast<int16_t>(aimX);
+        input.aimY = static_cast<int16_t>(aimY);
+        // Older than what has been applied, or too far ahead to be kept
+        if (input.sequence <= client.processedSequence ||
+            input.sequence - client.processedSequence >= static_cast<uint32_t>(NET_INPUT_HISTORY)) {
+            continue;
+        }
+        client.inputs[input.sequence % NET_INPUT_HISTORY] = input;
+    }
+    if (newest > client.newestSequence) client.newestSequence = newest;
+}
+
+void NetServer::dropClient(size_t index) {
+    int player = clients[index].player;
+    clients.erase(clients.begin() + index);
+    LOG_INFO("Net: player {} left ({} connected)", player, static_cast<int>(clients.size()));
+}
+
+void NetServer::receive(uint64_t nowNs) {
+    PROFILE_SCOPE("NetServer::receive");
+    stats.sendFailures += conditioner.flush(socket, nowNs);
+
+    NetAddress from;
+    while (size_t size = socket.receive(from, receiveBuffer.data(), receiveBuffer.size())) {
+        stats.packetsReceived++;
+        stats.bytesReceived += size;
+        NetReader in(receiveBuffer.data(), size);
+        NetPacketType type;
+        if (!readPacketHeader(in, type)) continue;
+
+        if (type == NetPacketType::CONNECT) {
+            handleConnect(from, nowNs);
+            continue;
+        }
+        Client* client = findClient(from);
+        if (!client) continue;
+        client->lastHeardNs = nowNs;
+        if (type == NetPacketType::INPUT) {
+            handleInput(*client, in);
+        } else if (type == NetPacketType::DISCONNECT) {
+            dropClient(client - clients.data());
+        }
+    }
+    dropSilentClients(nowNs);
+}
+
+void NetServer::dropSilentClients(uint64_t nowNs) {
+    uint64_t timeoutNs = static_cast<uint64_t>(config.timeoutSeconds * 1e9f);
+    for (size_t i = clients.size(); i-- > 0;) {
+        if (nowNs > clients[i].lastHeardNs + timeoutNs) {
+            LOG_WARN("Net: player {} timed out", clients[i].player);
+            dropClient(i);
+        }
+    }
+}
+
+// START does what SPACE does in a local game
+void NetServer::applyStart() {
+    if (game.gameState != GameState::PLAYING) {
+        game.reset();
+        if (game.logEvents) LOG_INFO("=== NEW GAME STARTED ===");
+    } else if (!game.waveActive) {
+        game.startWave();
+    }
+}
+
+void NetServer::applyInputs() {
+    for (Client& client : clients) {
+        // A client that got ahead (a burst after a stall) skips to its recent inputs
+        if (client.newestSequence - client.processedSequence > static_cast<uint32_t>(NET_INPUT_REDUNDANCY)) {
+            client.processedSequence = client.newestSequence - 2;
+        }
+        uint32_t next = client.processedSequence + 1;
+        NetInput input;
+        if (client.newestSequence >= next) {
+            const NetInput& stored = client.inputs[next % NET_INPUT_HISTORY];
+            if (stored.sequence == next) {
+                input = stored;
+            } else {
+                // Lost despite the redundancy: move on without it
+                input = client.lastInput;
+                input.buttons &= NET_BUTTON_FIRE;
+                stats.inputsMissed++;
+            }
+            client.processedSequence = next;
+        } else {
+            // Late: keep doing what the player was doing, minus the presses
+            input = client.lastInput;
+            input.buttons &= NET_BUTTON_FIRE;
+            stats.inputsMissed++;
+        }
+        client.lastInput = input;
+
+        if (input.buttons & NET_BUTTON_START) applyStart();
+        ShipInput shipInput = toShipInput(input);
+        if (client.player > 0) {
+            game.wingmanInputs[client.player - 1] = shipInput;
+            continue;
+        }
+        // Player 0 on a dedicated server: what applyInput() does for a local player
+        playerZeroInput = shipInput;
+        if (game.gameState != GameState::PLAYING) continue;
+        if (shipInput.reload && game.spacecraft.ammo < game.spacecraft.maxAmmo) game.spacecraft.reload(game.score);
+        game.spacecraft.velocity = shipInput.velocity;
+    }
+
+    // Nobody flies a ship whose player left (or that reset() brought back)
+    for (int player = 0; player < game.getShipCount(); player++) {
+        if (isOwned(player)) continue;
+        Spacecraft& ship = game.getShip(player);
+        if (!ship.isAlive()) continue;
+        ShieldState shield = ship.shield.getState();
+        shield.currentEnergy = 0;
+        ship.shield.setState(shield);
+    }
+}
+
+const NetState* NetServer::getHistory(uint32_t tick) const {
+    if (tick == 0 || tick > tickCount || tickCount - tick >= static_cast<uint32_t>(NET_SNAPSHOT_HISTORY)) {
+        return nullptr;
+    }
+    const NetState& state = history[tick % NET_SNAPSHOT_HISTORY];
+    return state.tick == tick ? &state : nullptr;
+}
+
+void NetServer::sendSnapshots(uint64_t nowNs) {
+    PROFILE_SCOPE("NetServer::sendSnapshots");
+    tickCount++;
+    if (tickCount % config.snapshotInterval != 0 || clients.empty()) {
+        stats.sendFailures += conditioner.flush(socket, nowNs);
+        return;
+    }
+
+    NetState& state = history[tickCount % NET_SNAPSHOT_HISTORY];
+    captureNetState(game, tickCount, state);
+
+    size_t encodingCount = 0;
+    for (Client& client : clients) {
+        const NetState* baseline = getHistory(client.ackedTick);
+        uint32_t baselineTick = baseline ? client.ackedTick : 0;
+
+        Encoding* encoding = nullptr;
+        for (size_t i = 0; i < encodingCount && !encoding; i++) {
+            if (encodings[i].baselineTick == baselineTick) encoding = &encodings[i];
+        }
+        if (!encoding) {
+            if (encodingCount == encodings.size()) encodings.emplace_back();
+            encoding = &encodings[encodingCount++];
+            encoding->baselineTick = baselineTick;
+            encoding->payload.clear();
+            encodeNetState(state, baseline, encoding->payload);
+        }
+
+        // Cut into MTU-sized parts; the client decodes once it has them all
+        size_t stateBytes = encoding->payload.getSize();
+        size_t parts = (stateBytes + NET_SNAPSHOT_PART_BYTES - 1) / NET_SNAPSHOT_PART_BYTES;
+        if (parts > static_cast<size_t>(NET_MAX_SNAPSHOT_PARTS)) {
+            stats.oversizedSnapshots++;
+            continue;
+        }
+        for (size_t part = 0; part < parts; part++) {
+            writePacketHeader(packet, NetPacketType::SNAPSHOT);
+            packet.writeU32(tickCount);
+            packet.writeU32(baselineTick);
+            packet.writeU32(client.processedSequence);
+            packet.writeU8(static_cast<uint8_t>(client.player));
+            packet.writeU8(static_cast<uint8_t>(part));
+            packet.writeU8(static_cast<uint8_t>(parts));
+            size_t offset = part * NET_SNAPSHOT_PART_BYTES;
+            packet.writeBytes(encoding->payload.getData() + offset, std::min(NET_SNAPSHOT_PART_BYTES, stateBytes - offset));
+            if (!conditioner.send(socket, nowNs, client.address, packet.getData(), packet.getSize())) {
+                stats.sendFailures++;
+            }
+            stats.snapshotPackets++;
+            stats.snapshotBytes += packet.getSize();
+        }
+
+        stats.snapshots++;
+        if (!baseline) stats.fullSnapshots++;
+    }
+    stats.sendFailures += conditioner.flush(socket, nowNs);
+}
+
+void NetServer::tick(uint64_t nowNs, bool readable) {
+    if (readable) {
+        receive(nowNs);
+    } else {
+        stats.sendFailures += conditioner.flush(socket, nowNs);
+        dropSilentClients(nowNs);
+    }
+    if (clients.empty()) return;
+    applyInputs();
+    game.update(NET_TICK_SECONDS, playerZeroInput.aimTarget, playerZeroInput.shooting);
+    sendSnapshots(nowNs);
+}
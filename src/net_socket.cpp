@@ -0,0 +1,147 @@
+#include "../include/net_socket.hpp"
+#include "../include/logger.hpp"
+#include <arpa/inet.h>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+    sockaddr_in toSockaddr(const NetAddress& address) {
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(address.host);
+        addr.sin_port = htons(address.port);
+        return addr;
+    }
+}
+
+bool resolveAddress(const char* text, uint16_t defaultPort, NetAddress& out) {
+    std::string host = text;
+    uint16_t port = defaultPort;
+    size_t colon = host.rfind(':');
+    if (colon != std::string::npos) {
+        int parsed = std::atoi(host.c_str() + colon + 1);
+        if (parsed <= 0 || parsed > 65535) return false;
+        port = static_cast<uint16_t>(parsed);
+        host.resize(colon);
+    }
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* results = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &results) != 0 || !results) return false;
+    const sockaddr_in* addr = reinterpret_cast<const sockaddr_in*>(results->ai_addr);
+    out = NetAddress(ntohl(addr->sin_addr.s_addr), port);
+    freeaddrinfo(results);
+    return true;
+}
+
+UdpSocket::UdpSocket() : fd(-1) {}
+
+UdpSocket::~UdpSocket() {
+    close();
+}
+
+bool UdpSocket::open(uint16_t port) {
+    close();
+    fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        LOG_WARN("Net: failed to create a UDP socket");
+        return false;
+    }
+
+    sockaddr_in addr = toSockaddr(NetAddress(INADDR_ANY, port));
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        LOG_WARN("Net: failed to bind UDP port {}", static_cast<int>(port));
+        close();
+        return false;
+    }
+    // Snapshots for several clients go out back to back: room for a few ticks of them
+    int bufferBytes = 1 << 20;
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &bufferBytes, sizeof(bufferBytes));
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufferBytes, sizeof(bufferBytes));
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    return true;
+}
+
+void UdpSocket::close() {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+}
+
+uint16_t UdpSocket::getPort() const {
+    sockaddr_in addr;
+    socklen_t length = sizeof(addr);
+    if (fd < 0 || ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length) != 0) return 0;
+    return ntohs(addr.sin_port);
+}
+
+bool UdpSocket::send(const NetAddress& to, const void* data, size_t size) {
+    if (fd < 0) return false;
+    sockaddr_in addr = toSockaddr(to);
+    ssize_t sent = ::sendto(fd, data, size, 0, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+    return sent == static_cast<ssize_t>(size);
+}
+
+size_t UdpSocket::receive(NetAddress& from, void* buffer, size_t capacity) {
+    if (fd < 0) return 0;
+    sockaddr_in addr;
+    socklen_t length = sizeof(addr);
+    ssize_t received = ::recvfrom(fd, buffer, capacity, 0, reinterpret_cast<sockaddr*>(&addr), &length);
+    if (received <= 0) return 0;
+    from = NetAddress(ntohl(addr.sin_addr.s_addr), ntohs(addr.sin_port));
+    return static_cast<size_t>(received);
+}
+
+LinkConditioner::LinkConditioner(const LinkConditions& conditions, uint64_t seed)
+    : conditions(conditions), rng(seed), sentPackets(0), droppedPackets(0) {}
+
+bool LinkConditioner::send(UdpSocket& socket, uint64_t nowNs, const NetAddress& to, const void* data, size_t size) {
+    sentPackets++;
+    if (conditions.isPerfect()) return socket.send(to, data, size);
+    if (rng.next() % 10000 < static_cast<uint32_t>(conditions.lossPercent * 100.0f)) {
+        droppedPackets++;
+        return true;
+    }
+
+    float jitter = conditions.jitterMs * ((rng.next() % 20001) / 10000.0f - 1.0f);
+    float delayMs = conditions.latencyMs + jitter;
+    Pending packet;
+    packet.releaseNs = nowNs + static_cast<uint64_t>(delayMs > 0 ? delayMs * 1e6f : 0.0f);
+    packet.to = to;
+    if (!spare.empty()) {
+        packet.data.swap(spare.back());
+        spare.pop_back();
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    packet.data.assign(bytes, bytes + size);
+    pending.push_back(std::move(packet));
+    return true;
+}
+
+int LinkConditioner::flush(UdpSocket& socket, uint64_t nowNs) {
+    // With jitter a later packet can come due first, which reorders them
+    int failed = 0;
+    size_t kept = 0;
+    for (size_t i = 0; i < pending.size(); i++) {
+        Pending& packet = pending[i];
+        if (packet.releaseNs <= nowNs) {
+            if (!socket.send(packet.to, packet.data.data(), packet.data.size())) failed++;
+            spare.push_back(std::move(packet.data));
+            packet.data.clear();
+        } else {
+            if (kept != i) pending[kept] = std::move(packet);
+            kept++;
+        }
+    }
+    pending.resize(kept);
+    return failed;
+}
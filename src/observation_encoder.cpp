@@ -0,0 +1,139 @@
+#include "../include/observation_encoder.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const float SHIP_MAX_SPEED = SPACECRAFT_SPEED * 60.0f;
+    const float ALIEN_MAX_HEALTH = 70.0f;  // Brute
+
+    struct Ranked {
+        float distance;
+        uint32_t index;
+    };
+
+    bool isCloser(float distance, uint32_t index, float otherDistance, uint32_t otherIndex) {
+        return distance < otherDistance || (distance == otherDistance && index < otherIndex);
+    }
+
+    // Keeps the best `capacity` entries sorted, nearest first
+    template <typename T>
+    void insertNearest(T* list, int& found, int capacity, float distance, uint32_t index) {
+        if (found == capacity && !isCloser(distance, index, list[capacity - 1].distance, list[capacity - 1].index)) {
+            return;
+        }
+        int slot = found < capacity ? found++ : capacity - 1;
+        while (slot > 0 && isCloser(distance, index, list[slot - 1].distance, list[slot - 1].index)) {
+            list[slot] = list[slot - 1];
+            slot--;
+        }
+        list[slot].distance = distance;
+        list[slot].index = index;
+    }
+}
+
+int ObservationEncoder::findNearestInGrid(const GameManager& game, Vec2 origin, Neighbor* nearest) const {
+    const AlienGrid& grid = game.alienGrid;
+    int gridWidth = grid.getWidth(), gridHeight = grid.getHeight();
+    int originX = grid.getColumn(origin.x), originY = grid.getRow(origin.y);
+    int maxRing = std::max(std::max(originX, gridWidth - 1 - originX), std::max(originY, gridHeight - 1 - originY));
+
+    // Distance from the origin to the nearest edge of its own cell
+    float cellLeft = originX * ALIEN_GRID_CELL_SIZE - ALIEN_GRID_MARGIN;
+    float cellBottom = originY * ALIEN_GRID_CELL_SIZE - ALIEN_GRID_MARGIN;
+    float edgeDistance = std::max(0.0f, std::min(std::min(origin.x - cellLeft, cellLeft + ALIEN_GRID_CELL_SIZE - origin.x),
+                                                 std::min(origin.y - cellBottom, cellBottom + ALIEN_GRID_CELL_SIZE - origin.y)));
+
+    int found = 0;
+    for (int ring = 0; ring <= maxRing; ring++) {
+        // Everything in this ring or beyond is at least this far away
+        if (found == OBS_NEAREST_ALIENS && ring > 0) {
+            float bound = (ring - 1) * ALIEN_GRID_CELL_SIZE + edgeDistance;
+            if (nearest[found - 1].distance <= bound * bound) break;
+        }
+
+        for (int y = originY - ring; y <= originY + ring; y++) {
+            if (y < 0 || y >= gridHeight) continue;
+            bool fullRow = y == originY - ring || y == originY + ring;
+            int step = fullRow || ring == 0 ? 1 : 2 * ring;
+            for (int x = originX - ring; x <= originX + ring; x += step) {
+                if (x < 0 || x >= gridWidth) continue;
+                int cell = y * gridWidth + x;
+                for (uint32_t slot = grid.getFirst(cell); slot != AlienGrid::NONE; slot = grid.getNext(slot)) {
+                    uint32_t index = static_cast<uint32_t>(game.aliens.indexOf(grid.getHandle(slot)));
+                    const Alien& alien = game.aliens[index];
+                    if (!alien.active) continue;
+                    float dx = alien.position.x - origin.x, dy = alien.position.y - origin.y;
+                    insertNearest(nearest, found, OBS_NEAREST_ALIENS, dx * dx + dy * dy, index);
+                }
+            }
+        }
+    }
+    return found;
+}
+
+int ObservationEncoder::scanNearest(const GameManager& game, Vec2 origin, Neighbor* nearest) const {
+    int found = 0;
+    uint32_t index = 0;
+    for (const Alien& alien : game.aliens) {
+        if (alien.active) {
+            float dx = alien.position.x - origin.x, dy = alien.position.y - origin.y;
+            insertNearest(nearest, found, OBS_NEAREST_ALIENS, dx * dx + dy * dy, index);
+        }
+        index++;
+    }
+    return found;
+}
+
+void ObservationEncoder::encode(const GameManager& game, float* out) const {
+    const Spacecraft& ship = game.spacecraft;
+    out[OBS_SHIP_X] = ship.position.x / WINDOW_WIDTH * 2.0f - 1.0f;
+    out[OBS_SHIP_Y] = ship.position.y / WINDOW_HEIGHT * 2.0f - 1.0f;
+    out[OBS_SHIP_VELOCITY_X] = ship.velocity.x / SHIP_MAX_SPEED;
+    out[OBS_SHIP_VELOCITY_Y] = ship.velocity.y / SHIP_MAX_SPEED;
+    out[OBS_SHIP_AIM_COS] = std::cos(ship.rotation);
+    out[OBS_SHIP_AIM_SIN] = std::sin(ship.rotation);
+    out[OBS_SHIELD] = ship.shield.getPercentage();
+    out[OBS_AMMO] = static_cast<float>(ship.ammo) / ship.maxAmmo;
+    out[OBS_COOLDOWN] = std::max(0.0f, ship.shootCooldown) / SHOOT_COOLDOWN;
+    out[OBS_WAVE] = game.wave / 10.0f;
+
+    Neighbor nearest[OBS_NEAREST_ALIENS];
+    int found;
+    if (game.aliens.size() < static_cast<size_t>(OBS_GRID_MIN_ALIENS)) {
+        found = scanNearest(game, ship.position, nearest);
+    } else {
+        found = findNearestInGrid(game, ship.position, nearest);
+    }
+
+    float* alienOut = out + OBS_ALIENS_OFFSET;
+    std::fill(alienOut, alienOut + OBS_NEAREST_ALIENS * OBS_ALIEN_FEATURES, 0.0f);
+    for (int i = 0; i < found; i++, alienOut += OBS_ALIEN_FEATURES) {
+        const Alien& alien = game.aliens.begin()[nearest[i].index];
+        alienOut[OBS_ALIEN_DX] = (alien.position.x - ship.position.x) / WINDOW_WIDTH;
+        alienOut[OBS_ALIEN_DY] = (alien.position.y - ship.position.y) / WINDOW_HEIGHT;
+        alienOut[OBS_ALIEN_VELOCITY_X] = alien.velocity.x / SHIP_MAX_SPEED;
+        alienOut[OBS_ALIEN_VELOCITY_Y] = alien.velocity.y / SHIP_MAX_SPEED;
+        alienOut[OBS_ALIEN_SCOUT + static_cast<int>(alien.type)] = 1.0f;
+        alienOut[OBS_ALIEN_HEALTH] = alien.health / ALIEN_MAX_HEALTH;
+    }
+
+    // Only a handful of motherships at a time: a scan is cheaper than the grid
+    Ranked motherships[OBS_NEAREST_MOTHERSHIPS];
+    int mothershipCount = 0;
+    for (size_t i = 0; i < game.motherships.size(); i++) {
+        const Mothership& m = game.motherships[i];
+        if (!m.active) continue;
+        Vec2 diff = m.position - ship.position;
+        insertNearest(motherships, mothershipCount, OBS_NEAREST_MOTHERSHIPS, diff.dot(diff), static_cast<uint32_t>(i));
+    }
+
+    float* mothershipOut = out + OBS_MOTHERSHIPS_OFFSET;
+    std::fill(mothershipOut, mothershipOut + OBS_NEAREST_MOTHERSHIPS * OBS_MOTHERSHIP_FEATURES, 0.0f);
+    for (int i = 0; i < mothershipCount; i++, mothershipOut += OBS_MOTHERSHIP_FEATURES) {
+        const Mothership& m = game.motherships[motherships[i].index];
+        mothershipOut[OBS_MOTHERSHIP_DX] = (m.position.x - ship.position.x) / WINDOW_WIDTH;
+        mothershipOut[OBS_MOTHERSHIP_DY] = (m.position.y - ship.position.y) / WINDOW_HEIGHT;
+        mothershipOut[OBS_MOTHERSHIP_TO_SPAWN] = m.aliensToSpawn / 10.0f;
+        mothershipOut[OBS_MOTHERSHIP_PRESENT] = 1.0f;
+    }
+}
@@ -0,0 +1,97 @@
+#include "../include/occupancy_grid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+    const uint8_t ALIEN_VALUES[] = {OCC_SCOUT_VALUE, OCC_HUNTER_VALUE, OCC_BRUTE_VALUE};
+}
+
+OccupancyRasterizer::OccupancyRasterizer(int width, int height)
+    : width(std::max(1, width)), height(std::max(1, height)) {
+    scaleX = static_cast<float>(this->width) / WINDOW_WIDTH;
+    scaleY = static_cast<float>(this->height) / WINDOW_HEIGHT;
+}
+
+void OccupancyRasterizer::stamp(uint8_t* out, Vec2 position, float radius, int channel, uint8_t value) const {
+    // Grid space: y grows downwards from the top row
+    float cx = position.x * scaleX;
+    float cy = (WINDOW_HEIGHT - position.y) * scaleY;
+    float rx = std::max(radius * scaleX, OCC_MIN_RADIUS);
+    float ry = std::max(radius * scaleY, OCC_MIN_RADIUS);
+
+    // Only pixels in this box can have their centres inside. Truncating
+    // instead of flooring can only add a column or row at the edge, which the
+    // ellipse test then rejects.
+    int x0 = std::max(0, static_cast<int>(cx - rx));
+    int x1 = std::min(width - 1, static_cast<int>(cx + rx));
+    int y0 = std::max(0, static_cast<int>(cy - ry));
+    int y1 = std::min(height - 1, static_cast<int>(cy + ry));
+    if (x0 > x1 || y0 > y1) return;
+
+    float inverseRx = 1.0f / rx, inverseRy = 1.0f / ry;
+    size_t rowBytes = static_cast<size_t>(width) * OCC_CHANNELS;
+#if defined(__SSE2__)
+    if (width >= 4) {
+        const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128i bits = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(value) << (8 * channel)));
+        // Groups of four pixels outermost, so the horizontal term is worked out
+        // once per group; rows are tested without branching, lanes outside the
+        // ellipse leave their pixel alone
+        for (int x = std::min(x0, width - 4); x <= x1; x += 4) {
+            // The last group slides back inside the row; max makes the overlap harmless
+            if (x + 4 > width) x = width - 4;
+            __m128 dx = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets),
+                                              _mm_set1_ps(cx)), _mm_set1_ps(inverseRx));
+            __m128 columnTerms = _mm_mul_ps(dx, dx);
+            uint8_t* group = out + y0 * rowBytes + x * OCC_CHANNELS;
+            for (int y = y0; y <= y1; y++, group += rowBytes) {
+                float dy = (y + 0.5f - cy) * inverseRy;
+                __m128 inside = _mm_cmple_ps(_mm_add_ps(columnTerms, _mm_set1_ps(dy * dy)), one);
+                __m128i* pixels = reinterpret_cast<__m128i*>(group);
+                __m128i stamped = _mm_and_si128(_mm_castps_si128(inside), bits);
+                _mm_storeu_si128(pixels, _mm_max_epu8(_mm_loadu_si128(pixels), stamped));
+            }
+        }
+        return;
+    }
+#endif
+
+    for (int y = y0; y <= y1; y++) {
+        float dy = (y + 0.5f - cy) * inverseRy;
+        float rowTerm = dy * dy;
+        if (rowTerm > 1.0f) continue;
+        uint8_t* row = out + y * rowBytes;
+        for (int x = x0; x <= x1; x++) {
+            float dx = (x + 0.5f - cx) * inverseRx;
+            if (dx * dx + rowTerm > 1.0f) continue;
+            uint8_t& pixel = row[x * OCC_CHANNELS + channel];
+            pixel = std::max(pixel, value);
+        }
+    }
+}
+
+void OccupancyRasterizer::rasterize(const GameManager& game, uint8_t* out) const {
+    std::memset(out, 0, getByteCount());
+
+    stamp(out, game.spacecraft.position, SPACECRAFT_RADIUS, OCC_SHIP, OCC_SOLID_VALUE);
+    for (const Spacecraft& wingman : game.wingmen) {
+        if (wingman.isAlive()) stamp(out, wingman.position, SPACECRAFT_RADIUS, OCC_SHIP, OCC_SOLID_VALUE);
+    }
+    for (const Alien& alien : game.aliens) {
+        if (alien.active) {
+            stamp(out, alien.position, alien.getSize(), OCC_ALIENS, ALIEN_VALUES[static_cast<int>(alien.type)]);
+        }
+    }
+    for (const Plasma& plasma : game.plasmas) {
+        if (plasma.active) stamp(out, plasma.position, PLASMA_RADIUS, OCC_PLASMA, OCC_SOLID_VALUE);
+    }
+    for (const Mothership& m : game.motherships) {
+        if (m.active) stamp(out, m.position, m.size, OCC_MOTHERSHIPS, OCC_SOLID_VALUE);
+    }
+}
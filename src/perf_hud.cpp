@@ -0,0 +1,52 @@
+#include "../include/perf_hud.hpp"
+#include "../include/logger.hpp"
+#include <algorithm>
+
+PerfHud::PerfHud() : history(), head(0), summaryTimer(0), enabled(false) {}
+
+void PerfHud::toggle() {
+    enabled = !enabled;
+    for (auto& sample : history) sample = PerfFrameSample{0, 0, 0, 0};
+    head = 0;
+    summaryTimer = 0;
+}
+
+void PerfHud::recordFrame(float simMs, float renderMs, float gpuMs, float inputMs,
+                          const RenderStats& renderStats, float deltaTime) {
+    if (!enabled) return;
+
+    history[head] = PerfFrameSample{simMs, renderMs, gpuMs, inputMs};
+    head = (head + 1) % PERF_HUD_HISTORY;
+    lastRenderStats = renderStats;
+
+    // The overlay has no text, so print the exact numbers once a second
+    summaryTimer += deltaTime;
+    if (summaryTimer >= 1.0f) {
+        summaryTimer = 0;
+        float sim = 0, render = 0, gpu = 0, input = 0, inputMax = 0;
+        int inputFrames = 0;
+        for (const auto& sample : history) {
+            sim += sample.simMs;
+            render += sample.renderMs;
+            gpu += sample.gpuMs;
+            if (sample.inputMs > 0) {
+                input += sample.inputMs;
+                inputMax = std::max(inputMax, sample.inputMs);
+                inputFrames++;
+            }
+        }
+        LOG_INFO("Perf: sim {} ms, render {} ms, gpu {} ms, {} draws, {} KB uploaded",
+                 sim / PERF_HUD_HISTORY, render / PERF_HUD_HISTORY, gpu / PERF_HUD_HISTORY,
+                 renderStats.drawCalls, renderStats.bytesUploaded / 1024);
+        if (inputFrames > 0) {
+            LOG_INFO("Perf: input to present {} ms avg, {} ms max over {} frames with input",
+                     input / inputFrames, inputMax, inputFrames);
+        }
+    }
+}
+
+const PerfFrameSample& PerfHud::getSample(int age) const {
+    int index = (head - 1 - age) % PERF_HUD_HISTORY;
+    if (index < 0) index += PERF_HUD_HISTORY;
+    return history[index];
+}
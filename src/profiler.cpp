@@ -0,0 +1,132 @@
+#include "../include/profiler.hpp"
+
+#if XS_PROFILER_ENABLED
+
+#include "../include/logger.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace {
+    struct ProfileEvent {
+        const char* name;
+        uint64_t startNs;
+        uint64_t endNs;
+    };
+
+    // One ring per thread so recording never contends; only registration
+    // takes the lock. Rings are kept for the life of the process.
+    struct ThreadBuffer {
+        ProfileEvent events[PROFILER_RING_SIZE];
+        std::atomic<uint64_t> head{0};
+        int threadId = 0;
+    };
+
+    std::mutex registryMutex;
+    std::vector<ThreadBuffer*> threadBuffers;
+
+    std::atomic<bool> capturing(false);
+    std::atomic<int> requestedFrames(0);
+    int framesRemaining = 0;
+    int captureCount = 0;
+    uint64_t frameStartNs = 0;
+
+    ThreadBuffer& getThreadBuffer() {
+        thread_local ThreadBuffer* buffer = nullptr;
+        if (!buffer) {
+            buffer = new ThreadBuffer();
+            std::lock_guard<std::mutex> lock(registryMutex);
+            buffer->threadId = static_cast<int>(threadBuffers.size()) + 1;
+            threadBuffers.push_back(buffer);
+        }
+        return *buffer;
+    }
+
+    void startCapture(int frames) {
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            for (ThreadBuffer* buffer : threadBuffers) buffer->head.store(0, std::memory_order_relaxed);
+        }
+        framesRemaining = frames;
+        capturing.store(true, std::memory_order_release);
+    }
+
+    void finishCapture() {
+        capturing.store(false, std::memory_order_release);
+
+        char path[64];
+        std::snprintf(path, sizeof(path), "xenostrike_trace_%d.json", ++captureCount);
+        if (Profiler::writeChromeTrace(path)) {
+            LOG_INFO("Profiler: trace written to xenostrike_trace_{}.json", captureCount);
+        } else {
+            LOG_WARN("Profiler: failed to write trace file");
+        }
+    }
+}
+
+namespace Profiler {
+    uint64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool isCapturing() {
+        return capturing.load(std::memory_order_relaxed);
+    }
+
+    void record(const char* name, uint64_t startNs, uint64_t endNs) {
+        ThreadBuffer& buffer = getThreadBuffer();
+        uint64_t index = buffer.head.load(std::memory_order_relaxed);
+        buffer.events[index & (PROFILER_RING_SIZE - 1)] = ProfileEvent{name, startNs, endNs};
+        buffer.head.store(index + 1, std::memory_order_release);
+    }
+
+    void requestCapture(int frames) {
+        requestedFrames.store(frames, std::memory_order_relaxed);
+    }
+
+    void beginFrame() {
+        uint64_t now = nowNs();
+
+        if (isCapturing()) {
+            record("Frame", frameStartNs, now);
+            if (--framesRemaining <= 0) finishCapture();
+        }
+
+        int frames = requestedFrames.exchange(0, std::memory_order_relaxed);
+        if (!isCapturing() && frames > 0) {
+            LOG_INFO("Profiler: capturing {} frames", frames);
+            startCapture(frames);
+        }
+
+        frameStartNs = now;
+    }
+
+    bool writeChromeTrace(const char* path) {
+        std::FILE* file = std::fopen(path, "w");
+        if (!file) return false;
+
+        std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        bool first = true;
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (ThreadBuffer* buffer : threadBuffers) {
+            uint64_t head = buffer->head.load(std::memory_order_acquire);
+            uint64_t begin = head > PROFILER_RING_SIZE ? head - PROFILER_RING_SIZE : 0;
+            for (uint64_t i = begin; i < head; i++) {
+                const ProfileEvent& e = buffer->events[i & (PROFILER_RING_SIZE - 1)];
+                std::fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                             first ? "" : ",\n", e.name, buffer->threadId,
+                             e.startNs / 1000.0, (e.endNs - e.startNs) / 1000.0);
+                first = false;
+            }
+        }
+
+        std::fprintf(file, "\n]}\n");
+        return std::fclose(file) == 0;
+    }
+}
+
+#endif
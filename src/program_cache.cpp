@@ -0,0 +1,185 @@
+#include "../include/program_cache.hpp"
+#include "../include/logger.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
+#include <vector>
+
+namespace {
+    const uint32_t CACHE_MAGIC = 0x42505358;  // "XSPB"
+    const uint32_t CACHE_VERSION = 1;
+
+    struct CacheHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;
+        uint32_t format;  // Driver-defined binary format
+        uint32_t length;
+    };
+
+    const uint64_t FNV_OFFSET = 14695981039346656037ull;
+    const uint64_t FNV_PRIME = 1099511628211ull;
+
+    void hashString(uint64_t& hash, const char* text) {
+        // Includes the terminator so "ab"+"c" and "a"+"bc" differ
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(text);
+        do {
+            hash ^= *p;
+            hash *= FNV_PRIME;
+        } while (*p++);
+    }
+
+    const char* glString(GLenum name) {
+        const GLubyte* value = glGetString(name);
+        return value ? reinterpret_cast<const char*>(value) : "";
+    }
+
+    // mkdir -p
+    bool makeDirectories(const std::string& path) {
+        for (size_t i = 1; i <= path.size(); i++) {
+            if (i < path.size() && path[i] != '/') continue;
+            std::string prefix = path.substr(0, i);
+            struct stat info;
+            if (stat(prefix.c_str(), &info) == 0) {
+                if (!S_ISDIR(info.st_mode)) return false;
+            } else if (mkdir(prefix.c_str(), 0755) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string defaultCacheDirectory() {
+        if (const char* dir = std::getenv("XS_SHADER_CACHE_DIR")) return dir;
+        if (const char* xdg = std::getenv("XDG_CACHE_HOME")) return std::string(xdg) + "/xenostrike";
+        if (const char* home = std::getenv("HOME")) return std::string(home) + "/.cache/xenostrike";
+        return "";
+    }
+
+    float elapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+ProgramCache::ProgramCache() : supported(false), hits(0), misses(0) {}
+
+bool ProgramCache::initialize() {
+    supported = false;
+    if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary) {
+        LOG_INFO("Shader cache: program binaries unsupported, compiling every launch");
+        return false;
+    }
+
+    // Some drivers expose the entry points but no binary formats
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    if (formatCount <= 0) {
+        LOG_INFO("Shader cache: driver offers no program binary formats, compiling every launch");
+        return false;
+    }
+
+    directory = defaultCacheDirectory();
+    if (directory.empty() || !makeDirectories(directory)) {
+        LOG_WARN("Shader cache: can't create the cache directory, compiling every launch");
+        return false;
+    }
+
+    driverKey = std::string(glString(GL_VENDOR)) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+    supported = true;
+    return true;
+}
+
+uint64_t ProgramCache::computeKey(const char* vertexSource, const char* fragmentSource) const {
+    uint64_t hash = FNV_OFFSET;
+    hashString(hash, driverKey.c_str());
+    hashString(hash, vertexSource);
+    hashString(hash, fragmentSource);
+    return hash;
+}
+
+std::string ProgramCache::entryPath(const char* name, uint64_t key) const {
+    char file[96];
+    std::snprintf(file, sizeof(file), "/%s_%016llx.bin", name, static_cast<unsigned long long>(key));
+    return directory + file;
+}
+
+GLuint ProgramCache::loadBinary(const std::string& path, uint64_t key) const {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return 0;
+
+    CacheHeader header;
+    std::vector<char> binary;
+    bool valid = std::fread(&header, sizeof(header), 1, file) == 1 && header.magic == CACHE_MAGIC &&
+                 header.version == CACHE_VERSION && header.key == key && header.length > 0;
+    if (valid) {
+        binary.resize(header.length);
+        valid = std::fread(binary.data(), 1, binary.size(), file) == binary.size();
+    }
+    std::fclose(file);
+    if (!valid) return 0;
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE) {
+        // The driver may reject its own binaries (e.g. after an update with the same version string)
+        glDeleteProgram(program);
+        std::remove(path.c_str());
+        return 0;
+    }
+    return program;
+}
+
+void ProgramCache::storeBinary(GLuint program, const std::string& path, uint64_t key) const {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+    CacheHeader header;
+    header.magic = CACHE_MAGIC;
+    header.version = CACHE_VERSION;
+    header.key = key;
+    header.format = format;
+    header.length = static_cast<uint32_t>(length);
+
+    // Written beside the entry and renamed, so a concurrent launch never reads half a file
+    std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) return;
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   std::fwrite(binary.data(), 1, binary.size(), file) == binary.size();
+    written = std::fclose(file) == 0 && written;
+    if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        LOG_WARN("Shader cache: failed to write a program binary");
+    }
+}
+
+GLuint ProgramCache::findProgram(const char* name, const char* vertexSource, const char* fragmentSource) {
+    if (!supported) return 0;
+    auto start = std::chrono::steady_clock::now();
+
+    uint64_t key = computeKey(vertexSource, fragmentSource);
+    GLuint program = loadBinary(entryPath(name, key), key);
+    if (!program) {
+        misses++;
+        return 0;
+    }
+    hits++;
+    LOG_INFO("Shader cache: {} loaded from binary in {} ms", name, elapsedMs(start));
+    return program;
+}
+
+void ProgramCache::storeProgram(const char* name, const char* vertexSource, const char* fragmentSource,
+                                GLuint program) {
+    if (!supported) return;
+    uint64_t key = computeKey(vertexSource, fragmentSource);
+    storeBinary(program, entryPath(name, key), key);
+}
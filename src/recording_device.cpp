@@ -0,0 +1,204 @@
+#include "../include/recording_device.hpp"
+#include <cstring>
+
+namespace {
+    const char* getPrimitiveName(PrimitiveType primitive) {
+        switch (primitive) {
+        case PrimitiveType::LINES: return "lines";
+        case PrimitiveType::TRIANGLES: return "triangles";
+        case PrimitiveType::TRIANGLE_FAN: return "triangle_fan";
+        }
+        return "?";
+    }
+
+    const uint64_t FNV_OFFSET = 14695981039346656037ull;
+    const uint64_t FNV_PRIME = 1099511628211ull;
+
+    void hashBytes(uint64_t& hash, const void* bytes, size_t size) {
+        const unsigned char* p = static_cast<const unsigned char*>(bytes);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= p[i];
+            hash *= FNV_PRIME;
+        }
+    }
+
+    template <typename T>
+    void hashValue(uint64_t& hash, const T& value) {
+        hashBytes(hash, &value, sizeof(value));
+    }
+}
+
+const char* getDeviceCommandName(DeviceCommandType type) {
+    switch (type) {
+    case DeviceCommandType::BEGIN_FRAME: return "begin_frame";
+    case DeviceCommandType::BEGIN_PASS: return "begin_pass";
+    case DeviceCommandType::UPLOAD: return "upload";
+    case DeviceCommandType::SET_COLOR: return "set_color";
+    case DeviceCommandType::SET_TRANSFORM: return "set_transform";
+    case DeviceCommandType::DRAW: return "draw";
+    case DeviceCommandType::END_FRAME: return "end_frame";
+    }
+    return "?";
+}
+
+RecordingDevice::RecordingDevice()
+    : currentPass(RenderPass::COUNT), currentTransform(), colorBound(false),
+      transformBound(false), lastUploadFloats(0) {}
+
+void RecordingDevice::push(DeviceCommandType type) {
+    DeviceCommand command;
+    command.type = type;
+    command.primitive = PrimitiveType::TRIANGLES;
+    command.pass = currentPass;
+    command.offset = 0;
+    command.count = 0;
+    commands.push_back(command);
+}
+
+void RecordingDevice::beginFrame(Color clearColor) {
+    commands.clear();
+    data.clear();
+    stats = RecordingStats();
+    currentPass = RenderPass::COUNT;
+    colorBound = false;
+    transformBound = false;
+
+    push(DeviceCommandType::BEGIN_FRAME);
+    commands.back().color = clearColor;
+}
+
+void RecordingDevice::endFrame() {
+    push(DeviceCommandType::END_FRAME);
+}
+
+void RecordingDevice::beginPass(RenderPass pass) {
+    currentPass = pass;
+    push(DeviceCommandType::BEGIN_PASS);
+}
+
+void RecordingDevice::uploadVertices(const float* vertexData, size_t floatCount) {
+    push(DeviceCommandType::UPLOAD);
+    commands.back().offset = static_cast<uint32_t>(data.size());
+    commands.back().count = static_cast<uint32_t>(floatCount);
+    data.insert(data.end(), vertexData, vertexData + floatCount);
+
+    size_t bytes = floatCount * sizeof(float);
+    stats.uploads++;
+    stats.bytesUploaded += bytes;
+    if (currentPass != RenderPass::COUNT) stats.passBytesUploaded[static_cast<int>(currentPass)] += bytes;
+}
+
+void RecordingDevice::setColor(Color color) {
+    push(DeviceCommandType::SET_COLOR);
+    commands.back().color = color;
+
+    bool same = colorBound && color.r == currentColor.r && color.g == currentColor.g &&
+                color.b == currentColor.b && color.a == currentColor.a;
+    if (same) {
+        stats.redundantStateSets++;
+    } else {
+        stats.stateChanges++;
+        currentColor = color;
+        colorBound = true;
+    }
+}
+
+void RecordingDevice::setTransform(const float* matrix) {
+    push(DeviceCommandType::SET_TRANSFORM);
+    commands.back().offset = static_cast<uint32_t>(data.size());
+    commands.back().count = 16;
+    data.insert(data.end(), matrix, matrix + 16);
+
+    if (transformBound && std::memcmp(matrix, currentTransform, sizeof(currentTransform)) == 0) {
+        stats.redundantStateSets++;
+    } else {
+        stats.stateChanges++;
+        std::memcpy(currentTransform, matrix, sizeof(currentTransform));
+        transformBound = true;
+    }
+}
+
+void RecordingDevice::draw(PrimitiveType primitive, int firstVertex, int vertexCount) {
+    push(DeviceCommandType::DRAW);
+    commands.back().primitive = primitive;
+    commands.back().offset = static_cast<uint32_t>(firstVertex);
+    commands.back().count = static_cast<uint32_t>(vertexCount);
+
+    stats.drawCalls++;
+    stats.verticesDrawn += vertexCount;
+    if (currentPass != RenderPass::COUNT) stats.passDrawCalls[static_cast<int>(currentPass)]++;
+}
+
+uint64_t RecordingDevice::getFrameHash() const {
+    uint64_t hash = FNV_OFFSET;
+    for (const DeviceCommand& command : commands) {
+        // Field by field: the struct has padding
+        hashValue(hash, command.type);
+        switch (command.type) {
+        case DeviceCommandType::BEGIN_FRAME:
+        case DeviceCommandType::SET_COLOR:
+            hashValue(hash, command.color.r);
+            hashValue(hash, command.color.g);
+            hashValue(hash, command.color.b);
+            hashValue(hash, command.color.a);
+            break;
+        case DeviceCommandType::BEGIN_PASS:
+            hashValue(hash, command.pass);
+            break;
+        case DeviceCommandType::UPLOAD:
+        case DeviceCommandType::SET_TRANSFORM:
+            hashBytes(hash, data.data() + command.offset, command.count * sizeof(float));
+            break;
+        case DeviceCommandType::DRAW:
+            hashValue(hash, command.primitive);
+            hashValue(hash, command.offset);
+            hashValue(hash, command.count);
+            break;
+        case DeviceCommandType::END_FRAME:
+            break;
+        }
+    }
+    return hash;
+}
+
+void RecordingDevice::writeLog(std::FILE* out) const {
+    for (const DeviceCommand& command : commands) {
+        std::fprintf(out, "{\"cmd\": \"%s\"", getDeviceCommandName(command.type));
+        if (command.pass != RenderPass::COUNT) {
+            std::fprintf(out, ", \"pass\": \"%s\"", getRenderPassName(command.pass));
+        }
+        switch (command.type) {
+        case DeviceCommandType::BEGIN_FRAME:
+        case DeviceCommandType::SET_COLOR:
+            std::fprintf(out, ", \"rgba\": [%g, %g, %g, %g]", command.color.r, command.color.g,
+                         command.color.b, command.color.a);
+            break;
+        case DeviceCommandType::UPLOAD:
+            std::fprintf(out, ", \"floats\": %u, \"bytes\": %zu", command.count, command.count * sizeof(float));
+            break;
+        case DeviceCommandType::DRAW:
+            std::fprintf(out, ", \"primitive\": \"%s\", \"first\": %u, \"count\": %u",
+                         getPrimitiveName(command.primitive), command.offset, command.count);
+            break;
+        default:
+            break;
+        }
+        std::fprintf(out, "}\n");
+    }
+}
+
+void RecordingDevice::replay(GraphicsDevice& target) const {
+    for (const DeviceCommand& command : commands) {
+        switch (command.type) {
+        case DeviceCommandType::BEGIN_FRAME: target.beginFrame(command.color); break;
+        case DeviceCommandType::BEGIN_PASS: target.beginPass(command.pass); break;
+        case DeviceCommandType::UPLOAD: target.uploadVertices(data.data() + command.offset, command.count); break;
+        case DeviceCommandType::SET_COLOR: target.setColor(command.color); break;
+        case DeviceCommandType::SET_TRANSFORM: target.setTransform(data.data() + command.offset); break;
+        case DeviceCommandType::DRAW:
+            target.draw(command.primitive, static_cast<int>(command.offset), static_cast<int>(command.count));
+            break;
+        case DeviceCommandType::END_FRAME: target.endFrame(); break;
+        }
+    }
+}
@@ -1,37 +1,54 @@
 #include "../include/renderer.hpp"
-#include "../shader.hpp"
 #include "../include/mothership.hpp"
+#include "../include/profiler.hpp"
 #include <cstdlib>
 #include <cmath>
-#include <GLFW/glfw3.h>
+#include <algorithm>
+
+namespace {
+    const float IDENTITY_TRANSFORM[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+
+    // Unit circle outline, same values drawCircle used to compute per vertex
+    struct CircleTable {
+        double cosines[CIRCLE_SEGMENTS + 1];
+        double sines[CIRCLE_SEGMENTS + 1];
+
+        CircleTable() {
+            for (int i = 0; i <= CIRCLE_SEGMENTS; i++) {
+                float angle = 2.0f * PI * i / CIRCLE_SEGMENTS;
+                cosines[i] = cos(angle);
+                sines[i] = sin(angle);
+            }
+        }
+    };
 
-Renderer::Renderer() : shaderProgram(0), VAO(0), VBO(0) {}
+    const CircleTable circleTable;
+}
+
+Renderer::Renderer(GraphicsDevice& device)
+    : device(device) {
+    // Largest batch is the perf graph (6 vertices per bar); reserving up
+    // front means the per-draw vertices.clear()/push_back never reallocates
+    vertices.reserve(std::max(CIRCLE_SEGMENTS + 1, PERF_HUD_HISTORY * 6) * 3);
+}
 
 bool Renderer::initialize() {
-    shaderProgram = LoadShaders("SimpleVertexShader.vertexshader",
-                                "SimpleFragmentShader.fragmentshader");
-    if (shaderProgram == 0) return false;
-
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    return true;
+    return device.initialize();
 }
 
 void Renderer::beginFrame() {
-    glClearColor(0.01f, 0.01f, 0.08f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
-    glUseProgram(shaderProgram);
+    frameStats = RenderStats();
+    device.beginFrame(Color(0.01f, 0.01f, 0.08f, 1.0f));
+    // Everything is drawn in NDC, so the transform is set once per frame
+    device.setTransform(IDENTITY_TRANSFORM);
+}
+
+void Renderer::endFrame() {
+    device.endFrame();
 }
 
 void Renderer::drawStarfield() {
+    PROFILE_SCOPE("Renderer::drawStarfield");
     srand(12345);
     for (int i = 0; i < 100; i++) {
         float x = (rand() % WINDOW_WIDTH);
@@ -41,6 +58,33 @@ void Renderer::drawStarfield() {
     }
 }
 
+// Uploads the scratch vertices and draws them as one call in a flat color
+void Renderer::submitVertices(PrimitiveType primitive, Color color) {
+    device.uploadVertices(vertices.data(), vertices.size());
+    device.setColor(color);
+    device.draw(primitive, 0, static_cast<int>(vertices.size() / 3));
+
+    frameStats.drawCalls++;
+    frameStats.bytesUploaded += vertices.size() * sizeof(float);
+}
+
+// Batches vertical bars (bottom at origin.y + bases[i]) into a single draw
+void Renderer::drawBars(Vec2 origin, const float* bases, const float* heights, int count,
+                        float barWidth, Color color) {
+    vertices.clear();
+    for (int i = 0; i < count; i++) {
+        if (heights[i] <= 0) continue;
+        float x1 = ((origin.x + i * barWidth) / WINDOW_WIDTH) * 2.0f - 1.0f;
+        float x2 = ((origin.x + (i + 1) * barWidth - 1.0f) / WINDOW_WIDTH) * 2.0f - 1.0f;
+        float y1 = ((origin.y + bases[i]) / WINDOW_HEIGHT) * 2.0f - 1.0f;
+        float y2 = ((origin.y + bases[i] + heights[i]) / WINDOW_HEIGHT) * 2.0f - 1.0f;
+        float quad[18] = { x1, y1, 0, x2, y1, 0, x2, y2, 0,
+                           x1, y1, 0, x2, y2, 0, x1, y2, 0 };
+        vertices.insert(vertices.end(), quad, quad + 18);
+    }
+    if (!vertices.empty()) submitVertices(PrimitiveType::TRIANGLES, color);
+}
+
 void Renderer::drawLine(Vec2 start, Vec2 end, Color color) {
     vertices.clear();
     float x1 = (start.x / WINDOW_WIDTH) * 2.0f - 1.0f;
@@ -51,26 +95,14 @@ void Renderer::drawLine(Vec2 start, Vec2 end, Color color) {
     vertices.push_back(x1); vertices.push_back(y1); vertices.push_back(0.0f);
     vertices.push_back(x2); vertices.push_back(y2); vertices.push_back(0.0f);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
-                 vertices.data(), GL_DYNAMIC_DRAW);
-
-    GLint colorLoc = glGetUniformLocation(shaderProgram, "color");
-    glUniform4f(colorLoc, color.r, color.g, color.b, color.a);
-    GLint transformLoc = glGetUniformLocation(shaderProgram, "transform");
-    glm::mat4 transform = glm::mat4(1.0f);
-    glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_LINES, 0, 2);
-    glBindVertexArray(0);
+    submitVertices(PrimitiveType::LINES, color);
 }
 
 void Renderer::drawCircle(Vec2 center, float radius, Color color) {
     vertices.clear();
     for (int i = 0; i <= CIRCLE_SEGMENTS; i++) {
-        float angle = 2.0f * PI * i / CIRCLE_SEGMENTS;
-        float x = center.x + radius * cos(angle);
-        float y = center.y + radius * sin(angle);
+        float x = center.x + radius * circleTable.cosines[i];
+        float y = center.y + radius * circleTable.sines[i];
         float ndcX = (x / WINDOW_WIDTH) * 2.0f - 1.0f;
         float ndcY = (y / WINDOW_HEIGHT) * 2.0f - 1.0f;
         vertices.push_back(ndcX);
@@ -78,18 +110,7 @@ void Renderer::drawCircle(Vec2 center, float radius, Color color) {
         vertices.push_back(0.0f);
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
-                 vertices.data(), GL_DYNAMIC_DRAW);
-
-    GLint colorLoc = glGetUniformLocation(shaderProgram, "color");
-    glUniform4f(colorLoc, color.r, color.g, color.b, color.a);
-    GLint transformLoc = glGetUniformLocation(shaderProgram, "transform");
-    glm::mat4 transform = glm::mat4(1.0f);
-    glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, CIRCLE_SEGMENTS + 1);
-    glBindVertexArray(0);
+    submitVertices(PrimitiveType::TRIANGLE_FAN, color);
 }
 
 void Renderer::drawRectangle(Vec2 center, Vec2 size, float rotation, Color color) {
@@ -113,18 +134,7 @@ void Renderer::drawRectangle(Vec2 center, Vec2 size, float rotation, Color color
         vertices.push_back(0.0f);
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
-                 vertices.data(), GL_DYNAMIC_DRAW);
-
-    GLint colorLoc = glGetUniformLocation(shaderProgram, "color");
-    glUniform4f(colorLoc, color.r, color.g, color.b, color.a);
-    GLint transformLoc = glGetUniformLocation(shaderProgram, "transform");
-    glm::mat4 transform = glm::mat4(1.0f);
-    glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-    glBindVertexArray(0);
+    submitVertices(PrimitiveType::TRIANGLE_FAN, color);
 }
 
 void Renderer::drawTriangle(Vec2 p1, Vec2 p2, Vec2 p3, Color color) {
@@ -140,21 +150,10 @@ void Renderer::drawTriangle(Vec2 p1, Vec2 p2, Vec2 p3, Color color) {
     vertices.push_back(x2); vertices.push_back(y2); vertices.push_back(0.0f);
     vertices.push_back(x3); vertices.push_back(y3); vertices.push_back(0.0f);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
-                 vertices.data(), GL_DYNAMIC_DRAW);
-
-    GLint colorLoc = glGetUniformLocation(shaderProgram, "color");
-    glUniform4f(colorLoc, color.r, color.g, color.b, color.a);
-    GLint transformLoc = glGetUniformLocation(shaderProgram, "transform");
-    glm::mat4 transform = glm::mat4(1.0f);
-    glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, 3);
-    glBindVertexArray(0);
+    submitVertices(PrimitiveType::TRIANGLES, color);
 }
 
-void Renderer::drawGameOverScreen(GameState state, int wave, int score) {
+void Renderer::drawGameOverScreen(GameState state, int wave, int score, float pulseTime) {
     // Dark overlay
     drawRectangle(Vec2(WINDOW_WIDTH/2, WINDOW_HEIGHT/2),
                  Vec2(WINDOW_WIDTH, WINDOW_HEIGHT), 0, Color(0, 0, 0, 0.85f));
@@ -192,7 +191,6 @@ void Renderer::drawGameOverScreen(GameState state, int wave, int score) {
 
     // SPACE to restart hint - simple and clear
     Vec2 hintPos = center + Vec2(0, -200);
-    float pulseTime = glfwGetTime();
     float pulse = 0.6f + 0.4f * std::sin(pulseTime * 3.0f);
     drawRectangle(hintPos, Vec2(200, 50), 0, Color(0.3f, 1.0f, 0.3f, 0.3f * pulse));
     drawRectangle(hintPos, Vec2(180, 35), 0, Color(0.2f, 0.8f, 0.2f, 0.5f));
@@ -321,7 +319,7 @@ void Renderer::drawAlien(const Alien& alien) {
     float size = alien.getSize();
 
     // Tentacles (keep them for some alien feel)
-    for (const auto& tentacle : alien.tentacles) {
+    for (const auto& tentacle : alien.getTentacles()) {
         Vec2 prevPos = alien.position;
         for (int i = 0; i < tentacle.getSegmentCount(); i++) {
             Vec2 offset = tentacle.getSegmentPosition(i, alien.animationTime);
@@ -500,8 +498,9 @@ void Renderer::drawAmmoCounter(const Spacecraft& ship) {
 }
 
 void Renderer::drawUI(const GameManager& game) {
+    PROFILE_SCOPE("Renderer::drawUI");
     if (game.gameState == GameState::GAME_OVER_SHIELD || game.gameState == GameState::GAME_OVER_AMMO) {
-        drawGameOverScreen(game.gameState, game.wave, game.score);
+        drawGameOverScreen(game.gameState, game.wave, game.score, game.stateTimer);
         return;
     }
 
@@ -528,8 +527,108 @@ void Renderer::drawUI(const GameManager& game) {
     }
 }
 
+void Renderer::drawGame(const GameManager& game) {
+    beginPass(RenderPass::STARFIELD);
+    drawStarfield();
+
+    {
+        PROFILE_SCOPE("Renderer::drawParticles");
+        beginPass(RenderPass::PARTICLES);
+        for (const auto& particle : game.particles) {
+            drawParticle(particle);
+        }
+    }
+
+    {
+        PROFILE_SCOPE("Renderer::drawAliens");
+        beginPass(RenderPass::ALIENS);
+        for (const auto& alien : game.aliens) {
+            drawAlien(alien);
+        }
+    }
+
+    {
+        PROFILE_SCOPE("Renderer::drawMotherships");
+        beginPass(RenderPass::MOTHERSHIPS);
+        for (const auto& mothership : game.motherships) {
+            drawMothership(mothership);
+        }
+    }
+
+    {
+        PROFILE_SCOPE("Renderer::drawPlasmas");
+        beginPass(RenderPass::PLASMAS);
+        for (const auto& plasma : game.plasmas) {
+            drawPlasma(plasma);
+        }
+    }
+
+    if (game.gameState == GameState::PLAYING) {
+        PROFILE_SCOPE("Renderer::drawSpacecraft");
+        beginPass(RenderPass::SPACECRAFT);
+        for (int player = 0; player < game.getShipCount(); player++) {
+            if (game.getShip(player).isAlive()) drawSpacecraft(game.getShip(player));
+        }
+    }
+
+    beginPass(RenderPass::UI);
+    drawUI(game);
+}
+
+void Renderer::drawPerfOverlay(const PerfHud& hud, const GameManager& game) {
+    if (!hud.enabled) return;
+
+    // Panel in the bottom-left corner
+    Vec2 panelPos(220, 100);
+    drawRectangle(panelPos, Vec2(420, 180), 0, Color(0.0f, 0.0f, 0.0f, 0.6f));
+
+    // Rolling frame-time graphs, oldest frame on the left. Top: CPU time with
+    // render stacked on sim, and input-to-present latency as white ticks on
+    // the same scale. Bottom: GPU time. 80 px = one 60 Hz frame budget.
+    const float pxPerMs = 80.0f / PERF_HUD_FRAME_BUDGET_MS;
+    const float barWidth = 3.0f;
+    float zeros[PERF_HUD_HISTORY] = {};
+    float sim[PERF_HUD_HISTORY], render[PERF_HUD_HISTORY], gpu[PERF_HUD_HISTORY];
+    float latency[PERF_HUD_HISTORY], latencyTicks[PERF_HUD_HISTORY];
+    for (int i = 0; i < PERF_HUD_HISTORY; i++) {
+        const PerfFrameSample& sample = hud.getSample(PERF_HUD_HISTORY - 1 - i);
+        sim[i] = std::min(sample.simMs * pxPerMs, 90.0f);
+        render[i] = std::min(sample.renderMs * pxPerMs, 90.0f - sim[i]);
+        gpu[i] = std::min(sample.gpuMs * pxPerMs * 0.5f, 45.0f);
+        latency[i] = std::min(sample.inputMs * pxPerMs, 110.0f);
+        latencyTicks[i] = sample.inputMs > 0 ? 2.0f : 0.0f;  // Frames without input get none
+    }
+
+    Vec2 cpuGraph(20, 65);
+    drawBars(cpuGraph, zeros, sim, PERF_HUD_HISTORY, barWidth, Color(0.3f, 1.0f, 0.4f, 0.9f));
+    drawBars(cpuGraph, sim, render, PERF_HUD_HISTORY, barWidth, Color(0.3f, 0.6f, 1.0f, 0.9f));
+    drawLine(cpuGraph + Vec2(0, 80), cpuGraph + Vec2(PERF_HUD_HISTORY * barWidth, 80),
+             Color(1.0f, 0.3f, 0.3f, 0.8f));
+    drawBars(cpuGraph, latency, latencyTicks, PERF_HUD_HISTORY, barWidth, Color(1.0f, 1.0f, 1.0f, 0.9f));
+
+    Vec2 gpuGraph(20, 15);
+    drawBars(gpuGraph, zeros, gpu, PERF_HUD_HISTORY, barWidth, Color(1.0f, 0.6f, 0.2f, 0.9f));
+    drawLine(gpuGraph + Vec2(0, 40), gpuGraph + Vec2(PERF_HUD_HISTORY * barWidth, 40),
+             Color(1.0f, 0.3f, 0.3f, 0.8f));
+
+    // Counters as fill bars against their budgets: aliens, plasmas,
+    // particles, draw calls, uploaded bytes
+    float fills[5] = {
+        (float)game.aliens.size() / PERF_HUD_ALIEN_BUDGET,
+        (float)game.plasmas.size() / PERF_HUD_PLASMA_BUDGET,
+        (float)game.particles.size() / PERF_HUD_PARTICLE_BUDGET,
+        (float)hud.lastRenderStats.drawCalls / PERF_HUD_DRAW_CALL_BUDGET,
+        hud.lastRenderStats.bytesUploaded / 1024.0f / PERF_HUD_UPLOAD_BUDGET_KB
+    };
+    float counterBases[5], counterHeights[5];
+    for (int i = 0; i < 5; i++) {
+        counterBases[i] = 0;
+        counterHeights[i] = std::min(fills[i], 1.0f) * 170.0f;
+    }
+    drawBars(Vec2(PERF_HUD_HISTORY * barWidth + 30, 15), counterBases, counterHeights, 5, 8.0f,
+             Color(0.9f, 0.9f, 0.3f, 0.9f));
+}
+
 void Renderer::cleanup() {
-    if (VBO) glDeleteBuffers(1, &VBO);
-    if (VAO) glDeleteVertexArrays(1, &VAO);
-    if (shaderProgram) glDeleteProgram(shaderProgram);
+    device.cleanup();
 }
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "../include/rewind_buffer.hpp"
+#include "../include/logger.hpp"
+#include "../include/snapshot.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // Unsigned LEB128
+    uint8_t* writeVarint(uint8_t* out, size_t value) {
+        while (value >= 0x80) {
+            *out++ = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        *out++ = static_cast<uint8_t>(value);
+        return out;
+    }
+
+    const uint8_t* readVarint(const uint8_t* in, size_t& value) {
+        value = 0;
+        for (int shift = 0;; shift += 7) {
+            uint8_t byte = *in++;
+            value |= static_cast<size_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return in;
+        }
+    }
+
+    // Every snapshot field is 4 bytes and every record a multiple of 4, so
+    // deltas work on 4-byte words: a field either changed or it didn't
+    static_assert(sizeof(SnapshotHeader) % 4 == 0 && sizeof(MothershipRecord) % 4 == 0 &&
+                  sizeof(AlienRecord) % 4 == 0 && sizeof(PlasmaRecord) % 4 == 0 &&
+                  sizeof(ParticleRecord) % 4 == 0, "Rewind deltas assume 4-byte words");
+
+    uint32_t loadWord(const uint8_t* bytes, size_t word) {
+        uint32_t value;
+        std::memcpy(&value, bytes + word * 4, 4);
+        return value;
+    }
+
+    // XOR of the state against its keyframe, which counts as zero past its end
+    struct XorSource {
+        const uint8_t* current;
+        size_t words;
+        const uint8_t* keyframe;
+        size_t keyframeWords;
+
+        uint32_t at(size_t i) const {
+            return loadWord(current, i) ^ (i < keyframeWords ? loadWord(keyframe, i) : 0);
+        }
+    };
+
+    // Tokens of (unchanged word count, changed word count, changed words XORed).
+    // A literal only ends at two unchanged words, so a lone match doesn't cost a token.
+    size_t encodeDelta(const XorSource& source, uint8_t* out) {
+        uint8_t* start = out;
+        size_t i = 0;
+        while (i < source.words) {
+            size_t zeroStart = i;
+            while (i < source.words && source.at(i) == 0) i++;
+            size_t literalStart = i;
+            while (i < source.words && (source.at(i) != 0 || (i + 1 < source.words && source.at(i + 1) != 0))) i++;
+
+            out = writeVarint(out, literalStart - zeroStart);
+            out = writeVarint(out, i - literalStart);
+            for (size_t j = literalStart; j < i; j++) {
+                uint32_t value = source.at(j);
+                std::memcpy(out, &value, 4);
+                out += 4;
+            }
+        }
+        return static_cast<size_t>(out - start);
+    }
+
+    void applyDelta(const uint8_t* in, const uint8_t* end, uint8_t* state) {
+        size_t word = 0;
+        while (in < end) {
+            size_t zeros, literals;
+            in = readVarint(in, zeros);
+            in = readVarint(in, literals);
+            word += zeros;
+            for (size_t j = 0; j < literals; j++, word++, in += 4) {
+                uint32_t value = loadWord(state, word) ^ loadWord(in, 0);
+                std::memcpy(state + word * 4, &value, 4);
+            }
+        }
+    }
+}
+
+RewindBuffer::RewindBuffer(size_t budgetBytes, int maxTicks, int keyframeInterval)
+    : storage(budgetBytes), frames(std::max(1, maxTicks)), oldestSequence(0), nextSequence(0), writeOffset(0),
+      keyframeInterval(std::max(1, keyframeInterval)), rawBytesRecorded(0), storedBytesRecorded(0) {}
+
+bool RewindBuffer::overlapsLiveFrames(size_t offset, size_t bytes) const {
+    size_t tail = getFrame(oldestSequence).offset;
+    size_t end = offset + bytes;
+    if (tail < writeOffset) return offset < writeOffset && end > tail;
+    // Wrapped: live frames run from tail to the end of storage, then from 0 to writeOffset
+    return offset < writeOffset || end > tail;
+}
+
+void RewindBuffer::evictOldestGroup() {
+    // Deltas are useless without their keyframe
+    oldestSequence++;
+    while (getTickCount() > 0 && !isKeyframe(oldestSequence)) oldestSequence++;
+    if (getTickCount() == 0) writeOffset = 0;
+}
+
+bool RewindBuffer::allocate(size_t bytes, size_t& offset) {
+    if (bytes > storage.size()) return false;
+    offset = writeOffset + bytes <= storage.size() ? writeOffset : 0;
+    while (getTickCount() > 0 && overlapsLiveFrames(offset, bytes)) evictOldestGroup();
+    return true;
+}
+
+void RewindBuffer::record(const GameManager& game) {
+    encodeSnapshot(game, encoded);
+    size_t rawBytes = encoded.size();
+
+    if (getTickCount() == static_cast<int>(frames.size())) evictOldestGroup();
+
+    uint64_t keyframeSequence = nextSequence;
+    size_t deltaBytes = 0;
+    if (getTickCount() > 0) {
+        uint64_t previousKeyframe = getFrame(nextSequence - 1).keyframeSequence;
+        if (nextSequence - previousKeyframe < static_cast<uint64_t>(keyframeInterval)) {
+            const Frame& keyframe = getFrame(previousKeyframe);
+            XorSource source = { encoded.data(), rawBytes / 4, storage.data() + keyframe.offset, keyframe.rawBytes / 4u };
+            // Worst case: a token per 3 words, each with two varints of at most 5 bytes
+            delta.resize(rawBytes * 2 + 32);
+            deltaBytes = encodeDelta(source, delta.data());
+            // Past half the raw size a new keyframe is the better deal
+            if (deltaBytes <= rawBytes / 2) keyframeSequence = previousKeyframe;
+        }
+    }
+
+    bool isDelta = keyframeSequence != nextSequence;
+    size_t offset;
+    bool fits = allocate(isDelta ? deltaBytes : rawBytes, offset);
+    if (fits && isDelta && keyframeSequence < oldestSequence) {
+        // Making room evicted the keyframe this delta refers to
+        isDelta = false;
+        keyframeSequence = nextSequence;
+        fits = allocate(rawBytes, offset);
+    }
+    if (!fits) {
+        if (getTickCount() > 0 || rawBytesRecorded == 0) {
+            LOG_WARN("Rewind: a {} KB state doesn't fit the {} MB budget, not recording",
+                     rawBytes / 1024, storage.size() / (1024 * 1024));
+        }
+        clear();
+        return;
+    }
+
+    size_t storedBytes = isDelta ? deltaBytes : rawBytes;
+    std::memcpy(storage.data() + offset, isDelta ? delta.data() : encoded.data(), storedBytes);
+    Frame& frame = getFrame(nextSequence);
+    frame.keyframeSequence = keyframeSequence;
+    frame.offset = offset;
+    frame.storedBytes = static_cast<uint32_t>(storedBytes);
+    frame.rawBytes = static_cast<uint32_t>(rawBytes);
+    writeOffset = offset + storedBytes;
+    nextSequence++;
+
+    rawBytesRecorded += rawBytes;
+    storedBytesRecorded += storedBytes;
+}
+
+bool RewindBuffer::restore(int ticksBack, GameManager& game) {
+    if (ticksBack < 0 || ticksBack >= getTickCount()) return false;
+
+    uint64_t sequence = nextSequence - 1 - ticksBack;
+    const Frame& frame = getFrame(sequence);
+    const Frame& keyframe = getFrame(frame.keyframeSequence);
+
+    decoded.resize(frame.rawBytes);
+    size_t copied = std::min<size_t>(keyframe.rawBytes, frame.rawBytes);
+    std::memcpy(decoded.data(), storage.data() + keyframe.offset, copied);
+    if (sequence != frame.keyframeSequence) {
+        std::memset(decoded.data() + copied, 0, frame.rawBytes - copied);
+        const uint8_t* in = storage.data() + frame.offset;
+        applyDelta(in, in + frame.storedBytes, decoded.data());
+    }
+
+    SnapshotView view;
+    if (!view.open(decoded.data(), decoded.size())) return false;
+    view.restore(game);
+    return true;
+}
+
+void RewindBuffer::discardNewest(int count) {
+    count = std::max(0, std::min(count, getTickCount()));
+    nextSequence -= count;
+    if (getTickCount() == 0) {
+        writeOffset = 0;
+        return;
+    }
+    const Frame& newest = getFrame(nextSequence - 1);
+    writeOffset = newest.offset + newest.storedBytes;
+}
+
+void RewindBuffer::clear() {
+    oldestSequence = nextSequence;
+    writeOffset = 0;
+}
+
+size_t RewindBuffer::getUsedBytes() const {
+    size_t used = 0;
+    for (uint64_t sequence = oldestSequence; sequence < nextSequence; sequence++) {
+        used += getFrame(sequence).storedBytes;
+    }
+    return used;
+}
+
+double RewindBuffer::getCompressionRatio() const {
+    return storedBytesRecorded ? static_cast<double>(rawBytesRecorded) / storedBytesRecorded : 1.0;
+}
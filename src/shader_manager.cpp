@@ -0,0 +1,215 @@
+#include "../include/shader_manager.hpp"
+#include "../include/embedded_shaders.hpp"
+#include "../include/logger.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
+
+namespace {
+#ifdef XS_SHADER_HOT_RELOAD
+    int64_t fileStamp(const char* path) {
+        struct stat info;
+        if (stat(path, &info) != 0) return -1;
+        return static_cast<int64_t>(info.st_mtime);
+    }
+
+    bool readFile(const char* path, std::string& output) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        output.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+#endif
+
+    // Compile errors go straight to stderr: they aren't string literals the logger can hold
+    void printInfoLog(const char* label, GLuint object, bool isProgram) {
+        GLint length = 0;
+        if (isProgram) glGetProgramiv(object, GL_INFO_LOG_LENGTH, &length);
+        else glGetShaderiv(object, GL_INFO_LOG_LENGTH, &length);
+        if (length <= 1) return;
+
+        std::string log(length, '\0');
+        if (isProgram) glGetProgramInfoLog(object, length, nullptr, &log[0]);
+        else glGetShaderInfoLog(object, length, nullptr, &log[0]);
+        std::fprintf(stderr, "%s:\n%s\n", label, log.c_str());
+    }
+
+    GLuint startShaderCompile(GLenum type, const std::string& source) {
+        GLuint shader = glCreateShader(type);
+        const char* text = source.c_str();
+        glShaderSource(shader, 1, &text, nullptr);
+        glCompileShader(shader);
+        return shader;
+    }
+}
+
+ShaderManager::ShaderManager() : parallelCompile(false) {}
+
+bool ShaderManager::initialize() {
+    cache.initialize();
+
+    parallelCompile = GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+    if (GLEW_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);  // Let the driver pick
+    } else if (GLEW_ARB_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+    }
+    LOG_INFO("Shaders: parallel compile {}", parallelCompile ? "available" : "unavailable, builds finish on first poll");
+
+    nextReloadPoll = std::chrono::steady_clock::now();
+    return true;
+}
+
+void ShaderManager::cleanup() {
+    for (ShaderProgram& entry : programs) {
+        cancelBuild(entry);
+        if (entry.program) glDeleteProgram(entry.program);
+        entry.program = 0;
+    }
+    programs.clear();
+}
+
+int ShaderManager::addProgram(const char* name, const char* vertexPath, const char* fragmentPath) {
+    ShaderProgram entry;
+    entry.name = name;
+    entry.vertexPath = vertexPath;
+    entry.fragmentPath = fragmentPath;
+    entry.program = 0;
+    entry.generation = 0;
+    entry.pendingProgram = entry.pendingVertex = entry.pendingFragment = 0;
+    entry.vertexStamp = entry.fragmentStamp = -1;
+
+    if (!loadSources(entry)) {
+        LOG_ERROR("Shaders: no source for program {}", name);
+        return -1;
+    }
+    programs.push_back(entry);
+    startBuild(programs.back());
+    return static_cast<int>(programs.size()) - 1;
+}
+
+bool ShaderManager::loadSources(ShaderProgram& entry) const {
+#ifdef XS_SHADER_HOT_RELOAD
+    // Files on disk win so edits since the build are picked up
+    entry.vertexStamp = fileStamp(entry.vertexPath);
+    entry.fragmentStamp = fileStamp(entry.fragmentPath);
+    bool haveVertex = entry.vertexStamp >= 0 && readFile(entry.vertexPath, entry.vertexSource);
+    bool haveFragment = entry.fragmentStamp >= 0 && readFile(entry.fragmentPath, entry.fragmentSource);
+#else
+    bool haveVertex = false, haveFragment = false;
+#endif
+    if (!haveVertex) {
+        const char* embedded = findEmbeddedShader(entry.vertexPath);
+        if (!embedded) return false;
+        entry.vertexSource = embedded;
+    }
+    if (!haveFragment) {
+        const char* embedded = findEmbeddedShader(entry.fragmentPath);
+        if (!embedded) return false;
+        entry.fragmentSource = embedded;
+    }
+    return true;
+}
+
+void ShaderManager::startBuild(ShaderProgram& entry) {
+    cancelBuild(entry);
+
+    GLuint cached = cache.findProgram(entry.name, entry.vertexSource.c_str(), entry.fragmentSource.c_str());
+    if (cached) {
+        if (entry.program) glDeleteProgram(entry.program);
+        entry.program = cached;
+        entry.generation++;
+        return;
+    }
+
+    // Nothing here waits: status is only queried in isBuildComplete()
+    entry.pendingVertex = startShaderCompile(GL_VERTEX_SHADER, entry.vertexSource);
+    entry.pendingFragment = startShaderCompile(GL_FRAGMENT_SHADER, entry.fragmentSource);
+    entry.pendingProgram = glCreateProgram();
+    glAttachShader(entry.pendingProgram, entry.pendingVertex);
+    glAttachShader(entry.pendingProgram, entry.pendingFragment);
+    if (cache.isSupported()) glProgramParameteri(entry.pendingProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(entry.pendingProgram);
+}
+
+void ShaderManager::cancelBuild(ShaderProgram& entry) {
+    if (entry.pendingProgram) glDeleteProgram(entry.pendingProgram);
+    if (entry.pendingVertex) glDeleteShader(entry.pendingVertex);
+    if (entry.pendingFragment) glDeleteShader(entry.pendingFragment);
+    entry.pendingProgram = entry.pendingVertex = entry.pendingFragment = 0;
+}
+
+bool ShaderManager::isBuildComplete(const ShaderProgram& entry) const {
+    if (!parallelCompile) return true;
+    GLint complete = GL_FALSE;
+    glGetProgramiv(entry.pendingProgram, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete == GL_TRUE;
+}
+
+void ShaderManager::finishBuild(ShaderProgram& entry) {
+    GLint vertexOk = GL_FALSE, fragmentOk = GL_FALSE, linked = GL_FALSE;
+    glGetShaderiv(entry.pendingVertex, GL_COMPILE_STATUS, &vertexOk);
+    glGetShaderiv(entry.pendingFragment, GL_COMPILE_STATUS, &fragmentOk);
+    if (vertexOk && fragmentOk) glGetProgramiv(entry.pendingProgram, GL_LINK_STATUS, &linked);
+
+    if (!linked) {
+        printInfoLog(entry.vertexPath, entry.pendingVertex, false);
+        printInfoLog(entry.fragmentPath, entry.pendingFragment, false);
+        if (vertexOk && fragmentOk) printInfoLog(entry.name, entry.pendingProgram, true);
+        if (entry.program) {
+            LOG_WARN("Shaders: {} failed to build, keeping the previous program", entry.name);
+        } else {
+            LOG_ERROR("Shaders: {} failed to build", entry.name);
+        }
+        cancelBuild(entry);
+        return;
+    }
+
+    glDetachShader(entry.pendingProgram, entry.pendingVertex);
+    glDetachShader(entry.pendingProgram, entry.pendingFragment);
+    glDeleteShader(entry.pendingVertex);
+    glDeleteShader(entry.pendingFragment);
+
+    cache.storeProgram(entry.name, entry.vertexSource.c_str(), entry.fragmentSource.c_str(), entry.pendingProgram);
+    if (entry.program) glDeleteProgram(entry.program);
+    entry.program = entry.pendingProgram;
+    entry.generation++;
+    entry.pendingProgram = entry.pendingVertex = entry.pendingFragment = 0;
+    LOG_INFO("Shaders: {} built (generation {})", entry.name, entry.generation);
+}
+
+void ShaderManager::update() {
+    for (ShaderProgram& entry : programs) {
+        if (entry.pendingProgram && isBuildComplete(entry)) finishBuild(entry);
+    }
+
+#ifdef XS_SHADER_HOT_RELOAD
+    auto now = std::chrono::steady_clock::now();
+    if (now >= nextReloadPoll) {
+        nextReloadPoll = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<float>(SHADER_RELOAD_POLL_SECONDS));
+        checkForEdits();
+    }
+#endif
+}
+
+#ifdef XS_SHADER_HOT_RELOAD
+void ShaderManager::checkForEdits() {
+    for (ShaderProgram& entry : programs) {
+        int64_t vertexStamp = fileStamp(entry.vertexPath);
+        int64_t fragmentStamp = fileStamp(entry.fragmentPath);
+        if (vertexStamp == entry.vertexStamp && fragmentStamp == entry.fragmentStamp) continue;
+
+        LOG_INFO("Shaders: {} sources changed, rebuilding", entry.name);
+        if (loadSources(entry)) startBuild(entry);
+    }
+}
+#endif
+
+void ShaderManager::finishPending() {
+    for (ShaderProgram& entry : programs) {
+        // Without the extension the status queries below block until done
+        if (entry.pendingProgram) finishBuild(entry);
+    }
+}
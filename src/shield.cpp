@@ -37,3 +37,16 @@ float ShieldSystem::absorbDamage(float incomingDamage) {
 
     return actualDamage;
 }
+
+ShieldState ShieldSystem::getState() const {
+    return ShieldState{maxEnergy, currentEnergy, regenRate, regenDelay, timeSinceLastHit, absorptionEfficiency};
+}
+
+void ShieldSystem::setState(const ShieldState& state) {
+    maxEnergy = state.maxEnergy;
+    currentEnergy = state.currentEnergy;
+    regenRate = state.regenRate;
+    regenDelay = state.regenDelay;
+    timeSinceLastHit = state.timeSinceLastHit;
+    absorptionEfficiency = state.absorptionEfficiency;
+}
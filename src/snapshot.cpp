@@ -0,0 +1,352 @@
+#include "../include/snapshot.hpp"
+#include "../include/logger.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    size_t getSectionsSize(size_t motherships, size_t aliens, size_t plasmas, size_t particles, size_t wingmen) {
+        return motherships * sizeof(MothershipRecord) + aliens * sizeof(AlienRecord) +
+               plasmas * sizeof(PlasmaRecord) + particles * sizeof(ParticleRecord) +
+               wingmen * sizeof(SpacecraftRecord);
+    }
+
+    SpacecraftRecord toRecord(const Spacecraft& ship) {
+        ShieldState shield = ship.shield.getState();
+        SpacecraftRecord craft;
+        craft.positionX = ship.position.x;
+        craft.positionY = ship.position.y;
+        craft.velocityX = ship.velocity.x;
+        craft.velocityY = ship.velocity.y;
+        craft.rotation = ship.rotation;
+        craft.shootCooldown = ship.shootCooldown;
+        craft.ammo = ship.ammo;
+        craft.maxAmmo = ship.maxAmmo;
+        craft.thrusterPulse = ship.thrusterPulse;
+        craft.shieldMaxEnergy = shield.maxEnergy;
+        craft.shieldCurrentEnergy = shield.currentEnergy;
+        craft.shieldRegenRate = shield.regenRate;
+        craft.shieldRegenDelay = shield.regenDelay;
+        craft.shieldTimeSinceLastHit = shield.timeSinceLastHit;
+        craft.shieldAbsorptionEfficiency = shield.absorptionEfficiency;
+        craft.reserved = 0;
+        return craft;
+    }
+
+    void fromRecord(const SpacecraftRecord& craft, Spacecraft& ship) {
+        ship.position = Vec2(craft.positionX, craft.positionY);
+        ship.velocity = Vec2(craft.velocityX, craft.velocityY);
+        ship.rotation = craft.rotation;
+        ship.shootCooldown = craft.shootCooldown;
+        ship.ammo = craft.ammo;
+        ship.maxAmmo = craft.maxAmmo;
+        ship.thrusterPulse = craft.thrusterPulse;
+        ship.shield.setState(ShieldState{craft.shieldMaxEnergy, craft.shieldCurrentEnergy, craft.shieldRegenRate,
+                                         craft.shieldRegenDelay, craft.shieldTimeSinceLastHit,
+                                         craft.shieldAbsorptionEfficiency});
+    }
+
+    template <typename T>
+    uint8_t* writeRecord(uint8_t* cursor, const T& record) {
+        std::memcpy(cursor, &record, sizeof(T));
+        return cursor + sizeof(T);
+    }
+}
+
+size_t getSnapshotSize(const GameManager& game) {
+    return sizeof(SnapshotHeader) + getSectionsSize(game.motherships.size(), game.aliens.size(),
+                                                    game.plasmas.size(), game.particles.size(),
+                                                    game.wingmen.size());
+}
+
+void encodeSnapshot(const GameManager& game, std::vector<uint8_t>& out) {
+    out.resize(getSnapshotSize(game));
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.headerBytes = sizeof(SnapshotHeader);
+    header.aliensSpawned = game.aliensSpawned;
+    header.totalBytes = out.size();
+    header.rngState = game.rng.state;
+    header.rngIncrement = game.rng.increment;
+    header.mothershipCount = static_cast<uint32_t>(game.motherships.size());
+    header.alienCount = static_cast<uint32_t>(game.aliens.size());
+    header.plasmaCount = static_cast<uint32_t>(game.plasmas.size());
+    header.particleCount = static_cast<uint32_t>(game.particles.size());
+    header.wave = game.wave;
+    header.score = game.score;
+    header.killCount = game.killCount;
+    header.waveActive = game.waveActive;
+    header.gameState = static_cast<uint32_t>(game.gameState);
+    header.stateTimer = game.stateTimer;
+    header.tickCount = game.tickCount;
+    header.wingmanCount = static_cast<uint32_t>(game.wingmen.size());
+    header.spacecraft = toRecord(game.spacecraft);
+
+    uint8_t* cursor = writeRecord(out.data(), header);
+
+    for (const Mothership& m : game.motherships) {
+        MothershipRecord r;
+        r.positionX = m.position.x;
+        r.positionY = m.position.y;
+        r.velocityX = m.velocity.x;
+        r.velocityY = m.velocity.y;
+        r.size = m.size;
+        r.active = m.active;
+        r.animationTime = m.animationTime;
+        r.spawnTimer = m.spawnTimer;
+        r.spawnInterval = m.spawnInterval;
+        r.aliensToSpawn = m.aliensToSpawn;
+        cursor = writeRecord(cursor, r);
+    }
+    for (const Alien& a : game.aliens) {
+        AlienRecord r;
+        r.positionX = a.position.x;
+        r.positionY = a.position.y;
+        r.velocityX = a.velocity.x;
+        r.velocityY = a.velocity.y;
+        r.type = static_cast<uint32_t>(a.type);
+        r.health = a.health;
+        r.speed = a.speed;
+        r.active = a.active;
+        r.spawnAnimation = a.spawnAnimation;
+        r.animationTime = a.animationTime;
+        r.pendingSteerTime = a.pendingSteerTime;
+        r.steerSlot = a.steerSlot;
+        cursor = writeRecord(cursor, r);
+    }
+    for (const Plasma& p : game.plasmas) {
+        PlasmaRecord r;
+        r.positionX = p.position.x;
+        r.positionY = p.position.y;
+        r.velocityX = p.velocity.x;
+        r.velocityY = p.velocity.y;
+        r.active = p.active;
+        r.lifetime = p.lifetime;
+        cursor = writeRecord(cursor, r);
+    }
+    for (const Particle& p : game.particles) {
+        ParticleRecord r;
+        r.positionX = p.position.x;
+        r.positionY = p.position.y;
+        r.velocityX = p.velocity.x;
+        r.velocityY = p.velocity.y;
+        r.lifetime = p.lifetime;
+        r.maxLifetime = p.maxLifetime;
+        r.colorR = p.color.r;
+        r.colorG = p.color.g;
+        r.colorB = p.color.b;
+        r.colorA = p.color.a;
+        cursor = writeRecord(cursor, r);
+    }
+    for (const Spacecraft& wingman : game.wingmen) {
+        cursor = writeRecord(cursor, toRecord(wingman));
+    }
+}
+
+bool saveSnapshot(const GameManager& game, const char* path) {
+    std::vector<uint8_t> buffer;
+    encodeSnapshot(game, buffer);
+
+    int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        LOG_WARN("Snapshot: failed to open the output file");
+        return false;
+    }
+
+    // One write() for the whole state; only loops if the kernel writes it partially
+    size_t written = 0;
+    while (written < buffer.size()) {
+        ssize_t n = ::write(fd, buffer.data() + written, buffer.size() - written);
+        if (n <= 0) break;
+        written += static_cast<size_t>(n);
+    }
+    bool ok = ::close(fd) == 0 && written == buffer.size();
+    if (!ok) LOG_WARN("Snapshot: write error, the file is incomplete");
+    return ok;
+}
+
+SnapshotView::SnapshotView() : data(nullptr), size(0), mapping(nullptr), mappingSize(0) {}
+
+SnapshotView::~SnapshotView() {
+    close();
+}
+
+size_t SnapshotView::getAliensOffset() const {
+    return sizeof(SnapshotHeader) + getHeader().mothershipCount * sizeof(MothershipRecord);
+}
+
+size_t SnapshotView::getPlasmasOffset() const {
+    return getAliensOffset() + getHeader().alienCount * sizeof(AlienRecord);
+}
+
+size_t SnapshotView::getParticlesOffset() const {
+    return getPlasmasOffset() + getHeader().plasmaCount * sizeof(PlasmaRecord);
+}
+
+size_t SnapshotView::getWingmenOffset() const {
+    return getParticlesOffset() + getHeader().particleCount * sizeof(ParticleRecord);
+}
+
+bool SnapshotView::open(const void* bytes, size_t byteCount) {
+    close();
+    const uint8_t* candidate = static_cast<const uint8_t*>(bytes);
+    if (!candidate || byteCount < sizeof(SnapshotHeader) || reinterpret_cast<uintptr_t>(candidate) % 8 != 0) {
+        return false;
+    }
+
+    const SnapshotHeader& header = *reinterpret_cast<const SnapshotHeader*>(candidate);
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+        header.headerBytes != sizeof(SnapshotHeader)) {
+        LOG_WARN("Snapshot: not a version {} snapshot", SNAPSHOT_VERSION);
+        return false;
+    }
+
+    // Counts are 32-bit, so this can't overflow a 64-bit size_t
+    size_t expected = sizeof(SnapshotHeader) + getSectionsSize(header.mothershipCount, header.alienCount,
+                                                               header.plasmaCount, header.particleCount,
+                                                               header.wingmanCount);
+    if (header.totalBytes != expected || expected > byteCount ||
+        header.gameState > static_cast<uint32_t>(GameState::GAME_OVER_AMMO) ||
+        header.wingmanCount >= static_cast<uint32_t>(MAX_PLAYERS)) {
+        LOG_WARN("Snapshot: truncated or corrupt");
+        return false;
+    }
+
+    const AlienRecord* aliens = reinterpret_cast<const AlienRecord*>(
+        candidate + sizeof(SnapshotHeader) + header.mothershipCount * sizeof(MothershipRecord));
+    for (uint32_t i = 0; i < header.alienCount; i++) {
+        if (aliens[i].type > static_cast<uint32_t>(AlienType::BRUTE)) {
+            LOG_WARN("Snapshot: truncated or corrupt");
+            return false;
+        }
+    }
+
+    data = candidate;
+    size = expected;
+    return true;
+}
+
+bool SnapshotView::openFile(const char* path) {
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        LOG_WARN("Snapshot: failed to open the snapshot file");
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(SnapshotHeader))) {
+        ::close(fd);
+        LOG_WARN("Snapshot: truncated or corrupt");
+        return false;
+    }
+
+    // Private read-only mapping: pages are faulted in as records are read
+    size_t length = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        LOG_WARN("Snapshot: failed to map the snapshot file");
+        return false;
+    }
+
+    if (!open(mapped, length)) {
+        munmap(mapped, length);
+        return false;
+    }
+    mapping = mapped;
+    mappingSize = length;
+    return true;
+}
+
+void SnapshotView::close() {
+    if (mapping) munmap(mapping, mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
+    data = nullptr;
+    size = 0;
+}
+
+void SnapshotView::restore(GameManager& game) const {
+    const SnapshotHeader& header = getHeader();
+
+    game.rng.state = header.rngState;
+    game.rng.increment = header.rngIncrement;
+    game.wave = header.wave;
+    game.score = header.score;
+    game.killCount = header.killCount;
+    game.waveActive = header.waveActive != 0;
+    game.gameState = static_cast<GameState>(header.gameState);
+    game.stateTimer = header.stateTimer;
+    game.tickCount = header.tickCount;
+    game.aliensSpawned = header.aliensSpawned;
+
+    fromRecord(header.spacecraft, game.spacecraft);
+    // Wingman inputs aren't game state: kept for ships that stay, idle for new ones
+    game.wingmen.resize(header.wingmanCount);
+    game.wingmanInputs.resize(header.wingmanCount);
+    const SpacecraftRecord* wingmen = getWingmen();
+    for (uint32_t i = 0; i < header.wingmanCount; i++) {
+        fromRecord(wingmen[i], game.wingmen[i]);
+    }
+
+    game.motherships.clear();
+    game.motherships.reserve(header.mothershipCount);
+    const MothershipRecord* motherships = getMotherships();
+    for (uint32_t i = 0; i < header.mothershipCount; i++) {
+        const MothershipRecord& r = motherships[i];
+        Mothership m(Vec2(r.positionX, r.positionY), r.aliensToSpawn);
+        m.velocity = Vec2(r.velocityX, r.velocityY);
+        m.size = r.size;
+        m.active = r.active != 0;
+        m.animationTime = r.animationTime;
+        m.spawnTimer = r.spawnTimer;
+        m.spawnInterval = r.spawnInterval;
+        game.motherships.push_back(m);
+    }
+
+    game.aliens.clear();
+    game.aliens.reserve(header.alienCount);
+    const AlienRecord* aliens = getAliens();
+    for (uint32_t i = 0; i < header.alienCount; i++) {
+        const AlienRecord& r = aliens[i];
+        Alien a(Vec2(r.positionX, r.positionY), static_cast<AlienType>(r.type), 1);
+        a.velocity = Vec2(r.velocityX, r.velocityY);
+        a.health = r.health;
+        a.speed = r.speed;
+        a.active = r.active != 0;
+        a.spawnAnimation = r.spawnAnimation;
+        a.animationTime = r.animationTime;
+        a.pendingSteerTime = r.pendingSteerTime;
+        a.steerSlot = r.steerSlot;
+        game.aliens.insert(a);
+    }
+    game.rebuildAlienGrid();
+
+    game.plasmas.clear();
+    game.plasmas.reserve(header.plasmaCount);
+    const PlasmaRecord* plasmas = getPlasmas();
+    for (uint32_t i = 0; i < header.plasmaCount; i++) {
+        const PlasmaRecord& r = plasmas[i];
+        Plasma p(Vec2(r.positionX, r.positionY), Vec2(r.velocityX, r.velocityY));
+        p.active = r.active != 0;
+        p.lifetime = r.lifetime;
+        game.plasmas.insert(p);
+    }
+
+    game.particles.clear();
+    game.particles.reserve(header.particleCount);
+    const ParticleRecord* particles = getParticles();
+    for (uint32_t i = 0; i < header.particleCount; i++) {
+        const ParticleRecord& r = particles[i];
+        Particle p(Vec2(r.positionX, r.positionY), Vec2(r.velocityX, r.velocityY), r.lifetime,
+                   Color(r.colorR, r.colorG, r.colorB, r.colorA));
+        p.maxLifetime = r.maxLifetime;
+        game.particles.insert(p);
+    }
+}
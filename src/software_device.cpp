@@ -0,0 +1,490 @@
+#include "../include/software_device.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+    uint32_t packColor(Color color) {
+        auto channel = [](float v) {
+            return static_cast<uint32_t>(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f);
+        };
+        return channel(color.r) | (channel(color.g) << 8) | (channel(color.b) << 16) | (channel(color.a) << 24);
+    }
+
+    // dst + (src - dst) * alpha / 128 per channel, alpha included, which is
+    // GL_SRC_ALPHA / GL_ONE_MINUS_SRC_ALPHA applied to all four channels
+    uint32_t blendPixel(uint32_t dst, uint32_t src, int alpha) {
+        uint32_t out = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            int d = (dst >> shift) & 0xFF;
+            int s = (src >> shift) & 0xFF;
+            out |= static_cast<uint32_t>(d + (((s - d) * alpha) >> 7)) << shift;
+        }
+        return out;
+    }
+
+    // Edges shorter than this have no reliable direction (a circle fan's
+    // closing edge, for instance) and are ignored by the convex path
+    const float MIN_EDGE_LENGTH = 1e-3f;
+
+    bool isTinyEdge(const float* p, const float* q) {
+        return std::fabs(q[0] - p[0]) + std::fabs(q[1] - p[1]) < MIN_EDGE_LENGTH;
+    }
+
+    // A fan over a convex outline covers exactly that polygon, which can be
+    // filled span by span instead of triangle by triangle
+    bool isConvex(const float* v, int count) {
+        int first = -1;
+        for (int i = 0; i < count && first < 0; i++) {
+            if (!isTinyEdge(v + i * 2, v + ((i + 1) % count) * 2)) first = i;
+        }
+        if (count < 3 || first < 0) return false;
+
+        // Every turn the same way, and x reverses direction at most twice
+        // (rules out outlines that wind round more than once)
+        const float* p0 = v + first * 2;
+        const float* q0 = v + ((first + 1) % count) * 2;
+        float prevX = q0[0] - p0[0], prevY = q0[1] - p0[1];
+        float sign = 0, prevDirX = prevX;
+        int directionChanges = 0;
+        for (int step = 1; step <= count; step++) {
+            int index = (first + step) % count;
+            const float* p = v + index * 2;
+            const float* q = v + ((index + 1) % count) * 2;
+            if (isTinyEdge(p, q)) continue;
+
+            float dx = q[0] - p[0], dy = q[1] - p[1];
+            float cross = prevX * dy - prevY * dx;
+            if (cross != 0) {
+                if (sign == 0) sign = cross;
+                else if ((cross > 0) != (sign > 0)) return false;
+            }
+            if (dx != 0) {
+                if (prevDirX != 0 && (dx > 0) != (prevDirX > 0)) directionChanges++;
+                prevDirX = dx;
+            }
+            prevX = dx;
+            prevY = dy;
+        }
+        return sign != 0 && directionChanges <= 2;
+    }
+
+    // Edge p->q, positive on the inside once the triangle is oriented.
+    // Evaluated relative to the lower endpoint, so p->q and q->p give
+    // exactly negated values and a shared edge is never both inside or
+    // both outside. Of the two, only the edge with ownsZero takes pixels
+    // that land exactly on it, so fans don't double-blend their spokes.
+    struct Edge {
+        float a, b;
+        float originX, originY;
+        bool ownsZero;
+
+        Edge() : a(0), b(0), originX(0), originY(0), ownsZero(false) {}
+        Edge(const float* p, const float* q)
+            : a(p[1] - q[1]), b(q[0] - p[0]), ownsZero(a > 0 || (a == 0 && b > 0)) {
+            bool pFirst = p[0] < q[0] || (p[0] == q[0] && p[1] < q[1]);
+            originX = pFirst ? p[0] : q[0];
+            originY = pFirst ? p[1] : q[1];
+        }
+
+        float at(float x, float y) const { return a * (x - originX) + b * (y - originY); }
+        bool inside(float x, float y) const {
+            float w = at(x, y);
+            return w > 0 || (w == 0 && ownsZero);
+        }
+    };
+}
+
+SoftwareDevice::SoftwareDevice(int width, int height, int threadCount)
+    : width(width), height(height), stride((width + 3) & ~3),
+      tilesX((width + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE),
+      tilesY((height + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE),
+      pixels(static_cast<size_t>(stride) * height), tileBins(tilesX * tilesY),
+      clearColor(0), transform(), lastFrameMs(0),
+      jobGeneration(0), pendingWorkers(0), stopping(false), nextTile(0) {
+    transform[0] = transform[5] = transform[10] = transform[15] = 1.0f;
+
+    if (threadCount <= 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < threadCount; i++) {
+        workers.emplace_back(&SoftwareDevice::workerLoop, this);
+    }
+}
+
+SoftwareDevice::~SoftwareDevice() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+void SoftwareDevice::workerLoop() {
+    uint64_t seenGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = jobGeneration;
+        }
+        runTiles();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pendingWorkers == 0) done.notify_one();
+        }
+    }
+}
+
+void SoftwareDevice::runTiles() {
+    int tileCount = tilesX * tilesY;
+    for (int tile = nextTile.fetch_add(1); tile < tileCount; tile = nextTile.fetch_add(1)) {
+        rasterizeTile(tile);
+    }
+}
+
+void SoftwareDevice::beginFrame(Color clear) {
+    clearColor = packColor(clear);
+    screenVertices.clear();
+    draws.clear();
+    for (auto& bin : tileBins) bin.clear();
+}
+
+void SoftwareDevice::endFrame() {
+    auto start = std::chrono::steady_clock::now();
+
+    nextTile.store(0);
+    if (!workers.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pendingWorkers = static_cast<int>(workers.size());
+            jobGeneration++;
+        }
+        wake.notify_all();
+    }
+    runTiles();
+    if (!workers.empty()) {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return pendingWorkers == 0; });
+    }
+
+    lastFrameMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void SoftwareDevice::uploadVertices(const float* data, size_t floatCount) {
+    uploaded.assign(data, data + floatCount);
+}
+
+void SoftwareDevice::setColor(Color color) {
+    currentColor = color;
+}
+
+void SoftwareDevice::setTransform(const float* matrix) {
+    std::memcpy(transform, matrix, sizeof(transform));
+}
+
+void SoftwareDevice::draw(PrimitiveType primitive, int firstVertex, int vertexCount) {
+    int available = static_cast<int>(uploaded.size() / 3) - firstVertex;
+    vertexCount = std::min(vertexCount, available);
+    if (vertexCount <= 0) return;
+
+    DrawRecord record;
+    record.primitive = primitive;
+    record.firstVertex = static_cast<uint32_t>(screenVertices.size() / 2);
+    record.vertexCount = static_cast<uint32_t>(vertexCount);
+    record.color = packColor(currentColor);
+    record.alpha = static_cast<int>(std::min(std::max(currentColor.a, 0.0f), 1.0f) * 128.0f + 0.5f);
+    record.convex = false;
+    if (record.alpha == 0) return;
+
+    // Transform to window coordinates, y down, and track the bounds
+    float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f;
+    const float* m = transform;
+    for (int i = 0; i < vertexCount; i++) {
+        const float* v = &uploaded[(firstVertex + i) * 3];
+        float x = m[0] * v[0] + m[4] * v[1] + m[8] * v[2] + m[12];
+        float y = m[1] * v[0] + m[5] * v[1] + m[9] * v[2] + m[13];
+        float w = m[3] * v[0] + m[7] * v[1] + m[11] * v[2] + m[15];
+        if (w != 1.0f && w != 0.0f) {
+            x /= w;
+            y /= w;
+        }
+        float sx = (x + 1.0f) * 0.5f * width;
+        float sy = (1.0f - y) * 0.5f * height;
+        screenVertices.push_back(sx);
+        screenVertices.push_back(sy);
+        minX = std::min(minX, sx); maxX = std::max(maxX, sx);
+        minY = std::min(minY, sy); maxY = std::max(maxY, sy);
+    }
+
+    // Clamp before converting so far off-screen geometry can't overflow int
+    if (primitive == PrimitiveType::TRIANGLE_FAN) {
+        record.convex = isConvex(&screenVertices[record.firstVertex * 2], vertexCount);
+    }
+
+    float pad = primitive == PrimitiveType::LINES ? 1.0f : 0.0f;
+    minX = std::max(minX, -SOFTWARE_TILE_SIZE * 1.0f);
+    minY = std::max(minY, -SOFTWARE_TILE_SIZE * 1.0f);
+    maxX = std::min(maxX, width + SOFTWARE_TILE_SIZE * 1.0f);
+    maxY = std::min(maxY, height + SOFTWARE_TILE_SIZE * 1.0f);
+    int tx0 = std::max(0, static_cast<int>(std::floor((minX - pad) / SOFTWARE_TILE_SIZE)));
+    int ty0 = std::max(0, static_cast<int>(std::floor((minY - pad) / SOFTWARE_TILE_SIZE)));
+    int tx1 = std::min(tilesX - 1, static_cast<int>(std::floor((maxX + pad) / SOFTWARE_TILE_SIZE)));
+    int ty1 = std::min(tilesY - 1, static_cast<int>(std::floor((maxY + pad) / SOFTWARE_TILE_SIZE)));
+    if (tx0 > tx1 || ty0 > ty1) {
+        screenVertices.resize(record.firstVertex * 2);  // Entirely off screen
+        return;
+    }
+
+    uint32_t index = static_cast<uint32_t>(draws.size());
+    draws.push_back(record);
+    for (int ty = ty0; ty <= ty1; ty++) {
+        for (int tx = tx0; tx <= tx1; tx++) tileBins[ty * tilesX + tx].push_back(index);
+    }
+}
+
+void SoftwareDevice::rasterizeTile(int tile) {
+    int tileRect[4];  // x0, y0, x1, y1 (exclusive)
+    tileRect[0] = (tile % tilesX) * SOFTWARE_TILE_SIZE;
+    tileRect[1] = (tile / tilesX) * SOFTWARE_TILE_SIZE;
+    tileRect[2] = std::min(tileRect[0] + SOFTWARE_TILE_SIZE, width);
+    tileRect[3] = std::min(tileRect[1] + SOFTWARE_TILE_SIZE, height);
+
+    for (int y = tileRect[1]; y < tileRect[3]; y++) {
+        uint32_t* row = pixels.data() + static_cast<size_t>(y) * stride;
+        std::fill(row + tileRect[0], row + tileRect[2], clearColor);
+    }
+
+    for (uint32_t index : tileBins[tile]) {
+        const DrawRecord& draw = draws[index];
+        const float* v = &screenVertices[draw.firstVertex * 2];
+        int count = static_cast<int>(draw.vertexCount);
+
+        switch (draw.primitive) {
+        case PrimitiveType::TRIANGLES:
+            for (int i = 0; i + 2 < count; i += 3) {
+                rasterizeTriangle(tileRect, v + i * 2, v + (i + 1) * 2, v + (i + 2) * 2, draw);
+            }
+            break;
+        case PrimitiveType::TRIANGLE_FAN:
+            if (draw.convex) {
+                rasterizeConvex(tileRect, v, count, draw);
+                break;
+            }
+            for (int i = 1; i + 1 < count; i++) {
+                rasterizeTriangle(tileRect, v, v + i * 2, v + (i + 1) * 2, draw);
+            }
+            break;
+        case PrimitiveType::LINES:
+            // One pixel wide quad along the segment
+            for (int i = 0; i + 1 < count; i += 2) {
+                const float* a = v + i * 2;
+                const float* b = v + (i + 1) * 2;
+                float dx = b[0] - a[0], dy = b[1] - a[1];
+                float length = std::sqrt(dx * dx + dy * dy);
+                if (length == 0) continue;
+                float nx = -dy / length * 0.5f, ny = dx / length * 0.5f;
+                float quad[8] = { a[0] + nx, a[1] + ny, a[0] - nx, a[1] - ny,
+                                  b[0] - nx, b[1] - ny, b[0] + nx, b[1] + ny };
+                rasterizeTriangle(tileRect, quad, quad + 2, quad + 4, draw);
+                rasterizeTriangle(tileRect, quad, quad + 4, quad + 6, draw);
+            }
+            break;
+        }
+    }
+}
+
+void SoftwareDevice::rasterizeTriangle(const int* tileRect, const float* a, const float* b, const float* c,
+                                       const DrawRecord& draw) {
+    float area = Edge(a, b).at(c[0], c[1]);
+    if (area == 0 || std::isnan(area)) return;
+    if (area < 0) std::swap(b, c);
+
+    Edge e0(a, b), e1(b, c), e2(c, a);
+
+    // Bounds are clamped to the tile as floats first so huge coordinates
+    // can't overflow the int conversion
+    int minX = static_cast<int>(std::floor(std::max<float>(tileRect[0], std::min({ a[0], b[0], c[0] }))));
+    int minY = static_cast<int>(std::floor(std::max<float>(tileRect[1], std::min({ a[1], b[1], c[1] }))));
+    int maxX = static_cast<int>(std::ceil(std::min<float>(tileRect[2] - 1, std::max({ a[0], b[0], c[0] }))));
+    int maxY = static_cast<int>(std::ceil(std::min<float>(tileRect[3] - 1, std::max({ a[1], b[1], c[1] }))));
+    if (minX > maxX || minY > maxY) return;
+
+    // Groups of four start on tile-relative multiples of 4 so a store never
+    // touches a neighbouring tile being rasterized by another thread
+    int startX = tileRect[0] + ((minX - tileRect[0]) & ~3);
+
+#if defined(__SSE2__)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+    const __m128 a0 = _mm_set1_ps(e0.a), a1 = _mm_set1_ps(e1.a), a2 = _mm_set1_ps(e2.a);
+    const __m128 ox0 = _mm_set1_ps(e0.originX), ox1 = _mm_set1_ps(e1.originX), ox2 = _mm_set1_ps(e2.originX);
+    const __m128 own0 = _mm_castsi128_ps(_mm_set1_epi32(e0.ownsZero ? -1 : 0));
+    const __m128 own1 = _mm_castsi128_ps(_mm_set1_epi32(e1.ownsZero ? -1 : 0));
+    const __m128 own2 = _mm_castsi128_ps(_mm_set1_epi32(e2.ownsZero ? -1 : 0));
+
+    const __m128i zeroI = _mm_setzero_si128();
+    const __m128i src = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(draw.color)), zeroI);
+    const __m128i alpha = _mm_set1_epi16(static_cast<short>(draw.alpha));
+
+    for (int y = minY; y <= maxY; y++) {
+        float py = y + 0.5f;
+        __m128 row0 = _mm_set1_ps(e0.b * (py - e0.originY));
+        __m128 row1 = _mm_set1_ps(e1.b * (py - e1.originY));
+        __m128 row2 = _mm_set1_ps(e2.b * (py - e2.originY));
+        uint32_t* row = pixels.data() + static_cast<size_t>(y) * stride;
+
+        for (int x = startX; x <= maxX; x += 4) {
+            __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+            __m128 w0 = _mm_add_ps(_mm_mul_ps(a0, _mm_sub_ps(px, ox0)), row0);
+            __m128 w1 = _mm_add_ps(_mm_mul_ps(a1, _mm_sub_ps(px, ox1)), row1);
+            __m128 w2 = _mm_add_ps(_mm_mul_ps(a2, _mm_sub_ps(px, ox2)), row2);
+
+            // w > 0, or w == 0 on an edge that owns its boundary
+            __m128 in0 = _mm_or_ps(_mm_cmpgt_ps(w0, zero), _mm_and_ps(own0, _mm_cmpeq_ps(w0, zero)));
+            __m128 in1 = _mm_or_ps(_mm_cmpgt_ps(w1, zero), _mm_and_ps(own1, _mm_cmpeq_ps(w1, zero)));
+            __m128 in2 = _mm_or_ps(_mm_cmpgt_ps(w2, zero), _mm_and_ps(own2, _mm_cmpeq_ps(w2, zero)));
+            __m128 inside = _mm_and_ps(_mm_and_ps(in0, in1), in2);
+            if (_mm_movemask_ps(inside) == 0) continue;
+
+            __m128i dst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+            __m128i lo = _mm_unpacklo_epi8(dst, zeroI);
+            __m128i hi = _mm_unpackhi_epi8(dst, zeroI);
+            lo = _mm_add_epi16(lo, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(src, lo), alpha), 7));
+            hi = _mm_add_epi16(hi, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(src, hi), alpha), 7));
+            __m128i blended = _mm_packus_epi16(lo, hi);
+
+            __m128i mask = _mm_castps_si128(inside);
+            __m128i result = _mm_or_si128(_mm_and_si128(mask, blended), _mm_andnot_si128(mask, dst));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), result);
+        }
+    }
+#else
+    for (int y = minY; y <= maxY; y++) {
+        float py = y + 0.5f;
+        uint32_t* row = pixels.data() + static_cast<size_t>(y) * stride;
+        for (int x = startX; x <= maxX; x++) {
+            float px = x + 0.5f;
+            if (e0.inside(px, py) && e1.inside(px, py) && e2.inside(px, py)) {
+                row[x] = blendPixel(row[x], draw.color, draw.alpha);
+            }
+        }
+    }
+#endif
+}
+
+void SoftwareDevice::blendSpan(uint32_t* row, int x0, int x1, const DrawRecord& draw) {
+    if (draw.alpha >= 128) {
+        std::fill(row + x0, row + x1 + 1, draw.color);
+        return;
+    }
+
+    int x = x0;
+#if defined(__SSE2__)
+    const __m128i zeroI = _mm_setzero_si128();
+    const __m128i src = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(draw.color)), zeroI);
+    const __m128i alpha = _mm_set1_epi16(static_cast<short>(draw.alpha));
+    for (; x + 3 <= x1; x += 4) {
+        __m128i dst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+        __m128i lo = _mm_unpacklo_epi8(dst, zeroI);
+        __m128i hi = _mm_unpackhi_epi8(dst, zeroI);
+        lo = _mm_add_epi16(lo, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(src, lo), alpha), 7));
+        hi = _mm_add_epi16(hi, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(src, hi), alpha), 7));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; x <= x1; x++) row[x] = blendPixel(row[x], draw.color, draw.alpha);
+}
+
+void SoftwareDevice::rasterizeConvex(const int* tileRect, const float* v, int count, const DrawRecord& draw) {
+    const int MAX_EDGES = 64;
+    if (count > MAX_EDGES) {
+        for (int i = 1; i + 1 < count; i++) rasterizeTriangle(tileRect, v, v + i * 2, v + (i + 1) * 2, draw);
+        return;
+    }
+
+    float area = 0;
+    float minXf = v[0], maxXf = v[0], minYf = v[1], maxYf = v[1];
+    for (int i = 0; i < count; i++) {
+        const float* p = v + i * 2;
+        const float* q = v + ((i + 1) % count) * 2;
+        area += p[0] * q[1] - q[0] * p[1];
+        minXf = std::min(minXf, p[0]); maxXf = std::max(maxXf, p[0]);
+        minYf = std::min(minYf, p[1]); maxYf = std::max(maxYf, p[1]);
+    }
+
+    // Oriented so the inside is on the positive side of every edge
+    Edge edges[MAX_EDGES];
+    int edgeCount = 0;
+    for (int i = 0; i < count; i++) {
+        const float* p = v + i * 2;
+        const float* q = v + ((i + 1) % count) * 2;
+        if (isTinyEdge(p, q)) continue;
+        edges[edgeCount++] = area > 0 ? Edge(p, q) : Edge(q, p);
+    }
+
+    int minY = static_cast<int>(std::floor(std::max<float>(tileRect[1], minYf)));
+    int maxY = static_cast<int>(std::ceil(std::min<float>(tileRect[3] - 1, maxYf)));
+    float tileLeft = static_cast<float>(tileRect[0]);
+    float tileRight = static_cast<float>(tileRect[2]);
+
+    for (int y = minY; y <= maxY; y++) {
+        float py = y + 0.5f;
+        // Intersect the half-planes along this row: lo <= px < hi
+        float lo = std::max(tileLeft, minXf), hi = std::min(tileRight, maxXf + 1.0f);
+        bool empty = false;
+        for (int i = 0; i < edgeCount && !empty; i++) {
+            const Edge& e = edges[i];
+            float r = e.b * (py - e.originY);
+            if (e.a > 0) lo = std::max(lo, e.originX - r / e.a);
+            else if (e.a < 0) hi = std::min(hi, e.originX - r / e.a);
+            else empty = r < 0 || (r == 0 && !e.ownsZero);
+        }
+        if (empty || lo >= hi) continue;
+
+        int x0 = std::max(tileRect[0], static_cast<int>(std::ceil(lo - 0.5f)));
+        int x1 = std::min(tileRect[2] - 1, static_cast<int>(std::ceil(hi - 0.5f)) - 1);
+        if (x0 <= x1) blendSpan(pixels.data() + static_cast<size_t>(y) * stride, x0, x1, draw);
+    }
+}
+
+void SoftwareDevice::readPixels(uint8_t* rgba) const {
+    for (int y = 0; y < height; y++) {
+        std::memcpy(rgba + static_cast<size_t>(y) * width * 4, getRow(y), width * 4);
+    }
+}
+
+uint64_t SoftwareDevice::getImageHash() const {
+    uint64_t hash = 14695981039346656037ull;
+    for (int y = 0; y < height; y++) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(getRow(y));
+        for (int i = 0; i < width * 4; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+bool SoftwareDevice::writePpm(const char* path) const {
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    std::fprintf(f, "P6\n%d %d\n255\n", width, height);
+
+    std::vector<unsigned char> line(width * 3);
+    for (int y = 0; y < height; y++) {
+        const uint32_t* row = getRow(y);
+        for (int x = 0; x < width; x++) {
+            line[x * 3] = row[x] & 0xFF;
+            line[x * 3 + 1] = (row[x] >> 8) & 0xFF;
+            line[x * 3 + 2] = (row[x] >> 16) & 0xFF;
+        }
+        std::fwrite(line.data(), 1, line.size(), f);
+    }
+    return std::fclose(f) == 0;
+}
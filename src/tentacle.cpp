@@ -1,12 +1,54 @@
 #include "../include/tentacle.hpp"
 
+namespace {
+    // ANIMATION: the wiggle is periodic in (animTime * 3 + phase), so its
+    // rotation (cos, sin) is baked once per segment over one period and
+    // looked up with linear interpolation instead of calling sin/cos per frame.
+    const int WIGGLE_TABLE_SIZE = 256;  // Must be a power of two
+    const int TABLE_SEGMENTS = TENTACLE_SEGMENTS;
+
+    struct WiggleSample {
+        float c, s;
+    };
+
+    struct WiggleTable {
+        WiggleSample samples[TABLE_SEGMENTS][WIGGLE_TABLE_SIZE + 1];
+
+        WiggleTable() {
+            for (int seg = 0; seg < TABLE_SEGMENTS; seg++) {
+                float t = (float)seg / TABLE_SEGMENTS;
+                for (int i = 0; i <= WIGGLE_TABLE_SIZE; i++) {
+                    float cycle = 2.0f * PI * i / WIGGLE_TABLE_SIZE;
+                    float wiggle = std::sin(cycle + t * PI) * 0.3f;
+                    samples[seg][i].c = std::cos(wiggle);
+                    samples[seg][i].s = std::sin(wiggle);
+                }
+            }
+        }
+    };
+
+    const WiggleTable wiggleTable;  // Baked at startup
+}
+
 Tentacle::Tentacle(float angle, float len)
-    : baseAngle(angle), length(len), segments(4), phase(0) {}
+    : baseAngle(angle), length(len), segments(TENTACLE_SEGMENTS),
+      baseCos(std::cos(angle)), baseSin(std::sin(angle)), phase(0) {}
 
 Vec2 Tentacle::getSegmentPosition(int segment, float animTime) const {
-    float t = (float)segment / segments;
-    float angle = baseAngle + std::sin(animTime * 3.0f + phase + t * PI) * 0.3f;
-    float segLength = length / segments;
-    return Vec2(std::cos(angle) * segLength * (segment + 1),
-                std::sin(angle) * segLength * (segment + 1));
+    float cycle = (animTime * 3.0f + phase) * (WIGGLE_TABLE_SIZE / (2.0f * PI));
+    float base = std::floor(cycle);
+    float frac = cycle - base;
+    int index = static_cast<int>(base) & (WIGGLE_TABLE_SIZE - 1);
+
+    const WiggleSample& a = wiggleTable.samples[segment][index];
+    const WiggleSample& b = wiggleTable.samples[segment][index + 1];
+    float wc = a.c + (b.c - a.c) * frac;
+    float ws = a.s + (b.s - a.s) * frac;
+
+    // Rotate the base direction by the wiggle angle
+    float dirX = baseCos * wc - baseSin * ws;
+    float dirY = baseSin * wc + baseCos * ws;
+
+    float segLength = length / segments * (segment + 1);
+    return Vec2(dirX * segLength, dirY * segLength);
 }
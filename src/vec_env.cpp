@@ -0,0 +1,167 @@
+#include "../include/vec_env.hpp"
+#include "../include/frame_arena.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const float TICK_SECONDS = 1.0f / 60.0f;
+    const float SHIP_MAX_SPEED = SPACECRAFT_SPEED * 60.0f;
+
+    float clampUnit(float value) {
+        return std::max(-1.0f, std::min(value, 1.0f));
+    }
+
+    uint64_t nextSeed(Rng& rng) {
+        uint64_t high = rng.next();
+        return (high << 32) | rng.next();
+    }
+}
+
+VecEnv::VecEnv(int envCount, int threadCount, const EnvConfig& config)
+    : envs(std::max(1, envCount)), config(config), rasterizer(config.imageWidth, config.imageHeight),
+      jobActions(nullptr), jobObservations(nullptr), jobRewards(nullptr), jobDones(nullptr),
+      jobImages(nullptr), jobType(JOB_STEP),
+      jobGeneration(0), pendingWorkers(0), stopping(false), nextChunk(0) {
+    this->config.frameSkip = std::max(1, config.frameSkip);
+    for (Env& env : envs) {
+        env.game.logEvents = false;
+        env.game.spawnEffects = config.spawnEffects;
+        env.episodeTicks = 0;
+    }
+
+    if (threadCount <= 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    int chunkCount = (getEnvCount() + ENV_ENVS_PER_CHUNK - 1) / ENV_ENVS_PER_CHUNK;
+    threadCount = std::min(threadCount, chunkCount);
+    for (int i = 1; i < threadCount; i++) {
+        workers.emplace_back(&VecEnv::workerLoop, this);
+    }
+}
+
+VecEnv::~VecEnv() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+void VecEnv::workerLoop() {
+    uint64_t seenGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = jobGeneration;
+        }
+        runChunks();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pendingWorkers == 0) done.notify_one();
+        }
+    }
+}
+
+void VecEnv::runChunks() {
+    int envCount = getEnvCount();
+    int chunkCount = (envCount + ENV_ENVS_PER_CHUNK - 1) / ENV_ENVS_PER_CHUNK;
+    for (int chunk = nextChunk.fetch_add(1); chunk < chunkCount; chunk = nextChunk.fetch_add(1)) {
+        int end = std::min(envCount, (chunk + 1) * ENV_ENVS_PER_CHUNK);
+        for (int i = chunk * ENV_ENVS_PER_CHUNK; i < end; i++) {
+            if (jobType == JOB_RESET) {
+                startEpisode(envs[i]);
+                encoder.encode(envs[i].game, jobObservations + static_cast<size_t>(i) * ENV_OBSERVATION_SIZE);
+            } else if (jobType == JOB_STEP) {
+                stepEnv(i);
+            } else {
+                rasterizer.rasterize(envs[i].game, jobImages + i * getImageBytes());
+            }
+        }
+    }
+}
+
+void VecEnv::runJob() {
+    nextChunk.store(0);
+    if (!workers.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pendingWorkers = static_cast<int>(workers.size());
+            jobGeneration++;
+        }
+        wake.notify_all();
+    }
+    runChunks();
+    if (!workers.empty()) {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return pendingWorkers == 0; });
+    }
+}
+
+void VecEnv::reset(uint64_t seed, float* observations) {
+    for (int i = 0; i < getEnvCount(); i++) {
+        envs[i].episodeSeeds.seed(seed, static_cast<uint64_t>(i));
+    }
+    jobObservations = observations;
+    jobType = JOB_RESET;
+    runJob();
+}
+
+void VecEnv::step(const float* actions, float* observations, float* rewards, uint8_t* dones) {
+    jobActions = actions;
+    jobObservations = observations;
+    jobRewards = rewards;
+    jobDones = dones;
+    jobType = JOB_STEP;
+    runJob();
+}
+
+void VecEnv::render(uint8_t* images) {
+    jobImages = images;
+    jobType = JOB_RENDER;
+    runJob();
+}
+
+void VecEnv::startEpisode(Env& env) {
+    env.game.reset();
+    env.game.rng.seed(nextSeed(env.episodeSeeds));
+    env.game.startWave();
+    env.episodeTicks = 0;
+    getFrameArena().reset();
+}
+
+void VecEnv::stepEnv(int index) {
+    Env& env = envs[index];
+    GameManager& game = env.game;
+    const float* action = jobActions + static_cast<size_t>(index) * ENV_ACTION_SIZE;
+    int scoreBefore = game.score;
+
+    Spacecraft& ship = game.spacecraft;
+    if (action[ENV_ACTION_RELOAD] > 0.5f && ship.ammo < ship.maxAmmo) ship.reload(game.score);
+    ship.velocity = Vec2(clampUnit(action[ENV_ACTION_MOVE_X]), clampUnit(action[ENV_ACTION_MOVE_Y])) * SHIP_MAX_SPEED;
+    Vec2 aim(action[ENV_ACTION_AIM_X], action[ENV_ACTION_AIM_Y]);
+    if (aim.x == 0 && aim.y == 0) aim = Vec2(std::cos(ship.rotation), std::sin(ship.rotation));
+    bool fire = action[ENV_ACTION_FIRE] > 0.5f;
+
+    for (int tick = 0; tick < config.frameSkip && game.gameState == GameState::PLAYING; tick++) {
+        // Aim is relative to the ship, so the target moves with it
+        game.update(TICK_SECONDS, ship.position + aim, fire);
+        if (!game.waveActive && game.gameState == GameState::PLAYING) game.startWave();
+        getFrameArena().reset();
+        env.episodeTicks++;
+    }
+
+    float reward = (game.score - scoreBefore) * ENV_SCORE_REWARD_SCALE;
+    uint8_t doneFlag = 0;
+    if (game.gameState != GameState::PLAYING) {
+        reward += ENV_GAME_OVER_REWARD;
+        doneFlag = ENV_DONE_TERMINATED;
+    } else if (env.episodeTicks >= config.maxEpisodeTicks) {
+        doneFlag = ENV_DONE_TRUNCATED;
+    }
+    if (doneFlag) startEpisode(env);
+
+    jobRewards[index] = reward;
+    jobDones[index] = doneFlag;
+    encoder.encode(game, jobObservations + static_cast<size_t>(index) * ENV_OBSERVATION_SIZE);
+}
@@ -0,0 +1,56 @@
+#include "../include/xenostrike_env.h"
+#include "../include/vec_env.hpp"
+
+struct XsVecEnv {
+    VecEnv env;
+
+    XsVecEnv(int envCount, int threadCount, const EnvConfig& config) : env(envCount, threadCount, config) {}
+};
+
+extern "C" {
+
+XsVecEnv* xs_env_create(int env_count, int thread_count, int frame_skip, int max_episode_ticks) {
+    EnvConfig config;
+    if (frame_skip > 0) config.frameSkip = frame_skip;
+    if (max_episode_ticks > 0) config.maxEpisodeTicks = max_episode_ticks;
+    try {
+        return new XsVecEnv(env_count, thread_count, config);
+    } catch (...) {
+        // Exceptions must not cross the C boundary
+        return nullptr;
+    }
+}
+
+void xs_env_destroy(XsVecEnv* env) {
+    delete env;
+}
+
+int xs_env_count(const XsVecEnv* env) {
+    return env->env.getEnvCount();
+}
+
+int xs_env_observation_size(void) {
+    return ENV_OBSERVATION_SIZE;
+}
+
+int xs_env_action_size(void) {
+    return ENV_ACTION_SIZE;
+}
+
+void xs_env_reset(XsVecEnv* env, uint64_t seed, float* observations) {
+    env->env.reset(seed, observations);
+}
+
+void xs_env_step(XsVecEnv* env, const float* actions, float* observations, float* rewards, uint8_t* dones) {
+    env->env.step(actions, observations, rewards, dones);
+}
+
+int xs_env_image_size(const XsVecEnv* env) {
+    return static_cast<int>(env->env.getImageBytes());
+}
+
+void xs_env_render(XsVecEnv* env, uint8_t* images) {
+    env->env.render(images);
+}
+
+}